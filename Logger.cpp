@@ -25,20 +25,28 @@ using namespace std::chrono;
 
 namespace cpplogger {
 
+	//! Instances to the writer threads (defined before the worker, which stops them on destruction)
+	std::vector<std::thread *> mWriterThreads;
 	//! Instance to LoggerWorker class
 	LoggerWorker worker;
-	//! Instance to application log write thread
-	std::thread *mAplThread = 0;
-	//! Instance to debug log write thread
-	std::thread *mDbgThread = 0;
-	//! Instance to event log write thread
-	std::thread *mEvntThread = 0;
-	//! Sets the application log write thread interruption status
-	volatile bool isInterruptedApl = false;
-	//! Sets the debug log write thread interruption status
-	volatile bool isInterruptedDbg = false;
-	//! Sets the event log write thread interruption status
-	volatile bool isInterruptedEvnt = false;
+	//! Instance to TSC calibration thread
+	std::thread *mTscThread = 0;
+	//! Instance to rotated file compression thread
+	std::thread *mCompressThread = 0;
+	//! Sets the writer threads interruption status
+	volatile bool isInterruptedWriters = false;
+
+	/**
+	 * Sets the logger exception type & message, converting the message to UTF-8.
+	 *
+	 * @param	type	The logger exception type.
+	 * @param	msg		The logger exception message in C-wstring format.
+	 */
+	LoggerException::LoggerException(LoggerExceptionType type, const wstring& msg)
+	{
+		this->type = type;
+		this->message = LoggerUtil::ToUtf8(msg);
+	}
 
 	/**
 	 * Checks whether the file exist, returning true if it exists; false otherwise.
@@ -53,6 +61,32 @@ namespace cpplogger {
 		return (access(fileName.c_str(), F_OK) != -1);
 	}
 
+	/**
+	 * Per thread cache of the formatted 'yyyy-MM-dd HH:mm:ss' part of the current second, so that localtime_r()
+	 * (which takes the time zone lock) and the date formatting run once per second per thread.
+	 */
+	struct TimestampCache
+	{
+		//! The cached second since epoch (-1 if nothing is cached)
+		long long second;
+		//! The time stamp format of the cached prefix
+		TimestampFormat format;
+		//! The formatted 'yyyy-MM-dd HH:mm:ss.' prefix
+		char prefix[MAX_LEN_DATE_BUFFER];
+		//! The length of the prefix
+		size_t len;
+	};
+
+	//! Writes a value as a zero padded decimal number of the given width
+	static char *WriteDigits(char *dst, unsigned long long value, int width)
+	{
+		for (int i = width - 1; i >= 0; i--) {
+			dst[i] = (char) ('0' + value % 10);
+			value /= 10;
+		}
+		return dst + width;
+	}
+
 	/**
 	 * Write time stamp in 'yyyy-MM-dd HH:mm:ss.SSS' format to string.<br>
 	 * The content is stored as a C string in the buffer pointed by formatBuff.
@@ -62,447 +96,4284 @@ namespace cpplogger {
 	 */
 	void LoggerUtil::GetTimeString(wchar_t *buff)
 	{
-		
-		system_clock::time_point now = system_clock::now();
-		long long ms_since_epoch = duration_cast<milliseconds>(now.time_since_epoch()).count();
-		time_t sec_since_epoch = time_t(ms_since_epoch / 1000);
-		tm time_info;
-		localtime_r(&sec_since_epoch, &time_info);
-
-		// Format time in yyyy-MM-dd HH:mm:ss.SSS format
-		swprintf(buff, MAX_LEN_DATE_BUFFER, L"%04d-%02d-%02d %02d:%02d:%02d.%03lld",
-			1900 + time_info.tm_year, 1 + time_info.tm_mon,
-			time_info.tm_mday, time_info.tm_hour, time_info.tm_min,
-			time_info.tm_sec, ms_since_epoch % 1000);
+		char time[MAX_LEN_DATE_BUFFER];
+		size_t len = GetTimeString(time, GetTimestamp(), TIMESTAMP_LOCAL);
+		for (size_t i = 0; i <= len; i++)
+			buff[i] = (wchar_t) time[i];
 	}
 
 	/**
-	 * Checks whether proper permissions (exist/read/write) are set, returning 0 if it set; false otherwise.
+	 * Write given time stamp to string, in 'yyyy-MM-dd HH:mm:ss.SSS' format (local time or UTC) or as
+	 * nanoseconds since epoch.<br>
+	 * The date and time part is formatted once per second per thread, later calls within the same second
+	 * only patch the milliseconds.
 	 *
-	 * @param	dirPath		Pointer to the file/directory name that requires validation
+	 * @param	buff		Pointer to a buffer where the resulting C-string is stored.
+	 *						The buffer should be large enough (MAX_LEN_DATE_BUFFER) to contain the resulting string.
+	 * @param	timestamp	The time stamp in nanoseconds since epoch.
+	 * @param	format		The time stamp format.
 	 *
-	 * @return 	0 is returned in the case that proper permissions are set.
-	 *			Otherwise, error number is returned.
+	 * @return	The length of the resulting string.
 	 */
-	int LoggerUtil::HasPermissions(const char* dirPath)
+	size_t LoggerUtil::GetTimeString(char *buff, long long timestamp, TimestampFormat format)
 	{
-		// Check file existence
-		if (access (dirPath, F_OK) != 0) {
-			if (errno == ENOENT) {
-				Logger::SysLogError(L"LoggerUtil::HasPermissions() the path(%s) does not exist", dirPath);
-			} else if (errno == EACCES) {
-				Logger::SysLogError(L"LoggerUtil::HasPermissions() the path(%s) is not accessible", dirPath);
-			}
-
-			return errno;
+		if (format == TIMESTAMP_EPOCH_NS) {
+			char digits[24];
+			char *pos = digits + sizeof(digits);
+			unsigned long long value = timestamp < 0 ? 0 : (unsigned long long) timestamp;
+			do {
+				*--pos = (char) ('0' + value % 10);
+				value /= 10;
+			} while (value != 0);
+			size_t len = digits + sizeof(digits) - pos;
+			memcpy(buff, pos, len);
+			buff[len] = '\0';
+			return len;
 		}
 
-		// Check read access
-		if (access (dirPath, R_OK) != 0) {
-			Logger::SysLogError(
-				L"LoggerUtil::HasPermissions() the path(%s) is not readable (access denied)", dirPath);
-			return errno;
-		}
+		static thread_local TimestampCache cache = { -1, TIMESTAMP_LOCAL, { 0 }, 0 };
+		long long ms_since_epoch = timestamp / 1000000;
+		long long sec_since_epoch = ms_since_epoch / 1000;
 
-		// Check write access
-		if (access (dirPath, W_OK) != 0) {
-			if (errno == EACCES) {
-				Logger::SysLogError(
-					L"LoggerUtil::HasPermissions() the path(%s) is not write-able (access denied)", dirPath);
-				return errno;
-			} else if (errno == EROFS) {
-				Logger::SysLogError(
-					L"LoggerUtil::HasPermissions() the path(%s) is not write-able (read-only file-system)", dirPath);
-				return errno;
-			}
-			return errno;
+		if (sec_since_epoch != cache.second || format != cache.format) {
+			time_t sec = time_t(sec_since_epoch);
+			tm time_info;
+			if (format == TIMESTAMP_UTC)
+				gmtime_r(&sec, &time_info);
+			else
+				localtime_r(&sec, &time_info);
+
+			// Format time in yyyy-MM-dd HH:mm:ss. format
+			char *pos = cache.prefix;
+			pos = WriteDigits(pos, 1900 + time_info.tm_year, 4);
+			*pos++ = '-';
+			pos = WriteDigits(pos, 1 + time_info.tm_mon, 2);
+			*pos++ = '-';
+			pos = WriteDigits(pos, time_info.tm_mday, 2);
+			*pos++ = ' ';
+			pos = WriteDigits(pos, time_info.tm_hour, 2);
+			*pos++ = ':';
+			pos = WriteDigits(pos, time_info.tm_min, 2);
+			*pos++ = ':';
+			pos = WriteDigits(pos, time_info.tm_sec, 2);
+			*pos++ = '.';
+			cache.len = pos - cache.prefix;
+			cache.second = sec_since_epoch;
+			cache.format = format;
 		}
 
-		// Success, return zero(0)
-		return 0;
+		// Patch the milliseconds (and the 'Z' of UTC time stamps)
+		memcpy(buff, cache.prefix, cache.len);
+		char *pos = WriteDigits(buff + cache.len, ms_since_epoch % 1000, 3);
+		if (format == TIMESTAMP_UTC)
+			*pos++ = 'Z';
+		*pos = '\0';
+		return pos - buff;
 	}
 
 	/**
-	 * Set sleep to the process for given number of milliseconds.
+	 * Retrieves the current time stamp in nanoseconds since epoch.
 	 *
-	 * @param	mSec	the number of milliseconds to sleep
+	 * @param	coarse	true to read CLOCK_REALTIME_COARSE (faster, resolution of a scheduler tick) instead of
+	 *					CLOCK_REALTIME.
+	 *
+	 * @return	The current time stamp in nanoseconds since epoch.
 	 */
-	void LoggerUtil::Sleep(unsigned int mSec)
+	long long LoggerUtil::GetTimestamp(bool coarse)
 	{
-		struct timespec timeReq = { 0 };
-		unsigned long val = ((unsigned long) mSec) * 1000000L;
-		timeReq.tv_sec = val / 1000000000L; //9 zero
-		timeReq.tv_nsec = val % 1000000000L; //9 zero
-		nanosleep(&timeReq, (struct timespec *)NULL);
+		timespec ts;
+#ifdef CLOCK_REALTIME_COARSE
+		if (clock_gettime(coarse ? CLOCK_REALTIME_COARSE : CLOCK_REALTIME, &ts) != 0)
+#else
+		(void) coarse;
+		if (clock_gettime(CLOCK_REALTIME, &ts) != 0)
+#endif
+			return duration_cast<nanoseconds>(system_clock::now().time_since_epoch()).count();
+		return (long long) ts.tv_sec * 1000000000LL + ts.tv_nsec;
 	}
 
+	//! TSC conversion sequence number (odd while Calibrate() updates the conversion)
+	static std::atomic<unsigned int> tscSequence(0);
+	//! TSC value of the last calibration
+	static std::atomic<unsigned long long> tscBase(0);
+	//! Wall clock time (nanoseconds since epoch) of the last calibration
+	static std::atomic<long long> tscBaseNs(0);
+	//! Nanoseconds per TSC tick
+	static std::atomic<double> tscNsPerTick(0.0);
+	//! TSC calibration anchor (first sample), the tick rate is measured from here
+	static unsigned long long tscAnchor = 0;
+	//! Wall clock time of the TSC calibration anchor
+	static long long tscAnchorNs = 0;
+	//! Serializes Calibrate() calls
+	static std::mutex mtxTscAnchor;
+
 	/**
-	 * Composes a wstring with the same text that would be printed.<br>
-	 * After the format parameter, the function expects at least as many additional arguments as needed for format.
+	 * Checks whether the CPU has an invariant time stamp counter (CPUID 0x80000007, EDX bit 8), which ticks at
+	 * a constant rate in every power state and is synchronized across cores.
 	 *
-	 * @param	format	C string that contains a format string that follows the same specifications as format in
-	 *					printf (see printf for details)
-	 * @param	...		(additional arguments) Depending on the format string, the function may expect a sequence
-	 *					of additional arguments, each containing a value to be used to replace a format specifier
-	 *					in the format string (or a pointer to a storage location, for n). There should be at least
-	 *					as many of these arguments as the number of values specified in the format specifiers.
-	 *					Additional arguments are ignored by the function.
+	 * @return	true is returned if the time stamp counter is invariant. Otherwise, false is returned.
+	 */
+	bool TscClock::IsInvariant()
+	{
+#if defined(__x86_64__) || defined(__i386__)
+		unsigned int eax, ebx, ecx, edx;
+		if (__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) == 0 || eax < 0x80000007)
+			return false;
+		if (__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) == 0)
+			return false;
+		return (edx & (1u << 8)) != 0;
+#else
+		return false;
+#endif
+	}
+
+	/**
+	 * Reads the time stamp counter and the wall clock at the same instant (the midpoint of two clock reads).
 	 *
-	 * @return	formatted data in wstring format
+	 * @param	tsc		The time stamp counter value.
+	 * @param	ns		The wall clock time in nanoseconds since epoch.
 	 */
-	std::wstring LoggerUtil::StrFormat(const wchar_t* format, ...)
+	static void SampleTsc(unsigned long long& tsc, long long& ns)
 	{
-		va_list vl;
-		va_start(vl, format);
-		wchar_t	formatBuffer[MAX_LEN_FMT_BUFFER];
-		memset(formatBuffer, 0, sizeof(formatBuffer));
-		int ret = vswprintf(formatBuffer, MAX_LEN_FMT_BUFFER, format, vl);
-		va_end(vl);
+		long long before = LoggerUtil::GetTimestamp();
+		tsc = TscClock::Read();
+		long long after = LoggerUtil::GetTimestamp();
+		ns = before + (after - before) / 2;
+	}
 
-		wstring retString;
-		if (ret != -1) {
-			retString = wstring(formatBuffer);
+	/**
+	 * Samples the time stamp counter against the wall clock and publishes a new conversion. The tick rate is
+	 * measured from the first sample, so it gets more accurate with every calibration; the anchor is reset if
+	 * the wall clock has been stepped.
+	 */
+	void TscClock::Calibrate()
+	{
+		std::lock_guard<std::mutex> lock(mtxTscAnchor);
+		unsigned long long tsc;
+		long long ns;
+		if (tscAnchor == 0) {
+			SampleTsc(tscAnchor, tscAnchorNs);
+			LoggerUtil::Sleep(10);
 		}
+		SampleTsc(tsc, ns);
 
-		return retString;
+		double nsPerTick = (double) (ns - tscAnchorNs) / (double) (tsc - tscAnchor);
+		double previous = tscNsPerTick.load(std::memory_order_relaxed);
+		if (nsPerTick <= 0.0 || (previous > 0.0 && (nsPerTick > previous * 1.01 || nsPerTick < previous * 0.99))) {
+			// Wall clock stepped, restart the measurement from this sample keeping the previous rate
+			tscAnchor = tsc;
+			tscAnchorNs = ns;
+			nsPerTick = previous;
+		}
+
+		unsigned int seq = tscSequence.load(std::memory_order_relaxed);
+		tscSequence.store(seq + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		tscBase.store(tsc, std::memory_order_relaxed);
+		tscBaseNs.store(ns, std::memory_order_relaxed);
+		tscNsPerTick.store(nsPerTick, std::memory_order_relaxed);
+		tscSequence.store(seq + 2, std::memory_order_release);
 	}
 
-	//! Constructor
-	LoggerWorker::LoggerWorker()
+	/**
+	 * Converts a time stamp counter value to wall clock time with the last calibration.
+	 *
+	 * @param	tsc		The time stamp counter value.
+	 *
+	 * @return	The time in nanoseconds since epoch.
+	 */
+	long long TscClock::ToNanoseconds(unsigned long long tsc)
 	{
-		severityLevel = ERROR;
+		unsigned long long base;
+		long long baseNs;
+		double nsPerTick;
+		unsigned int seq;
+		do {
+			seq = tscSequence.load(std::memory_order_acquire);
+			base = tscBase.load(std::memory_order_relaxed);
+			baseNs = tscBaseNs.load(std::memory_order_relaxed);
+			nsPerTick = tscNsPerTick.load(std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_acquire);
+		} while ((seq & 1) != 0 || seq != tscSequence.load(std::memory_order_relaxed));
 
-		// Disable all logging operations
-		hasAplLog = false;
-		hasDbgLog = false;
-		hasEvntLog = false;
-		hasConsoleLogging = false;
-		isInterruptedApl = false;
-		isInterruptedDbg = false;
-		isInterruptedEvnt = false;
+		return baseNs + (long long) ((double) (long long) (tsc - base) * nsPerTick);
 	}
 
 	/**
-	 * Initialize logger threads and sets the log file names.
+	 * Encodes a code point to UTF-8. Invalid code points (surrogates, out of range) are encoded as U+FFFD.
 	 *
-	 * @param	aplLogPath	Pointer to the application log file name
-	 * @param	dbgLogPath	Pointer to the debug log file name
-	 * @param	evntLogPath	Pointer to the event log file name
+	 * @param	codePoint	The code point.
+	 * @param	dst			Pointer to a buffer of at least 4 bytes where the UTF-8 bytes are stored.
 	 *
-	 * @throw	The logger exception with exception details.
+	 * @return	The number of bytes stored.
 	 */
-	void LoggerWorker::Init(std::string&aplLogPath, std::string& dbgLogPath, std::string& evntLogPath)
+	size_t LoggerUtil::EncodeUtf8(uint32_t codePoint, char *dst)
 	{
-		try {
-			this->aplLogFilePath = aplLogPath;
-			this->dbgLogFilePath = dbgLogPath;
-			this->evntLogFilePath = evntLogPath;
-
-			// Application log write thread creation
-			mAplThread = new std::thread(&LoggerWorker::WriteToAplFile, this);
-			mAplThread->detach();
-			isInterruptedApl = false;
-
-			// Debug log write thread creation
-			mDbgThread = new std::thread(&LoggerWorker::WriteToDbgFile, this);
-			mDbgThread->detach();
-			isInterruptedDbg = false;
-
-			// Event log write thread creation
-			mEvntThread = new std::thread(&LoggerWorker::WriteToEvntFile, this);
-			mEvntThread->detach();
-			isInterruptedEvnt = false;
-		} catch (const std::exception& e) {
-			// Write to syslog and throw
-			Logger::SysLogError(L"Failed to create logger threads(%s)", e.what());
-			throw LoggerException(
-				LOGGER_EXCEPTION_INIT,
-				LoggerUtil::StrFormat(L"LoggerWorker::Init(): failed to create logger threads(%s)", e.what()));
-		} catch (...) {
-			// Write to syslog and throw
-			Logger::SysLogError(L"Failed to create logger threads(unknown exception)");
-			throw LoggerException(
-				LOGGER_EXCEPTION_INIT, L"LoggerWorker::Init(): failed to create logger threads(unknown exception)");
+		if (codePoint < 0x80) {
+			dst[0] = (char) codePoint;
+			return 1;
+		}
+		if (codePoint < 0x800) {
+			dst[0] = (char) (0xC0 | (codePoint >> 6));
+			dst[1] = (char) (0x80 | (codePoint & 0x3F));
+			return 2;
+		}
+		if ((codePoint >= 0xD800 && codePoint <= 0xDFFF) || codePoint > 0x10FFFF)
+			codePoint = 0xFFFD;
+		if (codePoint < 0x10000) {
+			dst[0] = (char) (0xE0 | (codePoint >> 12));
+			dst[1] = (char) (0x80 | ((codePoint >> 6) & 0x3F));
+			dst[2] = (char) (0x80 | (codePoint & 0x3F));
+			return 3;
 		}
+		dst[0] = (char) (0xF0 | (codePoint >> 18));
+		dst[1] = (char) (0x80 | ((codePoint >> 12) & 0x3F));
+		dst[2] = (char) (0x80 | ((codePoint >> 6) & 0x3F));
+		dst[3] = (char) (0x80 | (codePoint & 0x3F));
+		return 4;
 	}
 
 	/**
-	 * Receives the log record to write, and pushes the record to the application log queue.
+	 * Converts a wide string to UTF-8 and appends it to dst.
 	 *
-	 * @param	level		The log severity level
-	 * @param 	logRecord 	Pointer to the log record which is to be add to the queue.
+	 * @param	src		Pointer to the wide characters.
+	 * @param	len		The number of wide characters.
+	 * @param	dst		The string where the UTF-8 bytes are appended.
 	 */
-	void LoggerWorker::OutputAplLine(SeverityLevel level, const wchar_t *logRecord)
-	{
-		wstring ws(logRecord);
-		std::lock_guard<std::mutex> lock(mtxStdOut);
-		aplLogQueue.push(ws);
-
-		if (hasConsoleLogging) {
-			// Printing coloured characters to terminal for error, critical and warning log levels. Note that not
-			// all terminals support this; if colour sequences are not supported, garbage will show up.
-			// 
-			// Example:
-			// cout << "\033[1;31mBOLD RED TEXT\033[0m\n"; 
-			// Here, \033 is the ESC character, ASCII 27. It is followed by [, then zero or more numbers separated
-			// by;, and finally the letter m.The numbers describe the colour and format to switch to from that 
-			// point onwards. 
-			//
-			// The codes for foreground colours used are:
-			//          foreground background
-			// red      31         41
-			// yellow   33         43
-			// white    37         47
-			//
-			// Additionally, used numbers are:
-			// reset             0  (everything back to normal) - at the end
-			// bold/bright       1  (often a brighter shade of the same colour) - to make the text bold
-			// inverse           7  (swap foreground and background colours)
-			switch (level) {
-				case CRITICAL:
-				wcout << L"\033[1;7;31;47m" << ws << "\033[0m" << std::endl;
-				break;
-				case ERROR:
-				wcout << L"\033[1;31m" << ws << "\033[0m" << std::endl;
-				break;
-				case WARNING:
-				wcout << L"\033[1;33m" << ws << "\033[0m" << std::endl;
-				break;
-				default:
-				wcout << ws << endl;
-				break;
+	void LoggerUtil::ToUtf8(const wchar_t *src, size_t len, std::string& dst)
+	{
+		char bytes[4];
+		for (size_t i = 0; i < len; i++) {
+			uint32_t codePoint = (uint32_t) src[i];
+			if (codePoint < 0x80) {
+				dst.push_back((char) codePoint);
+				continue;
 			}
+			// Combine UTF-16 surrogate pairs (platforms with 2 byte wchar_t)
+			if (sizeof(wchar_t) == 2 && codePoint >= 0xD800 && codePoint <= 0xDBFF && i + 1 < len &&
+				(uint32_t) src[i + 1] >= 0xDC00 && (uint32_t) src[i + 1] <= 0xDFFF) {
+				codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + ((uint32_t) src[++i] - 0xDC00);
+			}
+			dst.append(bytes, EncodeUtf8(codePoint, bytes));
 		}
 	}
 
 	/**
-	 * Receives the log record to write, and pushes the record to the debug log queue.
+	 * Converts a wide string to UTF-8.
 	 *
-	 * @param 	logRecord 	Pointer to the log record which is to be add to the queue.
+	 * @param	src		The wide string.
+	 *
+	 * @return	The UTF-8 string.
 	 */
-	void LoggerWorker::OutputDbgLine(const wchar_t *logRecord)
+	std::string LoggerUtil::ToUtf8(const std::wstring& src)
 	{
-		wstring ws(logRecord);
-		std::lock_guard<std::mutex> lock(mtxStdOut);
-		dbgLogQueue.push(ws);
-
-		if (hasConsoleLogging) {
-			wcout << ws << endl;
-		}
+		std::string dst;
+		ToUtf8(src.data(), src.size(), dst);
+		return dst;
 	}
 
 	/**
-	 * Receives the log record to write, and pushes the record to the event log queue.
+	 * Appends the log line ('time [SEVERITY]: code, message') to dst.
 	 *
-	 * @param 	logRecord 	Pointer to the log record which is to be add to the queue.
+	 * @param	dst		The string where the log line is appended.
+	 * @param	level	The log severity level
+	 * @param	code	The 5 digit custom defined code to each record.
+	 * @param	time	The time stamp in 'yyyy-MM-dd HH:mm:ss.SSS' format.
+	 * @param	msg		The formatted (UTF-8) log message.
+	 * @param	msgLen	The length of the log message.
+	 *
+	 * @return	false is returned for unknown severity levels. Otherwise, true is returned.
 	 */
-	void LoggerWorker::OutputEvntLine(const wchar_t *logRecord)
+	bool LoggerUtil::FormatLine(std::string& dst, SeverityLevel level, unsigned long code, const char *time,
+		const char *msg, size_t msgLen)
 	{
-		wstring ws(logRecord);
-		std::lock_guard<std::mutex> lock(mtxStdOut);
-		evntLogQueue.push(ws);
+		const char *tag;
+		switch (level) {
+			case CRITICAL:
+			tag = " [CRIT]: C9";
+			break;
+			case ERROR:
+			tag = " [ERR ]: E8";
+			break;
+			case INFO:
+			tag = " [INFO]: I0";
+			break;
+			case WARNING:
+			tag = " [WARN]: W7";
+			break;
+			case DEBUG:
+			tag = " [DEBUG]: ";
+			break;
+			case EVENT:
+			tag = " [EVENT]: ";
+			break;
+			default:
+			return false;
+		}
 
-		if (hasConsoleLogging) {
-			// Printing coloured characters to terminal for error, critical and warning log levels. Note that not
-			// all terminals support this; if colour sequences are not supported, garbage will show up.
-			// 
-			// Example:
-			// cout << "\033[1;31mBOLD RED TEXT\033[0m\n"; 
-			// Here, \033 is the ESC character, ASCII 27. It is followed by [, then zero or more numbers separated
-			// by;, and finally the letter m.The numbers describe the colour and format to switch to from that
-			// point onwards. 
-			//
-			// The codes for foreground colours used are:
-			//          foreground background
-			// green    32         42
-			//
-			// Additionally, used numbers are:
-			// reset             0  (everything back to normal) - at the end
-			// bold/bright       1  (often a brighter shade of the same colour) - to make the text bold
-			wcout << L"\033[1;32m" << ws << "\033[0m" << std::endl;
+		dst.append(time);
+		dst.append(tag);
+		if (level != DEBUG && level != EVENT) {
+			// Code in %05lu format
+			char digits[24];
+			char *pos = digits + sizeof(digits);
+			int width = 0;
+			do {
+				*--pos = (char) ('0' + code % 10);
+				code /= 10;
+				width++;
+			} while (code != 0 || width < 5);
+			dst.append(pos, digits + sizeof(digits) - pos);
+			dst.append(", ", 2);
 		}
+		dst.append(msg, msgLen);
+		return true;
 	}
 
+	//! Length modifiers of a printf conversion specification
+	enum FormatLength
+	{
+		FORMAT_LENGTH_NONE, FORMAT_LENGTH_HH, FORMAT_LENGTH_H, FORMAT_LENGTH_L, FORMAT_LENGTH_LL,
+		FORMAT_LENGTH_LONG_DOUBLE, FORMAT_LENGTH_J, FORMAT_LENGTH_Z, FORMAT_LENGTH_T
+	};
+
+	//! A parsed printf conversion specification ('%' [flags] [width] [.precision] [length] conversion)
+	template <typename CharT>
+	struct FormatSpec
+	{
+		//! Flag characters
+		CharT flags[8];
+		//! Width ('*' when taken from the arguments), empty if not set
+		CharT width[16];
+		//! Precision ('*' when taken from the arguments), empty if not set
+		CharT precision[16];
+		//! Length modifier
+		FormatLength length;
+		//! Conversion character
+		CharT conversion;
+	};
+
 	/**
-	 * Pop log record from application log queue and writes to application log file.
+	 * Parses the printf conversion specification starting after the '%' pointed by format.
 	 *
-	 * @throw	The logger exception with exception details.
+	 * @param	format	Pointer to the first character after '%'.
+	 * @param	spec	The parsed conversion specification.
+	 *
+	 * @return	Pointer to the character following the conversion specification.
 	 */
-	void LoggerWorker::WriteToAplFile()
+	template <typename CharT>
+	static const CharT *ParseFormatSpec(const CharT *format, FormatSpec<CharT>& spec)
 	{
-		while (!isInterruptedApl) {
-			try {
-				wstring tmp;
-				if (!aplLogQueue.pop(tmp)) {
-					// Wait for 100 ms to get data filled in queue
-					LoggerUtil::Sleep(SLEEP_IN_MS);
-					continue;
-				}
+		size_t n = 0;
+		while ((*format == '-' || *format == '+' || *format == ' ' || *format == '#' || *format == '0' ||
+			*format == '\'' || *format == 'I') && n < 7)
+			spec.flags[n++] = *format++;
+		spec.flags[n] = 0;
 
-				if (!aplLogFileStream.is_open())
-					aplLogFileStream.open(
-						aplLogFilePath, std::ofstream::out | std::ofstream::app | std::ostream::binary);
+		n = 0;
+		if (*format == '*') {
+			spec.width[n++] = *format++;
+		} else {
+			while (*format >= '0' && *format <= '9' && n < 15)
+				spec.width[n++] = *format++;
+		}
+		spec.width[n] = 0;
 
-				// Write errors to syslog when stream error occurred
-				if (aplLogFileStream.bad() || aplLogFileStream.fail()) {
-					Logger::SysLogInfo(tmp.c_str());
-					aplLogFileStream.close();
-				} else {
-					{
-						std::lock_guard<std::mutex> lock(mtxAplLog);
-						aplLogFileStream << std::string(tmp.begin(), tmp.end()) << endl;
-					}
-					aplLogFileStream.flush();
-				}
-			} catch (std::exception& ex) {
-				Logger::SysLogError(
-					L"LoggerWorker::WriteToAplFile() failed to write to application log file(%s)", ex.what());
-				throw LoggerException(
-					LOGGER_EXCEPTION_STREAM,
-					LoggerUtil::StrFormat(
-						L"LoggerWorker::WriteToAplFile() failed to write to application log file(%s)", ex.what()));
-			} catch (...) {
-				Logger::SysLogError(
-					L"LoggerWorker::WriteToAplFile() failed to write to application log file(unknown exception)");
-				throw LoggerException(
-					LOGGER_EXCEPTION_STREAM,
-					L"LoggerWorker::WriteToAplFile() failed to write to application log file(unknown exception)");
+		n = 0;
+		if (*format == '.') {
+			spec.precision[n++] = *format++;
+			if (*format == '*') {
+				spec.precision[n++] = *format++;
+			} else {
+				while (*format >= '0' && *format <= '9' && n < 15)
+					spec.precision[n++] = *format++;
+			}
+		}
+		spec.precision[n] = 0;
+
+		spec.length = FORMAT_LENGTH_NONE;
+		switch (*format) {
+			case 'h':
+			format++;
+			spec.length = FORMAT_LENGTH_H;
+			if (*format == 'h') {
+				format++;
+				spec.length = FORMAT_LENGTH_HH;
 			}
+			break;
+			case 'l':
+			format++;
+			spec.length = FORMAT_LENGTH_L;
+			if (*format == 'l') {
+				format++;
+				spec.length = FORMAT_LENGTH_LL;
+			}
+			break;
+			case 'q':
+			format++;
+			spec.length = FORMAT_LENGTH_LL;
+			break;
+			case 'L':
+			format++;
+			spec.length = FORMAT_LENGTH_LONG_DOUBLE;
+			break;
+			case 'j':
+			format++;
+			spec.length = FORMAT_LENGTH_J;
+			break;
+			case 'z':
+			case 'Z':
+			format++;
+			spec.length = FORMAT_LENGTH_Z;
+			break;
+			case 't':
+			format++;
+			spec.length = FORMAT_LENGTH_T;
+			break;
+			default:
+			break;
 		}
+
+		spec.conversion = *format;
+		return *format ? format + 1 : format;
 	}
 
-	/**
-	 * Pop log record from debug log queue and writes to debug log file.
-	 *
-	 * @throw	The logger exception with exception details.
-	 */
-	void LoggerWorker::WriteToDbgFile()
+	//! Appends the binary representation of a value to dst
+	template <typename T>
+	static void AppendArg(std::string& dst, const T& value)
 	{
-		while (!isInterruptedDbg) {
-			try {
-				wstring tmp;
-				if (!dbgLogQueue.pop(tmp)) {
-					// Wait for 100 ms to get data filled in queue
-					LoggerUtil::Sleep(SLEEP_IN_MS);
-					continue;
-				}
+		dst.append(reinterpret_cast<const char *>(&value), sizeof(value));
+	}
+
+	//! Reads the binary representation of a value from src, returning false if src is exhausted
+	template <typename T>
+	static bool ReadArg(const char *&src, const char *end, T& value)
+	{
+		if ((size_t) (end - src) < sizeof(value))
+			return false;
+		memcpy(&value, src, sizeof(value));
+		src += sizeof(value);
+		return true;
+	}
 
-				if (!dbgLogFileStream.is_open())
-					dbgLogFileStream.open(
-						dbgLogFilePath, std::ofstream::out | std::ofstream::app | std::ostream::binary);
+	//! Encodes the arguments referenced by a (narrow or wide) printf format string, see LoggerUtil::EncodeArgs()
+	template <typename CharT>
+	static void EncodeFormatArgs(const CharT *format, va_list args, std::string& dst)
+	{
+		va_list vl;
+		va_copy(vl, args);
+		dst.clear();
 
-				// Write errors to syslog when stream error occurred
-				if (dbgLogFileStream.bad() || dbgLogFileStream.fail()) {
-					Logger::SysLogInfo(tmp.c_str());
-					dbgLogFileStream.close();
-				} else {
-					{
-						std::lock_guard<std::mutex> lock(mtxDbgLog);
-						dbgLogFileStream << std::string(tmp.begin(), tmp.end()) << endl;
+		while (*format) {
+			if (*format++ != '%')
+				continue;
+			if (*format == '%') {
+				format++;
+				continue;
+			}
+
+			FormatSpec<CharT> spec;
+			format = ParseFormatSpec(format, spec);
+			if (spec.width[0] == '*')
+				AppendArg(dst, (long long) va_arg(vl, int));
+			if (spec.precision[0] == '.' && spec.precision[1] == '*')
+				AppendArg(dst, (long long) va_arg(vl, int));
+
+			switch (spec.conversion) {
+				case 'd':
+				case 'i':
+				switch (spec.length) {
+					case FORMAT_LENGTH_HH:
+					AppendArg(dst, (long long) (signed char) va_arg(vl, int));
+					break;
+					case FORMAT_LENGTH_H:
+					AppendArg(dst, (long long) (short) va_arg(vl, int));
+					break;
+					case FORMAT_LENGTH_L:
+					AppendArg(dst, (long long) va_arg(vl, long));
+					break;
+					case FORMAT_LENGTH_LL:
+					AppendArg(dst, (long long) va_arg(vl, long long));
+					break;
+					case FORMAT_LENGTH_J:
+					AppendArg(dst, (long long) va_arg(vl, intmax_t));
+					break;
+					case FORMAT_LENGTH_Z:
+					AppendArg(dst, (long long) va_arg(vl, ssize_t));
+					break;
+					case FORMAT_LENGTH_T:
+					AppendArg(dst, (long long) va_arg(vl, ptrdiff_t));
+					break;
+					default:
+					AppendArg(dst, (long long) va_arg(vl, int));
+					break;
+				}
+				break;
+				case 'o':
+				case 'u':
+				case 'x':
+				case 'X':
+				switch (spec.length) {
+					case FORMAT_LENGTH_HH:
+					AppendArg(dst, (unsigned long long) (unsigned char) va_arg(vl, unsigned int));
+					break;
+					case FORMAT_LENGTH_H:
+					AppendArg(dst, (unsigned long long) (unsigned short) va_arg(vl, unsigned int));
+					break;
+					case FORMAT_LENGTH_L:
+					AppendArg(dst, (unsigned long long) va_arg(vl, unsigned long));
+					break;
+					case FORMAT_LENGTH_LL:
+					AppendArg(dst, (unsigned long long) va_arg(vl, unsigned long long));
+					break;
+					case FORMAT_LENGTH_J:
+					AppendArg(dst, (unsigned long long) va_arg(vl, uintmax_t));
+					break;
+					case FORMAT_LENGTH_Z:
+					AppendArg(dst, (unsigned long long) va_arg(vl, size_t));
+					break;
+					case FORMAT_LENGTH_T:
+					AppendArg(dst, (unsigned long long) va_arg(vl, ptrdiff_t));
+					break;
+					default:
+					AppendArg(dst, (unsigned long long) va_arg(vl, unsigned int));
+					break;
+				}
+				break;
+				case 'c':
+				case 'C':
+				AppendArg(dst, (long long) va_arg(vl, int));
+				break;
+				case 'e':
+				case 'E':
+				case 'f':
+				case 'F':
+				case 'g':
+				case 'G':
+				case 'a':
+				case 'A':
+				if (spec.length == FORMAT_LENGTH_LONG_DOUBLE)
+					AppendArg(dst, va_arg(vl, long double));
+				else
+					AppendArg(dst, va_arg(vl, double));
+				break;
+				case 's':
+				case 'S':
+				if (spec.conversion == 'S' || spec.length == FORMAT_LENGTH_L) {
+					const wchar_t *str = va_arg(vl, const wchar_t *);
+					uint32_t strLen = str ? (uint32_t) wcslen(str) : UINT32_MAX;
+					if (str && spec.precision[0] == '.' && spec.precision[1] != '*') {
+						uint32_t precision = 0;
+						for (const CharT *digit = spec.precision + 1; *digit; digit++)
+							precision = precision * 10 + (uint32_t) (*digit - '0');
+						strLen = std::min(strLen, precision);
 					}
-					dbgLogFileStream.flush();
+					AppendArg(dst, strLen);
+					if (str)
+						dst.append(reinterpret_cast<const char *>(str), strLen * sizeof(wchar_t));
+				} else {
+					const char *str = va_arg(vl, const char *);
+					uint32_t strLen = str ? (uint32_t) strlen(str) : UINT32_MAX;
+					AppendArg(dst, strLen);
+					if (str)
+						dst.append(str, strLen);
 				}
-			} catch (std::exception& ex) {
-				Logger::SysLogError(
-					L"LoggerWorker::WriteToDbgFile() failed to write to debug log file(%s)", ex.what());
-				throw LoggerException(
-					LOGGER_EXCEPTION_STREAM,
-					LoggerUtil::StrFormat(
-						L"LoggerWorker::WriteToDbgFile() failed to write to debug log file(%s)", ex.what()));
-			} catch (...) {
-				Logger::SysLogError(
-					L"LoggerWorker::WriteToDbgFile() failed to write to debug log file (unknown exception)");
-				throw LoggerException(
-					LOGGER_EXCEPTION_STREAM,
-					L"LoggerWorker::WriteToDbgFile() failed to write to debug log file(unknown exception)");
+				break;
+				case 'p':
+				AppendArg(dst, (unsigned long long) (uintptr_t) va_arg(vl, void *));
+				break;
+				case 'n':
+				(void) va_arg(vl, void *);
+				break;
+				case 'm':
+				AppendArg(dst, (long long) errno);
+				break;
+				default:
+				break;
 			}
 		}
+		va_end(vl);
 	}
 
 	/**
-	 * Pop log record from event log queue and writes to event log file.
+	 * Encodes the arguments referenced by a printf format string to binary, so that the format string can be
+	 * formatted later by FormatArgs(). Integers are stored as 64 bit values, floating point values as double or
+	 * long double and strings (%s, %ls, %S) as a 32 bit length followed by the characters. %n is not supported
+	 * and its argument is skipped.
 	 *
-	 * @throw	The logger exception with exception details.
+	 * @param	format	C string that contains a format string that follows the same specifications as format in
+	 *					printf (see printf for details)
+	 * @param	args	The variable argument list (va_list)
+	 * @param	dst		The string where the encoded arguments are stored (cleared first).
 	 */
-	void LoggerWorker::WriteToEvntFile()
+	void LoggerUtil::EncodeArgs(const wchar_t *format, va_list args, std::string& dst)
 	{
-		while (!isInterruptedEvnt) {
-			try {
-				wstring tmp;
-				if (!evntLogQueue.pop(tmp)) {
-					// Wait for 100 ms to get data filled in queue
-					LoggerUtil::Sleep(SLEEP_IN_MS);
-					continue;
-				}
-
-				if (!evntLogFileStream.is_open())
-					evntLogFileStream.open(
-						evntLogFilePath, std::ofstream::out | std::ofstream::app | std::ostream::binary);
-
-				// Write errors to syslog when stream error occurred
-				if (evntLogFileStream.bad() || evntLogFileStream.fail()) {
-					Logger::SysLogInfo(tmp.c_str());
-					evntLogFileStream.close();
-				} else {
-					{
-						std::lock_guard<std::mutex> lock(mtxEvntlog);
-						evntLogFileStream << std::string(tmp.begin(), tmp.end()) << endl;
-					}
-					evntLogFileStream.flush();
-				}
-			} catch (std::exception& ex) {
-				Logger::SysLogError(
-					L"LoggerWorker::WriteToEvntFile() failed to write to event log file(%s)", ex.what());
-				throw LoggerException(
-					LOGGER_EXCEPTION_STREAM,
-					LoggerUtil::StrFormat(
-						L"LoggerWorker::WriteToEvntFile() failed to write to event log file(%s)", ex.what()));
-			} catch (...) {
-				Logger::SysLogError(
-					L"LoggerWorker::WriteToEvntFile() failed to write to event log file (unknown exception)");
-				throw LoggerException(
-					LOGGER_EXCEPTION_STREAM,
-					L"LoggerWorker::WriteToEvntFile() failed to write to event log file(unknown exception)");
-			}
-		}
+		EncodeFormatArgs(format, args, dst);
 	}
 
 	/**
-	 * Release and close all loggers
+	 * Encodes the arguments referenced by a printf format string (UTF-8 version).
 	 *
-	 * @throw	The logger exception with exception details.
+	 * @param	format	C string that contains a format string that follows the same specifications as format in
+	 *					printf (see printf for details)
+	 * @param	args	The variable argument list (va_list)
+	 * @param	dst		The string where the encoded arguments are stored (cleared first).
 	 */
-	void LoggerWorker::DropAll()
+	void LoggerUtil::EncodeArgs(const char *format, va_list args, std::string& dst)
 	{
-		// Sleep server for 200 ms before exit
-		LoggerUtil::Sleep(2 * SLEEP_IN_MS);
+		EncodeFormatArgs(format, args, dst);
+	}
 
-		isInterruptedApl = true;
-		isInterruptedDbg = true;
-		isInterruptedEvnt = true;
+	//! Prints a single conversion to a wide buffer, returning len if the output was truncated and -1 on an error
+	template <typename T>
+	static int PrintSpec(wchar_t *dst, size_t len, const wchar_t *spec, T value)
+	{
+		// swprintf() returns -1 for both: a truncated output fills the buffer without terminating it
+		dst[len - 1] = L'\0';
+		int ret = swprintf(dst, len, spec, value);
+		if (ret < 0 && wcsnlen(dst, len) == len - 1)
+			return (int) len;
+		return ret;
+	}
 
-		try {
-			if (aplLogFileStream.is_open())
-				aplLogFileStream.close();
-		} catch (...) {
-			throw LoggerException(
-				LOGGER_EXCEPTION_EXIT, L"LoggerWorker::DropAll() failed to close application log file stream");
-		}
+	//! Prints a single conversion to a narrow buffer, returning len or more if the output was truncated
+	template <typename T>
+	static int PrintSpec(char *dst, size_t len, const char *spec, T value)
+	{
+		return snprintf(dst, len, spec, value);
+	}
 
+	//! Appends (ASCII) characters to a conversion specification buffer
+	template <typename CharT, typename SrcT>
+	static void AppendSpec(CharT *spec, size_t& n, const SrcT *src)
+	{
+		while (*src && n < 63)
+			spec[n++] = (CharT) *src++;
+		spec[n] = 0;
+	}
+
+	//! Composes the formatted data of a (narrow or wide) format string, see LoggerUtil::FormatArgs()
+	template <typename CharT>
+	static int FormatEncodedArgs(CharT *dst, size_t len, const CharT *format, const char *args, size_t argsLen)
+	{
+		const char *src = args;
+		const char *end = args + argsLen;
+		size_t pos = 0;
+		if (len == 0)
+			return -1;
+
+		while (*format && pos + 1 < len) {
+			if (*format != '%') {
+				dst[pos++] = *format++;
+				continue;
+			}
+			const CharT *literal = format++;
+			if (*format == '%') {
+				dst[pos++] = *format++;
+				continue;
+			}
+
+			FormatSpec<CharT> spec;
+			format = ParseFormatSpec(format, spec);
+
+			// Rebuild the specification with '*' width/precision resolved and a 64 bit length modifier
+			long long value = 0;
+			CharT specBuffer[64];
+			size_t n = 0;
+			char number[24];
+			AppendSpec(specBuffer, n, "%");
+			AppendSpec(specBuffer, n, spec.flags);
+			if (spec.width[0] == '*') {
+				if (!ReadArg(src, end, value))
+					return -1;
+				snprintf(number, sizeof(number), "%lld", value);
+				AppendSpec(specBuffer, n, number);
+			} else {
+				AppendSpec(specBuffer, n, spec.width);
+			}
+			if (spec.precision[0] == '.' && spec.precision[1] == '*') {
+				if (!ReadArg(src, end, value))
+					return -1;
+				snprintf(number, sizeof(number), ".%lld", value);
+				AppendSpec(specBuffer, n, number);
+			} else {
+				AppendSpec(specBuffer, n, spec.precision);
+			}
+
+			CharT *out = dst + pos;
+			size_t outLen = len - pos;
+			char conversion[4] = { (char) spec.conversion, '\0', '\0', '\0' };
+			int ret = 0;
+			switch (spec.conversion) {
+				case 'd':
+				case 'i':
+				case 'o':
+				case 'u':
+				case 'x':
+				case 'X':
+				if (!ReadArg(src, end, value))
+					return -1;
+				AppendSpec(specBuffer, n, "ll");
+				AppendSpec(specBuffer, n, conversion);
+				ret = PrintSpec(out, outLen, specBuffer, value);
+				break;
+				case 'c':
+				case 'C':
+				if (!ReadArg(src, end, value))
+					return -1;
+				if (spec.conversion == 'C' || spec.length == FORMAT_LENGTH_L) {
+					AppendSpec(specBuffer, n, "lc");
+					ret = PrintSpec(out, outLen, specBuffer, (wint_t) value);
+				} else {
+					AppendSpec(specBuffer, n, "c");
+					ret = PrintSpec(out, outLen, specBuffer, (int) value);
+				}
+				break;
+				case 'e':
+				case 'E':
+				case 'f':
+				case 'F':
+				case 'g':
+				case 'G':
+				case 'a':
+				case 'A':
+				if (spec.length == FORMAT_LENGTH_LONG_DOUBLE) {
+					long double dbl;
+					if (!ReadArg(src, end, dbl))
+						return -1;
+					AppendSpec(specBuffer, n, "L");
+					AppendSpec(specBuffer, n, conversion);
+					ret = PrintSpec(out, outLen, specBuffer, dbl);
+				} else {
+					double dbl;
+					if (!ReadArg(src, end, dbl))
+						return -1;
+					AppendSpec(specBuffer, n, conversion);
+					ret = PrintSpec(out, outLen, specBuffer, dbl);
+				}
+				break;
+				case 's':
+				case 'S':
+				{
+					uint32_t strLen;
+					if (!ReadArg(src, end, strLen))
+						return -1;
+					if (strLen == UINT32_MAX) {
+						AppendSpec(specBuffer, n, "s");
+						ret = PrintSpec(out, outLen, specBuffer, "(null)");
+					} else if (spec.conversion == 'S' || spec.length == FORMAT_LENGTH_L) {
+						if ((size_t) (end - src) < strLen * sizeof(wchar_t))
+							return -1;
+						std::wstring str(strLen, L'\0');
+						memcpy(&str[0], src, strLen * sizeof(wchar_t));
+						src += strLen * sizeof(wchar_t);
+						AppendSpec(specBuffer, n, "ls");
+						ret = PrintSpec(out, outLen, specBuffer, str.c_str());
+					} else {
+						if ((size_t) (end - src) < strLen)
+							return -1;
+						std::string str(src, strLen);
+						src += strLen;
+						AppendSpec(specBuffer, n, "s");
+						ret = PrintSpec(out, outLen, specBuffer, str.c_str());
+					}
+				}
+				break;
+				case 'p':
+				if (!ReadArg(src, end, value))
+					return -1;
+				AppendSpec(specBuffer, n, "p");
+				ret = PrintSpec(out, outLen, specBuffer, (void *) (uintptr_t) value);
+				break;
+				case 'm':
+				if (!ReadArg(src, end, value))
+					return -1;
+				AppendSpec(specBuffer, n, "s");
+				ret = PrintSpec(out, outLen, specBuffer, strerror((int) value));
+				break;
+				default:
+				// Unknown conversion, copied as is (like printf)
+				while (literal < format && pos + 1 < len)
+					dst[pos++] = *literal++;
+				continue;
+			}
+
+			if (ret < 0) {
+				// Encoding error, the output stops before the conversion
+				break;
+			}
+			if ((size_t) ret >= outLen) {
+				// Output truncated, the buffer is full
+				pos = len - 1;
+				break;
+			}
+			pos += ret;
+		}
+
+		dst[pos] = 0;
+		return (int) pos;
+	}
+
+	/**
+	 * Composes the formatted data of a format string from its arguments encoded by EncodeArgs().<br>
+	 * The output is truncated to fit the buffer.
+	 *
+	 * @param	dst		Pointer to a buffer where the resulting C-wchar_t is stored.
+	 * @param	len		The size of the buffer pointed by dst.
+	 * @param	format	The format string passed to EncodeArgs().
+	 * @param	args	Pointer to the encoded arguments.
+	 * @param	argsLen	The size of the encoded arguments.
+	 *
+	 * @return	The number of characters written, or -1 if the arguments do not match the format string.
+	 */
+	int LoggerUtil::FormatArgs(wchar_t *dst, size_t len, const wchar_t *format, const char *args, size_t argsLen)
+	{
+		return FormatEncodedArgs(dst, len, format, args, argsLen);
+	}
+
+	/**
+	 * Composes the formatted data of a format string from its arguments encoded by EncodeArgs() (UTF-8 version).
+	 *
+	 * @param	dst		Pointer to a buffer where the resulting C-string is stored.
+	 * @param	len		The size of the buffer pointed by dst.
+	 * @param	format	The format string passed to EncodeArgs().
+	 * @param	args	Pointer to the encoded arguments.
+	 * @param	argsLen	The size of the encoded arguments.
+	 *
+	 * @return	The number of characters written, or -1 if the arguments do not match the format string.
+	 */
+	int LoggerUtil::FormatArgs(char *dst, size_t len, const char *format, const char *args, size_t argsLen)
+	{
+		return FormatEncodedArgs(dst, len, format, args, argsLen);
+	}
+
+	/**
+	 * Appends the (UTF-8) log line of a log record to dst. Deferred records are formatted from their format
+	 * string and encoded arguments.
+	 *
+	 * @param	dst		The string where the log line is appended.
+	 * @param	record	The log record.
+	 *
+	 * @return	false is returned if the record could not be formatted. Otherwise, true is returned.
+	 */
+	bool LoggerUtil::FormatRecord(std::string& dst, const LogRecord& record)
+	{
+		if (record.format == NULL && record.narrowFormat == NULL) {
+			dst.append(record.text);
+			return true;
+		}
+
+		char time[MAX_LEN_DATE_BUFFER];
+		long long timestamp = record.tscTimestamp ? TscClock::ToNanoseconds(record.timestamp) : record.timestamp;
+		GetTimeString(time, timestamp, worker.timestampFormat);
+
+		if (record.narrowFormat != NULL) {
+			char formatBuffer[MAX_LEN_FMT_BUFFER];
+			int ret = FormatArgs(
+				formatBuffer, MAX_LEN_FMT_BUFFER, record.narrowFormat, record.args.data(), record.args.size());
+			if (ret < 0)
+				return false;
+			return FormatLine(dst, record.level, record.code, time, formatBuffer, ret);
+		}
+
+		wchar_t formatBuffer[MAX_LEN_FMT_BUFFER];
+		int ret = FormatArgs(formatBuffer, MAX_LEN_FMT_BUFFER, record.format, record.args.data(), record.args.size());
+		if (ret < 0)
+			return false;
+
+		static thread_local std::string message;
+		message.clear();
+		ToUtf8(formatBuffer, ret, message);
+		return FormatLine(dst, record.level, record.code, time, message.data(), message.size());
+	}
+
+	/**
+	 * Gets the time index path of a log file ('path.idx') or of a rotated file ('path.index.idx').
+	 *
+	 * @param	path	The log file path.
+	 * @param	index	The rotated file index (0 for the log file itself).
+	 *
+	 * @return	The time index path.
+	 */
+	static std::string IndexPath(const std::string& path, unsigned int index = 0)
+	{
+		return index > 0 ? path + "." + std::to_string(index) + ".idx" : path + ".idx";
+	}
+
+	//! Constructor
+	BinaryLogWriter::BinaryLogWriter() : nextId(0), hasHeader(false) { }
+
+	/**
+	 * Starts a new session: the next record is preceded by the session header and the format strings are
+	 * written to the dictionary again.
+	 */
+	void BinaryLogWriter::Reset()
+	{
+		formats.clear();
+		nextId = 0;
+		hasHeader = false;
+	}
+
+	/**
+	 * Appends the binary entries of a log record to dst: the session header and the format string when they are
+	 * not written yet, and the record itself.
+	 *
+	 * @param	dst		The buffer where the entries are appended.
+	 * @param	record	The log record.
+	 */
+	void BinaryLogWriter::Append(std::string& dst, const LogRecord& record)
+	{
+		if (!hasHeader) {
+			dst.append(BINLOG_MAGIC, BINLOG_MAGIC_LEN);
+			AppendArg(dst, (uint8_t) BINLOG_VERSION);
+			AppendArg(dst, (uint8_t) worker.timestampFormat);
+			AppendArg(dst, (uint8_t) sizeof(wchar_t));
+			AppendArg(dst, (uint8_t) 0);
+			hasHeader = true;
+		}
+
+		if (record.format == NULL && record.narrowFormat == NULL) {
+			AppendArg(dst, (uint8_t) BINLOG_ENTRY_TEXT);
+			AppendArg(dst, (uint32_t) record.text.size());
+			dst.append(record.text);
+			return;
+		}
+
+		const void *key = record.narrowFormat != NULL ? (const void *) record.narrowFormat : (const void *) record.format;
+		size_t size = record.narrowFormat != NULL ? strlen(record.narrowFormat) : wcslen(record.format) * sizeof(wchar_t);
+
+		// A format string is identified by its pointer, a different string at the same address gets a new ID
+		std::unordered_map<const void *, FormatEntry>::iterator it = formats.find(key);
+		if (it == formats.end() || it->second.bytes.size() != size || memcmp(it->second.bytes.data(), key, size) != 0) {
+			FormatEntry& entry = formats[key];
+			entry.id = nextId++;
+			entry.bytes.assign((const char *) key, size);
+
+			AppendArg(dst, (uint8_t) BINLOG_ENTRY_FORMAT);
+			AppendArg(dst, entry.id);
+			AppendArg(dst, (uint8_t) (record.narrowFormat == NULL));
+			AppendArg(dst, (uint32_t) size);
+			dst.append(entry.bytes);
+			it = formats.find(key);
+		}
+
+		long long timestamp = record.tscTimestamp ? TscClock::ToNanoseconds(record.timestamp) : record.timestamp;
+		AppendArg(dst, (uint8_t) BINLOG_ENTRY_RECORD);
+		AppendArg(dst, it->second.id);
+		AppendArg(dst, (uint8_t) record.level);
+		AppendArg(dst, (uint32_t) record.code);
+		AppendArg(dst, (int64_t) timestamp);
+		AppendArg(dst, (uint32_t) record.args.size());
+		dst.append(record.args);
+	}
+
+	/**
+	 * Reads the given number of bytes from a stream. The length comes from the file, so it is checked against
+	 * BINLOG_ENTRY_MAX and the buffer grows as the bytes arrive, a corrupt length cannot exhaust the memory.
+	 *
+	 * @return	false is returned if the length is too large or the stream ends first. Otherwise, true is returned.
+	 */
+	static bool ReadBytes(std::istream& in, std::string& dst, size_t len)
+	{
+		dst.clear();
+		if (len > BINLOG_ENTRY_MAX)
+			return false;
+
+		while (dst.size() < len) {
+			size_t offset = dst.size();
+			size_t n = std::min(len - offset, (size_t) BINLOG_READ_CHUNK);
+			dst.resize(offset + n);
+			in.read(&dst[offset], n);
+			if ((size_t) in.gcount() != n)
+				return false;
+		}
+		return true;
+	}
+
+	//! Reads the binary representation of a value from a stream, returning false if the stream ends first
+	template <typename T>
+	static bool ReadValue(std::istream& in, T& value)
+	{
+		in.read(reinterpret_cast<char *>(&value), sizeof(value));
+		return (size_t) in.gcount() == sizeof(value);
+	}
+
+	//! Constructor
+	BinaryLogReader::BinaryLogReader() : timestampFormat(TIMESTAMP_LOCAL), corrupt(false) { }
+
+	/**
+	 * Reads the entries of a binary log up to the next log record and formats its log line, exactly as the write
+	 * thread formats it in the text format (with the time stamp format of the session).
+	 *
+	 * @param	in		The binary log stream.
+	 * @param	line	The log line (without newline).
+	 *
+	 * @return	true is returned if a log line is read. false is returned at the end of the input, or if the input
+	 *			is not a valid binary log (see IsCorrupt()).
+	 */
+	bool BinaryLogReader::ReadLine(std::istream& in, std::string& line)
+	{
+		std::string bytes;
+		line.clear();
+
+		while (!corrupt) {
+			int type = in.get();
+			if (type == std::char_traits<char>::eof())
+				return false;
+
+			uint8_t wide = 0, level = 0;
+			uint32_t id = 0, code = 0, size = 0;
+			int64_t timestamp = 0;
+			switch (type) {
+				case 0:
+				// The rest of the last extent of a memory-mapped file whose writer was killed
+				break;
+				case BINLOG_MAGIC[0]:
+				{
+					uint8_t header[4];
+					corrupt = !ReadBytes(in, bytes, BINLOG_MAGIC_LEN - 1) || bytes != BINLOG_MAGIC + 1 ||
+						!ReadValue(in, header) || header[0] != BINLOG_VERSION || header[2] != sizeof(wchar_t);
+					if (corrupt)
+						break;
+					formats.clear();
+					wideFormats.clear();
+					timestampFormat = (TimestampFormat) header[1];
+				}
+				break;
+				case BINLOG_ENTRY_FORMAT:
+				corrupt = !ReadValue(in, id) || !ReadValue(in, wide) || !ReadValue(in, size) || id != formats.size() ||
+					!ReadBytes(in, bytes, size);
+				if (corrupt)
+					break;
+				formats.push_back(bytes);
+				wideFormats.push_back(wide != 0);
+				break;
+				case BINLOG_ENTRY_RECORD:
+				{
+					corrupt = !ReadValue(in, id) || !ReadValue(in, level) || !ReadValue(in, code) ||
+						!ReadValue(in, timestamp) || !ReadValue(in, size) || id >= formats.size() ||
+						!ReadBytes(in, bytes, size);
+					if (corrupt)
+						break;
+
+					char time[MAX_LEN_DATE_BUFFER];
+					LoggerUtil::GetTimeString(time, timestamp, timestampFormat);
+					if (wideFormats[id]) {
+						std::wstring format(formats[id].size() / sizeof(wchar_t), L'\0');
+						memcpy(&format[0], formats[id].data(), format.size() * sizeof(wchar_t));
+						wchar_t formatBuffer[MAX_LEN_FMT_BUFFER];
+						int ret = LoggerUtil::FormatArgs(
+							formatBuffer, MAX_LEN_FMT_BUFFER, format.c_str(), bytes.data(), bytes.size());
+						corrupt = (ret < 0);
+						if (corrupt)
+							break;
+						std::string message;
+						LoggerUtil::ToUtf8(formatBuffer, ret, message);
+						corrupt = !LoggerUtil::FormatLine(
+							line, (SeverityLevel) level, code, time, message.data(), message.size());
+					} else {
+						char formatBuffer[MAX_LEN_FMT_BUFFER];
+						int ret = LoggerUtil::FormatArgs(
+							formatBuffer, MAX_LEN_FMT_BUFFER, formats[id].c_str(), bytes.data(), bytes.size());
+						corrupt = (ret < 0);
+						if (corrupt)
+							break;
+						corrupt = !LoggerUtil::FormatLine(line, (SeverityLevel) level, code, time, formatBuffer, ret);
+					}
+					if (corrupt)
+						break;
+				}
+				return true;
+				case BINLOG_ENTRY_TEXT:
+				corrupt = !ReadValue(in, size) || !ReadBytes(in, line, size);
+				if (corrupt)
+					break;
+				return true;
+				default:
+				corrupt = true;
+				break;
+			}
+		}
+		return false;
+	}
+
+	/**
+	 * Parses a number of decimal digits.
+	 *
+	 * @param	src		The digits.
+	 * @param	count	The number of digits.
+	 *
+	 * @return	The value, or -1 if a character is not a digit.
+	 */
+	static int ParseDigits(const char *src, int count)
+	{
+		int value = 0;
+		for (int i = 0; i < count; i++) {
+			if (src[i] < '0' || src[i] > '9')
+				return -1;
+			value = value * 10 + (src[i] - '0');
+		}
+		return value;
+	}
+
+	/**
+	 * Parses the time stamp at the start of a log line: 'yyyy-MM-dd HH:mm:ss.SSS' (local time), the same followed
+	 * by 'Z' (UTC) or nanoseconds since epoch. The conversion of the date and time is cached per second.
+	 *
+	 * @param	line	The log line.
+	 * @param	len		The length of the log line.
+	 *
+	 * @return	The time stamp in nanoseconds since epoch, or -1 if the line does not start with a time stamp.
+	 */
+	long long LogReader::ParseTimestamp(const char *line, size_t len)
+	{
+		size_t digits = 0;
+		while (digits < len && line[digits] >= '0' && line[digits] <= '9')
+			digits++;
+
+		if (digits != 4 || len < 23) {
+			// Nanoseconds since epoch
+			if (digits < 10 || digits > 19 || (digits < len && line[digits] != ' '))
+				return -1;
+			return strtoll(line, NULL, 10);
+		}
+
+		if (line[4] != '-' || line[7] != '-' || line[10] != ' ' || line[13] != ':' || line[16] != ':' || line[19] != '.')
+			return -1;
+		int ms = ParseDigits(line + 20, 3);
+		if (ms < 0)
+			return -1;
+
+		static thread_local struct { char prefix[19]; bool utc; long long second; } cache = { { 0 }, false, -1 };
+		bool utc = len > 23 && line[23] == 'Z';
+		if (cache.second < 0 || cache.utc != utc || memcmp(cache.prefix, line, sizeof(cache.prefix)) != 0) {
+			tm time_info;
+			memset(&time_info, 0, sizeof(time_info));
+			time_info.tm_year = ParseDigits(line, 4) - 1900;
+			time_info.tm_mon = ParseDigits(line + 5, 2) - 1;
+			time_info.tm_mday = ParseDigits(line + 8, 2);
+			time_info.tm_hour = ParseDigits(line + 11, 2);
+			time_info.tm_min = ParseDigits(line + 14, 2);
+			time_info.tm_sec = ParseDigits(line + 17, 2);
+			time_info.tm_isdst = -1;
+			if (time_info.tm_mon < 0 || time_info.tm_mday < 0 || time_info.tm_hour < 0 || time_info.tm_min < 0 ||
+				time_info.tm_sec < 0)
+				return -1;
+
+			memcpy(cache.prefix, line, sizeof(cache.prefix));
+			cache.utc = utc;
+			cache.second = (long long) (utc ? timegm(&time_info) : mktime(&time_info));
+		}
+		return (cache.second * 1000 + ms) * 1000000LL;
+	}
+
+	/**
+	 * Finds the file offsets to read the lines of a time range from. Starts one index entry before the last entry
+	 * older than the range and stops one entry after the first entry newer than the range, as the time stamps of
+	 * records logged concurrently may be slightly out of order across batches. Without a (valid) time index, the
+	 * whole file is read.
+	 *
+	 * @param	path	The log file path.
+	 * @param	from	The start of the time range (nanoseconds since epoch).
+	 * @param	to		The end of the time range (nanoseconds since epoch, inclusive).
+	 * @param	begin	The file offset to start reading at.
+	 * @param	end		The file offset to stop reading at (SIZE_MAX for the end of the file).
+	 */
+	void LogReader::FindRange(const std::string& path, long long from, long long to, size_t& begin, size_t& end)
+	{
+		begin = 0;
+		end = SIZE_MAX;
+
+		struct stat st;
+		std::ifstream in(IndexPath(path).c_str(), std::ios::in | std::ios::binary);
+		if (!in || stat(path.c_str(), &st) != 0)
+			return;
+
+		std::vector<LogIndexEntry> entries;
+		LogIndexEntry entry;
+		while (in.read(reinterpret_cast<char *>(&entry), sizeof(entry))) {
+			// The index does not belong to this file
+			if (entry.offset > (uint64_t) st.st_size)
+				return;
+			entries.push_back(entry);
+		}
+
+		// Text time stamps have millisecond resolution
+		long long last = to + 1000000;
+		size_t first = entries.size();
+		for (size_t i = 0; i < entries.size(); i++) {
+			if (entries[i].timestamp < from)
+				first = i;
+		}
+		if (first < entries.size())
+			begin = (size_t) entries[first > 0 ? first - 1 : 0].offset;
+		for (size_t i = 0; i + 1 < entries.size(); i++) {
+			if (entries[i].timestamp > last) {
+				end = std::max(begin, (size_t) entries[i + 1].offset);
+				break;
+			}
+		}
+	}
+
+	/**
+	 * Reads the lines of a (text format) log file with time stamps within a time range. Lines without a time
+	 * stamp belong to the previous line.
+	 *
+	 * @param	path	The log file path.
+	 * @param	from	The start of the time range (nanoseconds since epoch).
+	 * @param	to		The end of the time range (nanoseconds since epoch, inclusive).
+	 * @param	lines	The lines within the time range are appended to lines.
+	 *
+	 * @return	false is returned if the log file cannot be opened. Otherwise, true is returned.
+	 */
+	bool LogReader::ReadRange(const std::string& path, long long from, long long to, std::vector<LogLine>& lines)
+	{
+		std::ifstream in(path.c_str(), std::ios::in | std::ios::binary);
+		if (!in)
+			return false;
+
+		size_t begin, end;
+		FindRange(path, from, to, begin, end);
+		in.seekg(begin);
+
+		std::string line;
+		size_t pos = begin;
+		long long timestamp = -1;
+		while (pos < end && std::getline(in, line)) {
+			// Preallocated (memory-mapped) space past the written data
+			if (!line.empty() && line[0] == '\0')
+				break;
+			pos += line.size() + 1;
+
+			long long lineTimestamp = ParseTimestamp(line.data(), line.size());
+			if (lineTimestamp >= 0)
+				timestamp = lineTimestamp;
+			if (timestamp >= from && timestamp <= to) {
+				LogLine logLine;
+				logLine.timestamp = timestamp;
+				logLine.text.swap(line);
+				lines.push_back(logLine);
+			}
+		}
+		return true;
+	}
+
+	/**
+	 * Copies the literal text of a format string to dst up to the next '{}' placeholder ('{{' and '}}' are
+	 * written as single braces).
+	 *
+	 * @param	dst		The format buffer.
+	 * @param	format	The format string.
+	 *
+	 * @return	Pointer to the character following the placeholder (or to the end of the format string).
+	 */
+	const char *LogFormatter::CopyLiteral(FormatBuffer& dst, const char *format)
+	{
+		const char *begin = format;
+		for (;;) {
+			if (*format == '\0') {
+				dst.append(begin, format - begin);
+				return format;
+			}
+			if (*format == '{' || *format == '}') {
+				dst.append(begin, format - begin);
+				if (format[0] == '{' && format[1] == '}')
+					return format + 2;
+				if (format[1] == format[0])
+					format++;
+				dst.append(*format++);
+				begin = format;
+				continue;
+			}
+			format++;
+		}
+	}
+
+	/**
+	 * Writes an unsigned integer in decimal to dst.
+	 *
+	 * @param	dst			The format buffer.
+	 * @param	value		The absolute value.
+	 * @param	negative	true to write a minus sign.
+	 */
+	void LogFormatter::FormatUnsigned(FormatBuffer& dst, unsigned long long value, bool negative)
+	{
+		char digits[24];
+		char *pos = digits + sizeof(digits);
+		do {
+			*--pos = (char) ('0' + value % 10);
+			value /= 10;
+		} while (value != 0);
+
+		if (negative)
+			*--pos = '-';
+		dst.append(pos, digits + sizeof(digits) - pos);
+	}
+
+	/**
+	 * Writes a floating point value to dst (printf %g format).
+	 *
+	 * @param	dst		The format buffer.
+	 * @param	value	The value.
+	 */
+	void LogFormatter::FormatDouble(FormatBuffer& dst, long double value)
+	{
+		char buff[64];
+		int n = snprintf(buff, sizeof(buff), "%Lg", value);
+		if (n > 0)
+			dst.append(buff, std::min((size_t) n, sizeof(buff) - 1));
+	}
+
+	/**
+	 * Writes a wide string to dst encoded as UTF-8.
+	 *
+	 * @param	dst		The format buffer.
+	 * @param	value	The wide string.
+	 * @param	len		The number of characters.
+	 */
+	void LogFormatter::FormatWide(FormatBuffer& dst, const wchar_t *value, size_t len)
+	{
+		char bytes[4];
+		for (size_t i = 0; i < len; i++)
+			dst.append(bytes, LoggerUtil::EncodeUtf8((uint32_t) value[i], bytes));
+	}
+
+	/**
+	 * Writes a pointer value in hexadecimal to dst.
+	 *
+	 * @param	dst		The format buffer.
+	 * @param	value	The pointer value.
+	 */
+	void LogFormatter::FormatPointer(FormatBuffer& dst, const void *value)
+	{
+		char buff[32];
+		int n = snprintf(buff, sizeof(buff), "%p", value);
+		if (n > 0)
+			dst.append(buff, std::min((size_t) n, sizeof(buff) - 1));
+	}
+
+	/**
+	 * Checks whether proper permissions (exist/read/write) are set, returning 0 if it set; false otherwise.
+	 *
+	 * @param	dirPath		Pointer to the file/directory name that requires validation
+	 *
+	 * @return 	0 is returned in the case that proper permissions are set.
+	 *			Otherwise, error number is returned.
+	 */
+	int LoggerUtil::HasPermissions(const char* dirPath)
+	{
+		// Check file existence
+		if (access (dirPath, F_OK) != 0) {
+			if (errno == ENOENT) {
+				Logger::SysLogError(L"LoggerUtil::HasPermissions() the path(%s) does not exist", dirPath);
+			} else if (errno == EACCES) {
+				Logger::SysLogError(L"LoggerUtil::HasPermissions() the path(%s) is not accessible", dirPath);
+			}
+
+			return errno;
+		}
+
+		// Check read access
+		if (access (dirPath, R_OK) != 0) {
+			Logger::SysLogError(
+				L"LoggerUtil::HasPermissions() the path(%s) is not readable (access denied)", dirPath);
+			return errno;
+		}
+
+		// Check write access
+		if (access (dirPath, W_OK) != 0) {
+			if (errno == EACCES) {
+				Logger::SysLogError(
+					L"LoggerUtil::HasPermissions() the path(%s) is not write-able (access denied)", dirPath);
+				return errno;
+			} else if (errno == EROFS) {
+				Logger::SysLogError(
+					L"LoggerUtil::HasPermissions() the path(%s) is not write-able (read-only file-system)", dirPath);
+				return errno;
+			}
+			return errno;
+		}
+
+		// Success, return zero(0)
+		return 0;
+	}
+
+	/**
+	 * Set sleep to the process for given number of milliseconds.
+	 *
+	 * @param	mSec	the number of milliseconds to sleep
+	 */
+	void LoggerUtil::Sleep(unsigned int mSec)
+	{
+		struct timespec timeReq = { 0 };
+		unsigned long val = ((unsigned long) mSec) * 1000000L;
+		timeReq.tv_sec = val / 1000000000L; //9 zero
+		timeReq.tv_nsec = val % 1000000000L; //9 zero
+		nanosleep(&timeReq, (struct timespec *)NULL);
+	}
+
+	/**
+	 * Composes a wstring with the same text that would be printed.<br>
+	 * After the format parameter, the function expects at least as many additional arguments as needed for format.
+	 *
+	 * @param	format	C string that contains a format string that follows the same specifications as format in
+	 *					printf (see printf for details)
+	 * @param	...		(additional arguments) Depending on the format string, the function may expect a sequence
+	 *					of additional arguments, each containing a value to be used to replace a format specifier
+	 *					in the format string (or a pointer to a storage location, for n). There should be at least
+	 *					as many of these arguments as the number of values specified in the format specifiers.
+	 *					Additional arguments are ignored by the function.
+	 *
+	 * @return	formatted data in wstring format
+	 */
+	std::wstring LoggerUtil::StrFormat(const wchar_t* format, ...)
+	{
+		va_list vl;
+		va_start(vl, format);
+		wchar_t	formatBuffer[MAX_LEN_FMT_BUFFER];
+		memset(formatBuffer, 0, sizeof(formatBuffer));
+		int ret = vswprintf(formatBuffer, MAX_LEN_FMT_BUFFER, format, vl);
+		va_end(vl);
+
+		wstring retString;
+		if (ret != -1) {
+			retString = wstring(formatBuffer);
+		}
+
+		return retString;
+	}
+
+	//! Constructor
+	LoggerWorker::LoggerWorker()
+	{
+		severityLevel = ERROR;
+		hasDeferredFormatting = false;
+		timestampFormat = TIMESTAMP_LOCAL;
+		hasCoarseClock = false;
+		hasTscClock = false;
+		hasMappedFile = false;
+		hasUringFile = false;
+		hasRotatedFiles = false;
+		isInterruptedCompression = false;
+		isInterruptedTscCalibration = false;
+		batchSize = BATCH_SIZE_DEFAULT;
+		batchLatencyMs = BATCH_LATENCY_MS_DEFAULT;
+
+		// Disable all logging operations
+		hasAplLog = false;
+		hasDbgLog = false;
+		hasEvntLog = false;
+		hasConsoleLogging = false;
+		hasWriterThreads = false;
+
+		// The built-in sinks, the console gets its levels from Logger::EnableConsoleLogging() and the syslog
+		// sink the messages of the syslog interfaces only
+		routeCount.store(0, std::memory_order_relaxed);
+		AddRoute(&aplSink, SEVERITY_MASK(INFO) | SEVERITY_MASK(WARNING) | SEVERITY_MASK(ERROR) | SEVERITY_MASK(CRITICAL));
+		AddRoute(&dbgSink, SEVERITY_MASK(DEBUG));
+		AddRoute(&evntSink, SEVERITY_MASK(EVENT));
+		AddRoute(&consoleSink, 0);
+		AddRoute(&sysLogSink, 0);
+	}
+
+	/**
+	 * Initialize logger threads and sets the log file names.
+	 *
+	 * @param	aplLogPath	Pointer to the application log file name
+	 * @param	dbgLogPath	Pointer to the debug log file name
+	 * @param	evntLogPath	Pointer to the event log file name
+	 * @param	options		The logger options
+	 *
+	 * @throw	The logger exception with exception details.
+	 */
+	void LoggerWorker::Init(std::string&aplLogPath, std::string& dbgLogPath, std::string& evntLogPath,
+		const LoggerOptions& options)
+	{
+		try {
+			this->options = options;
+			aplSink.SetPath(aplLogPath);
+			dbgSink.SetPath(dbgLogPath);
+			evntSink.SetPath(evntLogPath);
+
+			// Queue options and capacities, applied while no logging thread is pushing; the queues are empty
+			// unless records were logged before Init()
+			FileSink *sinks[] = { &aplSink, &dbgSink, &evntSink };
+			const QueueOptions *queueOptions[] = { &options.aplQueue, &options.dbgQueue, &options.evntQueue };
+			for (size_t i = 0; i < sizeof(sinks) / sizeof(sinks[0]); i++) {
+				if (!sinks[i]->Quiesce()) {
+					Logger::SysLogWarn("LoggerWorker::Init() log queue is full, keeping its options");
+					continue;
+				}
+				sinks[i]->queueOptions = *queueOptions[i];
+				if (sinks[i]->queue.resize(std::max(queueOptions[i]->capacity, (size_t) 1)))
+					sinks[i]->queue.reserve(queueOptions[i]->recordReserve);
+				else
+					Logger::SysLogWarn("LoggerWorker::Init() log queue is not empty, keeping its capacity");
+				sinks[i]->Resume();
+			}
+
+			// NUMA node queues, the logging threads push to the queue of the node they run on
+			size_t nodes = options.numaQueues ? CreateNodeQueues() : 0;
+			size_t count = routeCount.load(std::memory_order_acquire);
+			for (size_t i = 0; i < count; i++)
+				routes[i].sink.load(std::memory_order_relaxed)->hasNodeQueues.store(nodes > 1, std::memory_order_release);
+
+			// Writer threads creation, servicing every sink
+			StartWriters(options.writerThreads);
+
+			// TSC calibration thread creation (kept over DropAll()/Init() cycles)
+			if (hasTscClock)
+				StartTscCalibration();
+
+			// Rotated file compression thread creation, compresses the files left uncompressed first
+			if (options.compression != COMPRESSION_NONE) {
+#if !defined(CPPLOGGER_HAVE_ZLIB)
+				if (options.compression == COMPRESSION_GZIP)
+					Logger::SysLogWarn("LoggerWorker::Init() gzip compression requires CPPLOGGER_HAVE_ZLIB");
+#endif
+#if !defined(CPPLOGGER_HAVE_ZSTD)
+				if (options.compression == COMPRESSION_ZSTD)
+					Logger::SysLogWarn("LoggerWorker::Init() zstd compression requires CPPLOGGER_HAVE_ZSTD");
+#endif
+				isInterruptedCompression = false;
+				hasRotatedFiles = true;
+				mCompressThread = new std::thread(&LoggerWorker::CompressRotatedFiles, this);
+			}
+		} catch (const std::exception& e) {
+			// Write to syslog and throw
+			Logger::SysLogError(L"Failed to create logger threads(%s)", e.what());
+			throw LoggerException(
+				LOGGER_EXCEPTION_INIT,
+				LoggerUtil::StrFormat(L"LoggerWorker::Init(): failed to create logger threads(%s)", e.what()));
+		} catch (...) {
+			// Write to syslog and throw
+			Logger::SysLogError(L"Failed to create logger threads(unknown exception)");
+			throw LoggerException(
+				LOGGER_EXCEPTION_INIT, L"LoggerWorker::Init(): failed to create logger threads(unknown exception)");
+		}
+	}
+
+	//! Push slot of the calling thread, returned when the thread exits
+	static PushSlot& LocalPushSlot()
+	{
+		struct Holder
+		{
+			PushSlot *slot;
+			~Holder()
+			{
+				if (slot != NULL)
+					PushSlots::Release(slot);
+			}
+		};
+		static thread_local Holder holder = { NULL };
+		if (CPPLOGGER_UNLIKELY(holder.slot == NULL))
+			holder.slot = worker.pushSlots.Acquire();
+		return *holder.slot;
+	}
+
+	/**
+	 * Pushes a log record to the queue of a sink. When the queue is full, the record waits for room or the queue
+	 * drops a record, depending on the overflow policy of the queue, and dropped records are counted per severity
+	 * level.
+	 *
+	 * @param	sink	The sink.
+	 * @param	record	The log record.
+	 */
+	void LoggerWorker::Enqueue(LogSink& sink, const LogRecord& record)
+	{
+		// Marked in the slot of the thread while pushing, so that the queues are not reallocated under the push
+		// (see LogSink::Quiesce()); the slot is on a cache line of its own
+		PushSlot& slot = LocalPushSlot();
+		slot.sink.store(&sink, std::memory_order_seq_cst);
+		while (CPPLOGGER_UNLIKELY(sink.quiescing.load(std::memory_order_seq_cst))) {
+			slot.sink.store(NULL, std::memory_order_release);
+			while (sink.quiescing.load(std::memory_order_acquire))
+				std::this_thread::yield();
+			slot.sink.store(&sink, std::memory_order_seq_cst);
+		}
+
+		PushRecord(sink, record);
+		slot.sink.store(NULL, std::memory_order_release);
+	}
+
+	/**
+	 * Pushes a log record to the queue of a sink (of the NUMA node of the calling thread), applying the overflow
+	 * policy of the queue.
+	 *
+	 * @param	sink	The sink.
+	 * @param	record	The log record.
+	 */
+	void LoggerWorker::PushRecord(LogSink& sink, const LogRecord& record)
+	{
+		LogQueue& queue = sink.LocalQueue();
+		const QueueOptions& queueOptions = sink.queueOptions;
+		DropCounts& dropped = sink.dropped;
+		switch (queueOptions.overflow) {
+			case OVERFLOW_DROP_NEWEST:
+			if (!queue.try_push(record))
+				dropped.Add(record.level);
+			break;
+			case OVERFLOW_DROP_OLDEST:
+			{
+				// Reused per thread, the popped record keeps the buffers of the slot
+				static thread_local LogRecord oldest;
+				while (!queue.try_push(record)) {
+					// The queue is multi-consumer: the write thread or another producer may take the
+					// oldest record first, then the push is retried
+					if (queue.pop(oldest))
+						dropped.Add(oldest.level);
+				}
+			}
+			break;
+			case OVERFLOW_DROP_BELOW:
+			if (record.level >= queueOptions.dropBelow)
+				queue.push(record);
+			else if (!queue.try_push(record))
+				dropped.Add(record.level);
+			break;
+			default:
+			queue.push(record);
+			break;
+		}
+	}
+
+	/**
+	 * Receives the log record to write, and pushes the record to the application log queue.
+	 *
+	 * @param	level		The log severity level
+	 * @param 	logRecord 	Pointer to the log record which is to be add to the queue.
+	 */
+	void LoggerWorker::OutputAplLine(SeverityLevel level, const char *logRecord)
+	{
+		LogRecord record;
+		record.level = level;
+		record.text = logRecord;
+		OutputAplLine(record);
+	}
+
+	/**
+	 * Receives the log record to write, and pushes the record to the sinks its severity level is routed to
+	 * (the application log file by default).
+	 *
+	 * @param 	record 	The log record which is to be add to the queue.
+	 */
+	void LoggerWorker::OutputAplLine(const LogRecord& record)
+	{
+		Route(record);
+	}
+
+	/**
+	 * Receives the log record to write, and pushes the record to the debug log queue.
+	 *
+	 * @param 	logRecord 	Pointer to the log record which is to be add to the queue.
+	 */
+	void LoggerWorker::OutputDbgLine(const char *logRecord)
+	{
+		LogRecord record;
+		record.level = DEBUG;
+		record.text = logRecord;
+		OutputDbgLine(record);
+	}
+
+	/**
+	 * Receives the log record to write, and pushes the record to the sinks its severity level is routed to
+	 * (the debug log file by default).
+	 *
+	 * @param 	record 	The log record which is to be add to the queue.
+	 */
+	void LoggerWorker::OutputDbgLine(const LogRecord& record)
+	{
+		Route(record);
+	}
+
+	/**
+	 * Receives the log record to write, and pushes the record to the event log queue.
+	 *
+	 * @param 	logRecord 	Pointer to the log record which is to be add to the queue.
+	 */
+	void LoggerWorker::OutputEvntLine(const char *logRecord)
+	{
+		LogRecord record;
+		record.level = EVENT;
+		record.text = logRecord;
+		OutputEvntLine(record);
+	}
+
+	/**
+	 * Receives the log record to write, and pushes the record to the sinks its severity level is routed to
+	 * (the event log file by default).
+	 *
+	 * @param 	record 	The log record which is to be add to the queue.
+	 */
+	void LoggerWorker::OutputEvntLine(const LogRecord& record)
+	{
+		Route(record);
+	}
+
+	/**
+	 * Pushes a log record to the queue of every sink its severity level is routed to.
+	 *
+	 * @param 	record 	The log record.
+	 */
+	void LoggerWorker::Route(const LogRecord& record)
+	{
+		unsigned int level = SEVERITY_MASK(record.level);
+		size_t count = routeCount.load(std::memory_order_acquire);
+		for (size_t i = 0; i < count; i++) {
+			if (routes[i].levels.load(std::memory_order_relaxed) & level)
+				Enqueue(*routes[i].sink.load(std::memory_order_relaxed), record);
+		}
+	}
+
+	/**
+	 * Routes severity levels to a sink, which the writer threads service from then on.
+	 *
+	 * @param	sink	The sink.
+	 * @param	levels	The severity levels (SEVERITY_MASK() bits, 0 for the records pushed to the sink directly).
+	 *
+	 * @return	false is returned if SINK_COUNT_MAX sinks are routed already. Otherwise, true is returned.
+	 */
+	bool LoggerWorker::AddRoute(LogSink *sink, unsigned int levels)
+	{
+		std::lock_guard<std::mutex> lock(mtxRoutes);
+		size_t count = routeCount.load(std::memory_order_relaxed);
+		if (count >= SINK_COUNT_MAX)
+			return false;
+
+		sink->queue.set_doorbell(&doorbell);
+		routes[count].sink.store(sink, std::memory_order_relaxed);
+		routes[count].levels.store(levels, std::memory_order_relaxed);
+		routeCount.store(count + 1, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * Changes the severity levels routed to a sink.
+	 *
+	 * @param	sink	The sink.
+	 * @param	levels	The severity levels (SEVERITY_MASK() bits).
+	 */
+	void LoggerWorker::SetRouteLevels(LogSink *sink, unsigned int levels)
+	{
+		size_t count = routeCount.load(std::memory_order_acquire);
+		for (size_t i = 0; i < count; i++) {
+			if (routes[i].sink.load(std::memory_order_relaxed) == sink)
+				routes[i].levels.store(levels, std::memory_order_relaxed);
+		}
+	}
+
+	//! Constructor
+	LogSink::LogSink(const QueueOptions& queueOptions)
+		: queue(std::max(queueOptions.capacity, (size_t) 1), queueOptions.recordReserve), queueOptions(queueOptions)
+	{
+		busy.store(false, std::memory_order_relaxed);
+		nodeQueueCount.store(0, std::memory_order_relaxed);
+		hasNodeQueues.store(false, std::memory_order_relaxed);
+		quiescing.store(false, std::memory_order_relaxed);
+	}
+
+	//! Destructor
+	LogSink::~LogSink()
+	{
+		size_t count = nodeQueueCount.load(std::memory_order_acquire);
+		for (size_t i = 0; i < count; i++) {
+			nodeQueues[i]->~LogQueue();
+			free(nodeQueues[i]);
+		}
+	}
+
+	/**
+	 * Retrieves the queue the calling thread pushes to: the queue of the NUMA node it runs on when the sink has
+	 * node queues, the queue of the sink otherwise.
+	 *
+	 * @return	The queue.
+	 */
+	LogQueue& LogSink::LocalQueue()
+	{
+		if (!hasNodeQueues.load(std::memory_order_acquire))
+			return queue;
+
+		size_t node = worker.numaNodes.NodeOf(sched_getcpu());
+		return node == 0 || node > nodeQueueCount.load(std::memory_order_acquire) ? queue : *nodeQueues[node - 1];
+	}
+
+	/**
+	 * Allocates the queue of a NUMA node with the capacity of the queue options, or resizes it if it is allocated
+	 * and empty. The memory is placed on the node of the calling thread (first touch). The nodes are allocated in
+	 * order, node 0 uses the queue of the sink.
+	 *
+	 * @param	node		The node index (1 to NUMA_NODES_MAX - 1).
+	 * @param	doorbell	The doorbell rung when the queue turns non-empty.
+	 *
+	 * @throw	std::bad_alloc if the queue cannot be allocated.
+	 */
+	void LogSink::AllocateNodeQueue(size_t node, Doorbell *doorbell)
+	{
+		size_t capacity = std::max(queueOptions.capacity, (size_t) 1);
+		if (node <= nodeQueueCount.load(std::memory_order_acquire)) {
+			if (Quiesce()) {
+				if (nodeQueues[node - 1]->resize(capacity))
+					nodeQueues[node - 1]->reserve(queueOptions.recordReserve);
+				Resume();
+			}
+			return;
+		}
+
+		void *mem = NULL;
+		if (posix_memalign(&mem, CACHE_LINE_SIZE, sizeof(LogQueue)) != 0)
+			throw std::bad_alloc();
+		LogQueue *nodeQueue;
+		try {
+			nodeQueue = new (mem) LogQueue(capacity, queueOptions.recordReserve);
+		} catch (...) {
+			free(mem);
+			throw;
+		}
+		nodeQueue->set_doorbell(doorbell);
+		nodeQueues[node - 1] = nodeQueue;
+		nodeQueueCount.store(node, std::memory_order_release);
+	}
+
+	/**
+	 * Pops records from the queue of the sink and the queues of the NUMA nodes, each queue up to an equal share
+	 * of the batch. With node queues the batch (from index 0) is merged by time stamp; the records of a queue
+	 * keep their order when their time stamps are equal.
+	 *
+	 * @param	batch		The batch.
+	 * @param	offset		The index of the batch the popped records are stored from.
+	 * @param	maxCount	The maximum number of records to pop.
+	 *
+	 * @return	The number of records popped.
+	 */
+	size_t LogSink::PopBatch(std::vector<LogRecord>& batch, size_t offset, size_t maxCount)
+	{
+		size_t nodes = nodeQueueCount.load(std::memory_order_acquire);
+		if (nodes == 0)
+			return queue.pop_batch(batch, offset, maxCount);
+
+		// A share per queue, so that a busy node does not hold back the records of the others
+		size_t share = std::max((maxCount + nodes) / (nodes + 1), (size_t) 1);
+		size_t count = queue.pop_batch(batch, offset, std::min(share, maxCount));
+		size_t queues = count > 0 || offset > 0 ? 1 : 0;
+		for (size_t i = 0; i < nodes && count < maxCount; i++) {
+			size_t popped = nodeQueues[i]->pop_batch(batch, offset + count, std::min(share, maxCount - count));
+			if (popped > 0) {
+				count += popped;
+				queues++;
+			}
+		}
+
+		// The records of a single queue are in order already
+		if (queues > 1)
+			MergeBatch(batch, offset + count);
+		return count;
+	}
+
+	/**
+	 * Sorts a batch by time stamp, keeping the order of the records with equal time stamps. The time stamps are
+	 * converted to nanoseconds once per record, then the records are swapped to their sorted index.
+	 *
+	 * @param	batch	The batch.
+	 * @param	count	The number of records in the batch.
+	 */
+	void LogSink::MergeBatch(std::vector<LogRecord>& batch, size_t count)
+	{
+		mergeKeys.resize(count);
+		for (size_t i = 0; i < count; i++) {
+			const LogRecord& record = batch[i];
+			mergeKeys[i].first = record.tscTimestamp ? TscClock::ToNanoseconds(record.timestamp) : record.timestamp;
+			mergeKeys[i].second = i;
+		}
+
+		// The index breaks the ties, so the sort is stable
+		std::sort(mergeKeys.begin(), mergeKeys.end());
+
+		// Record mergeKeys[i].second goes to index i, each cycle of the permutation is followed once
+		for (size_t i = 0; i < count; i++) {
+			size_t j = i;
+			while (mergeKeys[j].second != i) {
+				size_t k = mergeKeys[j].second;
+				std::swap(batch[j], batch[k]);
+				mergeKeys[j].second = j;
+				j = k;
+			}
+			mergeKeys[j].second = j;
+		}
+	}
+
+	/**
+	 * Retrieves the number of records in the queue of the sink and the queues of the NUMA nodes.
+	 *
+	 * @return	The number of records.
+	 */
+	size_t LogSink::Size()
+	{
+		size_t size = queue.size();
+		size_t nodes = nodeQueueCount.load(std::memory_order_acquire);
+		for (size_t i = 0; i < nodes; i++)
+			size += nodeQueues[i]->size();
+		return size;
+	}
+
+	//! Release the writer thread waiting on the queues
+	void LogSink::Wake()
+	{
+		queue.wake();
+		size_t nodes = nodeQueueCount.load(std::memory_order_acquire);
+		for (size_t i = 0; i < nodes; i++)
+			nodeQueues[i]->wake();
+	}
+
+	/**
+	 * Holds the logging threads back from the queues and waits until none of them is pushing, so that the queues
+	 * (and the queue options) can be changed; call Resume() afterwards. Gives up when a queue whose overflow
+	 * policy waits for room is full while a logging thread is pushing, as only the writer threads make room.
+	 *
+	 * @return	true is returned if no logging thread is pushing. Otherwise, false is returned (not held back).
+	 */
+	bool LogSink::Quiesce()
+	{
+		bool waits = queueOptions.overflow == OVERFLOW_BLOCK || queueOptions.overflow == OVERFLOW_DROP_BELOW;
+		quiescing.store(true, std::memory_order_seq_cst);
+		while (worker.pushSlots.IsPushing(this)) {
+			bool full = waits && queue.size() >= queue.capacity();
+			size_t nodes = nodeQueueCount.load(std::memory_order_acquire);
+			for (size_t i = 0; i < nodes && waits && !full; i++)
+				full = nodeQueues[i]->size() >= nodeQueues[i]->capacity();
+			if (full) {
+				Resume();
+				return false;
+			}
+			std::this_thread::yield();
+		}
+		return true;
+	}
+
+	//! Let the logging threads held back by Quiesce() push again
+	void LogSink::Resume()
+	{
+		quiescing.store(false, std::memory_order_release);
+	}
+
+	/**
+	 * Takes a slot returned by an exited thread, or adds a slot to the list.
+	 *
+	 * @return	The slot.
+	 *
+	 * @throw	std::bad_alloc if the slot cannot be allocated.
+	 */
+	PushSlot *PushSlots::Acquire()
+	{
+		for (PushSlot *slot = head.load(std::memory_order_acquire); slot != NULL; slot = slot->next) {
+			bool expected = false;
+			if (!slot->inUse.load(std::memory_order_relaxed) &&
+				slot->inUse.compare_exchange_strong(expected, true, std::memory_order_acquire))
+				return slot;
+		}
+
+		void *mem = NULL;
+		if (posix_memalign(&mem, CACHE_LINE_SIZE, sizeof(PushSlot)) != 0)
+			throw std::bad_alloc();
+		PushSlot *slot = new (mem) PushSlot();
+		slot->sink.store(NULL, std::memory_order_relaxed);
+		slot->inUse.store(true, std::memory_order_relaxed);
+		slot->next = head.load(std::memory_order_relaxed);
+		while (!head.compare_exchange_weak(slot->next, slot, std::memory_order_release, std::memory_order_relaxed))
+			;
+		return slot;
+	}
+
+	/**
+	 * Returns a slot, to be taken by a thread started later.
+	 *
+	 * @param	slot	The slot.
+	 */
+	void PushSlots::Release(PushSlot *slot)
+	{
+		slot->sink.store(NULL, std::memory_order_relaxed);
+		slot->inUse.store(false, std::memory_order_release);
+	}
+
+	/**
+	 * Checks whether a logging thread is pushing to a sink.
+	 *
+	 * @param	sink	The sink.
+	 *
+	 * @return	true is returned if the slot of a thread holds the sink. Otherwise, false is returned.
+	 */
+	bool PushSlots::IsPushing(const LogSink *sink)
+	{
+		for (PushSlot *slot = head.load(std::memory_order_acquire); slot != NULL; slot = slot->next) {
+			if (slot->sink.load(std::memory_order_seq_cst) == sink)
+				return true;
+		}
+		return false;
+	}
+
+	/**
+	 * Parses a CPU list of sysfs ('0-3,8,10-11').
+	 *
+	 * @param	list	The CPU list.
+	 * @param	cpus	The CPUs.
+	 *
+	 * @return	false is returned if the list is malformed. Otherwise, true is returned.
+	 */
+	bool NumaTopology::ParseCpuList(const std::string& list, std::vector<int>& cpus)
+	{
+		cpus.clear();
+		const char *p = list.c_str();
+		while (*p != '\0' && *p != '\n') {
+			char *end;
+			long first = strtol(p, &end, 10);
+			if (end == p || first < 0)
+				return false;
+			long last = first;
+			p = end;
+			if (*p == '-') {
+				last = strtol(++p, &end, 10);
+				if (end == p || last < first)
+					return false;
+				p = end;
+			}
+			for (long cpu = first; cpu <= last && cpu < CPU_SETSIZE; cpu++)
+				cpus.push_back((int) cpu);
+			if (*p == ',')
+				p++;
+			else if (*p != '\0' && *p != '\n')
+				return false;
+		}
+		return true;
+	}
+
+	/**
+	 * Reads the nodes ('nodeN' directories) and their CPUs ('nodeN/cpulist') from a sysfs node directory.
+	 *
+	 * @param	root	The node directory.
+	 *
+	 * @return	false is returned if no node could be read. Otherwise, true is returned.
+	 */
+	bool NumaTopology::Load(const std::string& root)
+	{
+		std::vector<int> ids;
+		DIR *dir = opendir(root.c_str());
+		if (dir == NULL)
+			return false;
+		for (struct dirent *entry; (entry = readdir(dir)) != NULL;) {
+			if (strncmp(entry->d_name, "node", 4) == 0 && isdigit((unsigned char) entry->d_name[4]))
+				ids.push_back(atoi(entry->d_name + 4));
+		}
+		closedir(dir);
+		std::sort(ids.begin(), ids.end());
+
+		nodeCpus.clear();
+		cpuNodes.clear();
+		for (size_t i = 0; i < ids.size(); i++) {
+			std::ifstream file(root + "/node" + std::to_string(ids[i]) + "/cpulist");
+			std::string list;
+			std::vector<int> cpus;
+			std::getline(file, list);
+			if (!ParseCpuList(list, cpus))
+				continue;
+
+			for (size_t c = 0; c < cpus.size(); c++) {
+				if ((size_t) cpus[c] >= cpuNodes.size())
+					cpuNodes.resize(cpus[c] + 1, 0);
+				cpuNodes[cpus[c]] = (unsigned char) std::min(nodeCpus.size(), (size_t) UCHAR_MAX);
+			}
+			nodeCpus.push_back(cpus);
+		}
+		return !nodeCpus.empty();
+	}
+
+	/**
+	 * Retrieves the log line of a log record, formatting deferred records to buffer.
+	 *
+	 * @param	record	The log record.
+	 * @param	buffer	The string where deferred records are formatted.
+	 *
+	 * @return	Pointer to the (UTF-8) log line, or NULL if the record could not be formatted.
+	 */
+	const char *LogSink::GetLine(const LogRecord& record, std::string& buffer)
+	{
+		if (record.format == NULL && record.narrowFormat == NULL)
+			return record.text.c_str();
+
+		buffer.clear();
+		if (!LoggerUtil::FormatRecord(buffer, record))
+			return NULL;
+
+		return buffer.c_str();
+	}
+
+	/**
+	 * Computes the next time based rotation, the next multiple of the interval in local time.
+	 *
+	 * @param	intervalSec	The rotation interval in seconds.
+	 *
+	 * @return	The time of the next rotation in nanoseconds since epoch.
+	 */
+	static long long NextRotation(unsigned int intervalSec)
+	{
+		time_t now = time(NULL);
+		tm time_info;
+		localtime_r(&now, &time_info);
+		long long local = (long long) now + time_info.tm_gmtoff;
+		long long next = (local / intervalSec + 1) * intervalSec - time_info.tm_gmtoff;
+		return next * 1000000000LL;
+	}
+
+	//! Suffixes of the rotated files
+	static const char *rotatedSuffixes[] = { "", ".gz", ".zst" };
+
+	/**
+	 * Finds the rotated file of an index, which may have been compressed.
+	 *
+	 * @param	path	The log file path.
+	 * @param	index	The rotated file index.
+	 * @param	name	The rotated file name ('path.index' with the compression suffix, if any).
+	 *
+	 * @return	true is returned if the rotated file exists. Otherwise, false is returned.
+	 */
+	static bool FindRotatedFile(const std::string& path, unsigned int index, std::string& name)
+	{
+		for (size_t i = 0; i < sizeof(rotatedSuffixes) / sizeof(rotatedSuffixes[0]); i++) {
+			name = path + "." + std::to_string(index) + rotatedSuffixes[i];
+			if (LoggerUtil::FileExists(name))
+				return true;
+		}
+		return false;
+	}
+
+	/**
+	 * Renames the log file to 'path.1', shifting the rotated files ('path.1' to 'path.2' and so on, keeping
+	 * their compression suffix) and removing the ones beyond options.maxFiles. Each rename is atomic, the log
+	 * file is recreated when the write thread opens it next.
+	 *
+	 * @param	path	The log file path.
+	 */
+	void LoggerWorker::RotateFile(const std::string& path)
+	{
+		std::lock_guard<std::mutex> lock(mtxRotation);
+		std::string name;
+
+		// Find the oldest rotated file
+		unsigned int last = 0;
+		while (FindRotatedFile(path, last + 1, name))
+			last++;
+
+		if (options.maxFiles > 0) {
+			for (; last >= options.maxFiles; last--) {
+				if (FindRotatedFile(path, last, name))
+					remove(name.c_str());
+				remove(IndexPath(path, last).c_str());
+			}
+		}
+		for (unsigned int i = last; i > 0; i--) {
+			if (FindRotatedFile(path, i, name)) {
+				std::string suffix = name.substr(path.size() + 1 + std::to_string(i).size());
+				rename(name.c_str(), (path + "." + std::to_string(i + 1) + suffix).c_str());
+			}
+			rename(IndexPath(path, i).c_str(), IndexPath(path, i + 1).c_str());
+		}
+
+		if (rename(path.c_str(), (path + ".1").c_str()) != 0)
+			Logger::SysLogError("LoggerWorker::RotateFile() failed to rotate (%s): %s", path.c_str(), strerror(errno));
+		rename(IndexPath(path).c_str(), IndexPath(path, 1).c_str());
+
+		// Hand the rotated file to the compression thread
+		hasRotatedFiles = true;
+		condCompression.notify_one();
+	}
+
+	// I/O priority (see ioprio_set(2)), not every libc exports the constants
+	#define CPPLOGGER_IOPRIO_WHO_PROCESS	1
+	#define CPPLOGGER_IOPRIO_CLASS_IDLE		3
+	#define CPPLOGGER_IOPRIO_CLASS_SHIFT	13
+
+	/**
+	 * Writes all the data to a file descriptor.
+	 *
+	 * @param	fd		The file descriptor.
+	 * @param	data	Pointer to the data.
+	 * @param	len		The size of the data.
+	 *
+	 * @return	true is returned if all the data is written. Otherwise, false is returned.
+	 */
+	static bool WriteAll(int fd, const char *data, size_t len)
+	{
+		while (len > 0) {
+			ssize_t n = write(fd, data, len);
+			if (n < 0 && errno == EINTR)
+				continue;
+			if (n <= 0)
+				return false;
+			data += n;
+			len -= (size_t) n;
+		}
+		return true;
+	}
+
+#if defined(CPPLOGGER_HAVE_ZLIB) || defined(CPPLOGGER_HAVE_ZSTD)
+	/**
+	 * Sleeps as long as needed to keep the average rate since start at or below rate bytes per second.
+	 *
+	 * @param	start	The start time.
+	 * @param	total	The number of bytes processed since start.
+	 * @param	rate	The maximum rate in bytes per second (0 for no limit).
+	 */
+	static void Throttle(steady_clock::time_point start, size_t total, size_t rate)
+	{
+		if (rate == 0)
+			return;
+
+		long long expectedMs = (long long) ((double) total * 1000.0 / (double) rate);
+		long long elapsedMs = duration_cast<milliseconds>(steady_clock::now() - start).count();
+		if (expectedMs > elapsedMs)
+			LoggerUtil::Sleep((unsigned int) (expectedMs - elapsedMs));
+	}
+#endif
+
+	/**
+	 * Compresses the input file to the output file (gzip or zstd), reading it at most at rate bytes per second.
+	 *
+	 * @param	in			The input file descriptor.
+	 * @param	out			The output file descriptor.
+	 * @param	type		The compression type.
+	 * @param	rate		The maximum rate in bytes per second (0 for no limit).
+	 * @param	interrupted	The compression thread interruption status, aborts the compression.
+	 *
+	 * @return	true is returned if the file is compressed. Otherwise, false is returned.
+	 */
+	static bool CompressStream(int in, int out, CompressionType type, size_t rate, volatile bool& interrupted)
+	{
+#if defined(CPPLOGGER_HAVE_ZLIB) || defined(CPPLOGGER_HAVE_ZSTD)
+		std::vector<char> inBuffer(COMPRESS_CHUNK_SIZE);
+		std::vector<char> outBuffer(COMPRESS_CHUNK_SIZE);
+		steady_clock::time_point start = steady_clock::now();
+		size_t total = 0;
+		bool ok = true;
+#endif
+
+		if (type == COMPRESSION_GZIP) {
+#ifdef CPPLOGGER_HAVE_ZLIB
+			z_stream strm;
+			memset(&strm, 0, sizeof(strm));
+			// windowBits 15 + 16 writes a gzip header and trailer
+			if (deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+				return false;
+
+			int flush = Z_NO_FLUSH;
+			while (ok && flush != Z_FINISH) {
+				ssize_t n = read(in, &inBuffer[0], inBuffer.size());
+				if (n < 0) {
+					ok = (errno == EINTR);
+					continue;
+				}
+				flush = n == 0 ? Z_FINISH : Z_NO_FLUSH;
+				strm.next_in = (Bytef *) &inBuffer[0];
+				strm.avail_in = (uInt) n;
+				do {
+					strm.next_out = (Bytef *) &outBuffer[0];
+					strm.avail_out = (uInt) outBuffer.size();
+					if (deflate(&strm, flush) == Z_STREAM_ERROR)
+						ok = false;
+					else
+						ok = WriteAll(out, &outBuffer[0], outBuffer.size() - strm.avail_out);
+				} while (ok && strm.avail_out == 0);
+
+				total += (size_t) n;
+				Throttle(start, total, rate);
+				ok = ok && !interrupted;
+			}
+			deflateEnd(&strm);
+			return ok;
+#else
+			return false;
+#endif
+		}
+
+		if (type == COMPRESSION_ZSTD) {
+#ifdef CPPLOGGER_HAVE_ZSTD
+			ZSTD_CCtx *cctx = ZSTD_createCCtx();
+			if (cctx == NULL)
+				return false;
+
+			bool finished = false;
+			while (ok && !finished) {
+				ssize_t n = read(in, &inBuffer[0], inBuffer.size());
+				if (n < 0) {
+					ok = (errno == EINTR);
+					continue;
+				}
+				ZSTD_EndDirective mode = n == 0 ? ZSTD_e_end : ZSTD_e_continue;
+				ZSTD_inBuffer input = { &inBuffer[0], (size_t) n, 0 };
+				bool done = false;
+				while (ok && !done) {
+					ZSTD_outBuffer output = { &outBuffer[0], outBuffer.size(), 0 };
+					size_t remaining = ZSTD_compressStream2(cctx, &output, &input, mode);
+					ok = !ZSTD_isError(remaining) && WriteAll(out, &outBuffer[0], output.pos);
+					done = mode == ZSTD_e_end ? remaining == 0 : input.pos == input.size;
+				}
+				finished = (mode == ZSTD_e_end);
+
+				total += (size_t) n;
+				Throttle(start, total, rate);
+				ok = ok && !interrupted;
+			}
+			ZSTD_freeCCtx(cctx);
+			return ok;
+#else
+			return false;
+#endif
+		}
+
+		return false;
+	}
+
+	/**
+	 * Compresses the rotated file 'path.index' to a temporary file, then replaces the rotated file (which may
+	 * have been shifted by a rotation meanwhile, it is found by its inode) with the compressed file.
+	 *
+	 * @param	path	The log file path.
+	 * @param	index	The rotated file index.
+	 *
+	 * @return	true is returned if the file is compressed. Otherwise, false is returned.
+	 */
+	bool LoggerWorker::CompressFile(const std::string& path, unsigned int index)
+	{
+		std::string src = path + "." + std::to_string(index);
+		std::string tmp = path + ".compress.tmp";
+		const char *suffix = options.compression == COMPRESSION_ZSTD ? ".zst" : ".gz";
+
+		int in = open(src.c_str(), O_RDONLY | O_CLOEXEC);
+		if (in < 0)
+			return false;
+		struct stat srcStat;
+		if (fstat(in, &srcStat) != 0) {
+			close(in);
+			return false;
+		}
+		int out = open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+		if (out < 0) {
+			close(in);
+			return false;
+		}
+
+		bool ok = CompressStream(in, out, options.compression, options.compressRate, isInterruptedCompression);
+		close(in);
+		ok = (close(out) == 0) && ok;
+		if (!ok) {
+			unlink(tmp.c_str());
+			return false;
+		}
+
+		std::lock_guard<std::mutex> lock(mtxRotation);
+		std::string name;
+		for (unsigned int i = index; FindRotatedFile(path, i, name); i++) {
+			struct stat st;
+			if (stat(name.c_str(), &st) == 0 && st.st_ino == srcStat.st_ino && st.st_dev == srcStat.st_dev) {
+				rename(tmp.c_str(), (name + suffix).c_str());
+				unlink(name.c_str());
+				// The offsets of the time index do not apply to the compressed file
+				unlink(IndexPath(path, i).c_str());
+				return true;
+			}
+		}
+
+		// Removed by a rotation meanwhile
+		unlink(tmp.c_str());
+		return false;
+	}
+
+	/**
+	 * Names the calling background thread and pins it to the CPUs of the options, so that it stays off the
+	 * (isolated) CPUs of the logging threads. The writer threads also get the scheduling policy and the nice value
+	 * of the options. Failures are reported to syslog, the thread keeps running with the inherited settings.
+	 *
+	 * @param	role		The role of the thread, appended to the name prefix ('w0', 'gz', 'tsc').
+	 * @param	isWriter	Whether the thread is a writer thread.
+	 */
+	static void SetUpThread(const std::string& role, bool isWriter)
+	{
+		const LoggerOptions& options = worker.options;
+		std::string name = options.threadName.empty() ? role : options.threadName + "-" + role;
+		if (name.size() > THREAD_NAME_MAX)
+			name.resize(THREAD_NAME_MAX);
+		pthread_setname_np(pthread_self(), name.c_str());
+
+		if (!options.writerCpus.empty()) {
+			cpu_set_t cpus;
+			CPU_ZERO(&cpus);
+			for (size_t i = 0; i < options.writerCpus.size(); i++) {
+				if (options.writerCpus[i] >= 0 && options.writerCpus[i] < CPU_SETSIZE)
+					CPU_SET(options.writerCpus[i], &cpus);
+			}
+			int ret = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+			if (ret != 0)
+				syslog(LOG_WARNING, "SetUpThread() failed to pin thread %s (%s)", name.c_str(), strerror(ret));
+		}
+
+		if (!isWriter)
+			return;
+
+		if (options.writerPolicy != SCHED_OTHER) {
+			struct sched_param param;
+			param.sched_priority = 0;
+			int ret = pthread_setschedparam(pthread_self(), options.writerPolicy, &param);
+			if (ret != 0)
+				syslog(LOG_WARNING, "SetUpThread() failed to set scheduling policy of %s (%s)", name.c_str(),
+					strerror(ret));
+		}
+		if (options.writerNice != 0 && setpriority(PRIO_PROCESS, (id_t) syscall(SYS_gettid), options.writerNice) != 0)
+			syslog(LOG_WARNING, "SetUpThread() failed to set nice value of %s (%s)", name.c_str(), strerror(errno));
+	}
+
+	/**
+	 * Compresses the rotated files (oldest first) whenever a log file is rotated, until DropAll() is called.
+	 * Runs at the lowest CPU priority and the idle I/O priority class, and reads at most options.compressRate
+	 * bytes per second, so that it does not compete with the write threads.
+	 */
+	void LoggerWorker::CompressRotatedFiles()
+	{
+		SetUpThread("gz", false);
+		pid_t tid = (pid_t) syscall(SYS_gettid);
+		if (setpriority(PRIO_PROCESS, (id_t) tid, 19) != 0)
+			syslog(LOG_WARNING, "LoggerWorker::CompressRotatedFiles() failed to set nice value (%s)", strerror(errno));
+		if (syscall(SYS_ioprio_set, CPPLOGGER_IOPRIO_WHO_PROCESS, tid,
+			CPPLOGGER_IOPRIO_CLASS_IDLE << CPPLOGGER_IOPRIO_CLASS_SHIFT) != 0)
+			syslog(LOG_WARNING, "LoggerWorker::CompressRotatedFiles() failed to set I/O priority (%s)", strerror(errno));
+
+		std::string paths[] = { aplSink.GetPath(), dbgSink.GetPath(), evntSink.GetPath() };
+		for (;;) {
+			{
+				std::unique_lock<std::mutex> lock(mtxRotation);
+				condCompression.wait(lock, [this]() { return hasRotatedFiles || isInterruptedCompression; });
+				if (isInterruptedCompression)
+					break;
+				hasRotatedFiles = false;
+			}
+
+			for (size_t p = 0; p < sizeof(paths) / sizeof(paths[0]) && !isInterruptedCompression; p++) {
+				if (std::find(paths, paths + p, paths[p]) != paths + p)
+					continue;
+
+				std::string name;
+				unsigned int last = 0;
+				while (FindRotatedFile(paths[p], last + 1, name))
+					last++;
+				for (unsigned int i = last; i > 0 && !isInterruptedCompression; i--) {
+					if (LoggerUtil::FileExists(paths[p] + "." + std::to_string(i)))
+						CompressFile(paths[p], i);
+				}
+			}
+		}
+	}
+
+	/**
+	 * Counts a record dropped on queue overflow.
+	 *
+	 * @param	level	The log severity level of the record.
+	 */
+	void DropCounts::Add(SeverityLevel level)
+	{
+		size_t index = (size_t) level < SEVERITY_LEVEL_COUNT ? (size_t) level : 0;
+		pending[index].fetch_add(1, std::memory_order_relaxed);
+		total[index].fetch_add(1, std::memory_order_relaxed);
+		hasPending.store(true, std::memory_order_release);
+	}
+
+	/**
+	 * Takes the records dropped since the last summary line and describes them, e.g. '12 records dropped
+	 * (INFO 10, DEBUG 2)'.
+	 *
+	 * @param	summary	The description.
+	 *
+	 * @return	The number of records dropped since the last summary line.
+	 */
+	unsigned long DropCounts::TakePending(std::string& summary)
+	{
+		static const char *names[SEVERITY_LEVEL_COUNT] = {
+			"INFO", "EVENT", NULL, NULL, NULL, NULL, "DEBUG", "WARN", "ERR", "CRIT" };
+
+		hasPending.store(false, std::memory_order_release);
+		unsigned long total = 0;
+		std::string levels;
+		for (int i = 0; i < SEVERITY_LEVEL_COUNT; i++) {
+			unsigned long count = pending[i].exchange(0, std::memory_order_acq_rel);
+			if (count == 0)
+				continue;
+			total += count;
+			levels += (levels.empty() ? "" : ", ") + std::string(names[i] ? names[i] : "?") + " " + std::to_string(count);
+		}
+		summary = std::to_string(total) + " records dropped (" + levels + ")";
+		return total;
+	}
+
+	/**
+	 * Mixes the severity level, code and call site of a record into the key of its token bucket.
+	 *
+	 * @param	level		The log severity level.
+	 * @param	code		The code.
+	 * @param	callSite	The call site (format string), NULL to limit per code.
+	 *
+	 * @return	The key (never 0).
+	 */
+	static uint64_t RateLimitKey(SeverityLevel level, unsigned long code, const void *callSite)
+	{
+		// splitmix64 finalizer
+		uint64_t key = ((uint64_t) level << 40) ^ (uint64_t) code ^ ((uint64_t) (uintptr_t) callSite * 0x9e3779b97f4a7c15ULL);
+		key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		key = (key ^ (key >> 27)) * 0x94d049bb133111ebULL;
+		key ^= key >> 31;
+		return key != 0 ? key : 1;
+	}
+
+	/**
+	 * Reads the coarse monotonic clock, the rate limit does not need more than its few milliseconds resolution.
+	 *
+	 * @return	The time in nanoseconds.
+	 */
+	static long long RateLimitClock()
+	{
+		struct timespec ts;
+		clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+		return (long long) ts.tv_sec * 1000000000LL + ts.tv_nsec;
+	}
+
+	//! Constructor
+	RateLimiter::RateLimiter()
+	{
+		for (size_t i = 0; i < RATE_LIMIT_BUCKETS; i++) {
+			buckets[i].key.store(0, std::memory_order_relaxed);
+			buckets[i].level.store(0, std::memory_order_relaxed);
+			buckets[i].code.store(0, std::memory_order_relaxed);
+			buckets[i].arrival.store(0, std::memory_order_relaxed);
+			buckets[i].suppressed.store(0, std::memory_order_relaxed);
+			buckets[i].nextSummary.store(0, std::memory_order_relaxed);
+		}
+		for (size_t i = 0; i < RATE_LIMIT_CODES; i++) {
+			limits[i].key.store(0, std::memory_order_relaxed);
+			limits[i].interval.store(0, std::memory_order_relaxed);
+			limits[i].burst.store(0, std::memory_order_relaxed);
+		}
+		limitCount.store(0, std::memory_order_relaxed);
+		defaultInterval.store(0, std::memory_order_relaxed);
+		defaultBurst.store(0, std::memory_order_relaxed);
+		enabled.store(false, std::memory_order_relaxed);
+		perCallSite.store(false, std::memory_order_relaxed);
+	}
+
+	/**
+	 * Sets the limit of the codes without their own limit.
+	 *
+	 * @param	rate		Records per second (0 for no limit).
+	 * @param	burst		Records allowed at once (0 is treated as 1).
+	 * @param	perCallSite	true to limit per call site (format string) instead of per code.
+	 */
+	void RateLimiter::SetDefault(unsigned int rate, unsigned int burst, bool perCallSite)
+	{
+		defaultBurst.store(burst > 0 ? burst : 1, std::memory_order_relaxed);
+		defaultInterval.store(rate > 0 ? 1000000000LL / rate : 0, std::memory_order_relaxed);
+		this->perCallSite.store(perCallSite, std::memory_order_relaxed);
+		enabled.store(rate > 0 || limitCount.load(std::memory_order_relaxed) > 0, std::memory_order_release);
+	}
+
+	/**
+	 * Sets the limit of a code, overriding the default limit.
+	 *
+	 * @param	level	The log severity level.
+	 * @param	code	The code (0 for DEBUG and EVENT).
+	 * @param	rate	Records per second (0 for no limit).
+	 * @param	burst	Records allowed at once (0 is treated as 1).
+	 *
+	 * @return	false is returned if RATE_LIMIT_CODES limits are already set. Otherwise, true is returned.
+	 */
+	bool RateLimiter::SetLimit(SeverityLevel level, unsigned long code, unsigned int rate, unsigned int burst)
+	{
+		uint64_t key = RateLimitKey(level, code, NULL);
+		for (size_t probe = 0; probe < RATE_LIMIT_CODES; probe++) {
+			Limit& limit = limits[(key + probe) % RATE_LIMIT_CODES];
+			uint64_t current = limit.key.load(std::memory_order_acquire);
+			if (current == 0) {
+				if (!limit.key.compare_exchange_strong(current, key, std::memory_order_acq_rel) && current != key)
+					continue;
+				if (current == 0)
+					limitCount.fetch_add(1, std::memory_order_relaxed);
+				current = key;
+			}
+			if (current == key) {
+				// Until both are stored, a record of the code may still be checked against its previous limit
+				limit.burst.store(burst > 0 ? burst : 1, std::memory_order_relaxed);
+				limit.interval.store(rate > 0 ? 1000000000LL / rate : 0, std::memory_order_relaxed);
+				enabled.store(true, std::memory_order_release);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/**
+	 * Finds the limit of a code, the default limit if the code has none of its own.
+	 *
+	 * @param	level		The log severity level.
+	 * @param	code		The code.
+	 * @param	interval	The interval between two records (ns, 0 for no limit).
+	 * @param	burst		The records allowed at once.
+	 */
+	void RateLimiter::FindLimit(SeverityLevel level, unsigned long code, long long& interval, unsigned int& burst)
+	{
+		if (limitCount.load(std::memory_order_relaxed) > 0) {
+			uint64_t key = RateLimitKey(level, code, NULL);
+			for (size_t probe = 0; probe < RATE_LIMIT_CODES; probe++) {
+				Limit& limit = limits[(key + probe) % RATE_LIMIT_CODES];
+				uint64_t current = limit.key.load(std::memory_order_acquire);
+				if (current == 0)
+					break;
+				if (current == key) {
+					interval = limit.interval.load(std::memory_order_relaxed);
+					burst = limit.burst.load(std::memory_order_relaxed);
+					return;
+				}
+			}
+		}
+		interval = defaultInterval.load(std::memory_order_relaxed);
+		burst = defaultBurst.load(std::memory_order_relaxed);
+	}
+
+	/**
+	 * Checks whether a record may be written, taking a token from the bucket of its code (or call site).<br>
+	 * A suppressed record is counted, and every RATE_LIMIT_SUMMARY_MS one caller takes the count to report it.
+	 * Records are allowed if the table of buckets is full.
+	 *
+	 * @param	level		The log severity level.
+	 * @param	code		The code.
+	 * @param	callSite	The call site (format string).
+	 * @param	suppressed	The records suppressed since the last summary if the caller has to report them,
+	 *						otherwise 0.
+	 *
+	 * @return	true is returned if the record may be written. Otherwise, false is returned.
+	 */
+	bool RateLimiter::Allow(SeverityLevel level, unsigned long code, const void *callSite, unsigned long& suppressed)
+	{
+		suppressed = 0;
+		long long interval;
+		unsigned int burst;
+		FindLimit(level, code, interval, burst);
+		if (interval == 0)
+			return true;
+
+		uint64_t key = RateLimitKey(level, code, perCallSite.load(std::memory_order_relaxed) ? callSite : NULL);
+		long long now = RateLimitClock();
+		Bucket *bucket = NULL;
+		for (size_t probe = 0; probe < RATE_LIMIT_PROBES; probe++) {
+			Bucket& candidate = buckets[(key + probe) % RATE_LIMIT_BUCKETS];
+			uint64_t current = candidate.key.load(std::memory_order_acquire);
+			if (current == 0) {
+				if (!candidate.key.compare_exchange_strong(current, key, std::memory_order_acq_rel) && current != key)
+					continue;
+				if (current == 0) {
+					candidate.level.store(level, std::memory_order_relaxed);
+					candidate.code.store(code, std::memory_order_relaxed);
+					candidate.nextSummary.store(now + RATE_LIMIT_SUMMARY_MS * 1000000LL, std::memory_order_relaxed);
+				}
+				bucket = &candidate;
+				break;
+			}
+			if (current == key) {
+				bucket = &candidate;
+				break;
+			}
+		}
+		if (bucket == NULL)
+			return true;
+
+		// GCRA: the record conforms if the next arrival time is at most (burst - 1) intervals ahead
+		long long tolerance = interval * (long long) (burst - 1);
+		long long arrival = bucket->arrival.load(std::memory_order_relaxed);
+		bool allowed = false;
+		for (;;) {
+			long long start = arrival > now ? arrival : now;
+			if (start - now > tolerance)
+				break;
+			if (bucket->arrival.compare_exchange_weak(arrival, start + interval, std::memory_order_relaxed)) {
+				allowed = true;
+				break;
+			}
+		}
+		if (!allowed)
+			bucket->suppressed.fetch_add(1, std::memory_order_relaxed);
+
+		long long next = bucket->nextSummary.load(std::memory_order_relaxed);
+		if (now >= next && bucket->suppressed.load(std::memory_order_relaxed) > 0 &&
+			bucket->nextSummary.compare_exchange_strong(next, now + RATE_LIMIT_SUMMARY_MS * 1000000LL,
+				std::memory_order_relaxed))
+			suppressed = bucket->suppressed.exchange(0, std::memory_order_relaxed);
+		return allowed;
+	}
+
+	/**
+	 * Takes the records suppressed since the last summary of a bucket, used to report them on close.
+	 *
+	 * @param	index		The index of the bucket (0 - RATE_LIMIT_BUCKETS - 1).
+	 * @param	level		The log severity level of the records.
+	 * @param	code		The code of the records.
+	 * @param	suppressed	The number of suppressed records.
+	 *
+	 * @return	false is returned if the bucket has nothing to report. Otherwise, true is returned.
+	 */
+	bool RateLimiter::TakeSuppressed(size_t index, SeverityLevel& level, unsigned long& code, unsigned long& suppressed)
+	{
+		Bucket& bucket = buckets[index];
+		if (bucket.key.load(std::memory_order_acquire) == 0 || bucket.suppressed.load(std::memory_order_relaxed) == 0)
+			return false;
+		suppressed = bucket.suppressed.exchange(0, std::memory_order_relaxed);
+		level = (SeverityLevel) bucket.level.load(std::memory_order_relaxed);
+		code = bucket.code.load(std::memory_order_relaxed);
+		return suppressed > 0;
+	}
+
+	/**
+	 * Makes the summary record of the records a log queue has dropped since the last summary.
+	 *
+	 * @param	dropped	The records the log queue has dropped on overflow.
+	 * @param	record	The summary record.
+	 *
+	 * @return	false is returned if there is nothing to report. Otherwise, true is returned.
+	 */
+	static bool MakeDropSummary(DropCounts& dropped, LogRecord& record)
+	{
+		std::string summary;
+		if (dropped.TakePending(summary) == 0)
+			return false;
+
+		char time[MAX_LEN_DATE_BUFFER];
+		record.level = WARNING;
+		record.code = LOGGER_CODE_WARN_RECORDS_DROPPED;
+		record.timestamp = LoggerUtil::GetTimestamp();
+		record.tscTimestamp = false;
+		record.format = NULL;
+		record.narrowFormat = NULL;
+		record.args.clear();
+		record.text.clear();
+		LoggerUtil::GetTimeString(time, record.timestamp, worker.timestampFormat);
+		return LoggerUtil::FormatLine(record.text, record.level, record.code, time, summary.data(), summary.size());
+	}
+
+	/**
+	 * Finds the message of an immediate log line, skipping the time stamp.
+	 *
+	 * @param	text	The log line.
+	 *
+	 * @return	The offset of the severity tag following the time stamp.
+	 */
+	static size_t MessageOffset(const std::string& text)
+	{
+		size_t pos = text.find(" [");
+		return pos != std::string::npos ? pos : 0;
+	}
+
+	/**
+	 * Checks whether a record repeats the last record kept: same level and code, and the same format string and
+	 * arguments (deferred records) or the same message (immediate records).
+	 *
+	 * @param	record	The record.
+	 *
+	 * @return	true is returned if the record is a repeat. Otherwise, false is returned.
+	 */
+	bool RepeatFilter::IsRepeat(const LogRecord& record) const
+	{
+		if (!hasLast || record.level != last.level || record.code != last.code || record.format != last.format ||
+			record.narrowFormat != last.narrowFormat)
+			return false;
+		if (record.format != NULL || record.narrowFormat != NULL)
+			return record.args == last.args;
+
+		size_t offset = MessageOffset(record.text);
+		size_t lastOffset = MessageOffset(last.text);
+		return record.text.size() - offset == last.text.size() - lastOffset &&
+			memcmp(record.text.data() + offset, last.text.data() + lastOffset, record.text.size() - offset) == 0;
+	}
+
+	/**
+	 * Makes the 'last message repeated N times' record of the collapsed repeats, stamped with the time of the
+	 * last repeat.
+	 *
+	 * @param	record	The summary record.
+	 */
+	void RepeatFilter::MakeSummary(LogRecord& record)
+	{
+		char time[MAX_LEN_DATE_BUFFER];
+		char msg[64];
+		int len = snprintf(msg, sizeof(msg), "last message repeated %lu times", repeats);
+		repeats = 0;
+
+		record.level = last.level;
+		record.code = last.code;
+		record.timestamp = repeatTimestamp;
+		record.tscTimestamp = false;
+		record.format = NULL;
+		record.narrowFormat = NULL;
+		record.args.clear();
+		record.text.clear();
+		LoggerUtil::GetTimeString(time, record.timestamp, worker.timestampFormat);
+		LoggerUtil::FormatLine(record.text, record.level, record.code, time, msg, (size_t) len);
+	}
+
+	/**
+	 * Collapses the records of a batch repeating the record before them, and inserts the summary of the collapsed
+	 * repeats before the next different record or once they are due.
+	 *
+	 * @param	batch	The batch, replaced by the records kept.
+	 * @param	count	The number of records in the batch.
+	 * @param	flushMs	The time the collapsed repeats are reported at the latest after the first repeat (ms).
+	 * @param	flush	Report the collapsed repeats now.
+	 *
+	 * @return	The number of records kept.
+	 */
+	size_t RepeatFilter::Collapse(std::vector<LogRecord>& batch, size_t count, unsigned int flushMs, bool flush)
+	{
+		long long now = duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+		if (kept.size() < count + 2)
+			kept.resize(count + 2);
+
+		size_t n = 0;
+		for (size_t i = 0; i < count; i++) {
+			LogRecord& record = batch[i];
+			if (IsRepeat(record)) {
+				if (repeats++ == 0)
+					deadline = now + flushMs;
+				repeatTimestamp = record.tscTimestamp ? TscClock::ToNanoseconds(record.timestamp) : record.timestamp;
+				continue;
+			}
+
+			if (repeats > 0) {
+				if (kept.size() <= n + 1)
+					kept.resize(n + 2);
+				MakeSummary(kept[n++]);
+			}
+
+			last.level = record.level;
+			last.code = record.code;
+			last.format = record.format;
+			last.narrowFormat = record.narrowFormat;
+			last.args.assign(record.args);
+			last.text.assign(record.text);
+			hasLast = true;
+			std::swap(kept[n++], record);
+		}
+
+		if (repeats > 0 && (flush || now >= deadline))
+			MakeSummary(kept[n++]);
+
+		std::swap(batch, kept);
+		return n;
+	}
+
+	/**
+	 * Gets the time until the collapsed repeats are due to be reported.
+	 *
+	 * @return	The time in milliseconds (0 if due already).
+	 */
+	long long RepeatFilter::GetRemaining() const
+	{
+		long long now = duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+		return deadline > now ? deadline - now : 0;
+	}
+
+	/**
+	 * Appends the records of a batch to the write buffer (cleared first), either as log lines or, with a binary
+	 * log writer, as binary entries.
+	 *
+	 * @param	batch	The batch.
+	 * @param	count	The number of records in the batch.
+	 * @param	binary	The binary log writer (NULL for the text format).
+	 * @param	buffer	The write buffer.
+	 */
+	static void FormatBatch(const std::vector<LogRecord>& batch, size_t count, BinaryLogWriter *binary,
+		std::string& buffer)
+	{
+		buffer.clear();
+		for (size_t i = 0; i < count; i++) {
+			if (binary != NULL) {
+				binary->Append(buffer, batch[i]);
+				continue;
+			}
+
+			// Records are UTF-8 already, append them as they are
+			if (batch[i].format == NULL && batch[i].narrowFormat == NULL) {
+				buffer.append(batch[i].text);
+			} else if (!LoggerUtil::FormatRecord(buffer, batch[i])) {
+				continue;
+			}
+			buffer.push_back('\n');
+		}
+	}
+
+	/**
+	 * Appends a time index entry for a batch written at the given file offset. The entry holds the oldest time
+	 * stamp of the batch, as the time stamps of records logged concurrently may be slightly out of order.
+	 *
+	 * @param	fd		The time index file descriptor.
+	 * @param	batch	The batch.
+	 * @param	count	The number of records in the batch.
+	 * @param	offset	The file offset the batch is written at.
+	 */
+	static void AppendIndex(int fd, const std::vector<LogRecord>& batch, size_t count, size_t offset)
+	{
+		LogIndexEntry entry;
+		entry.timestamp = INT64_MAX;
+		entry.offset = offset;
+		for (size_t i = 0; i < count; i++) {
+			long long timestamp = batch[i].tscTimestamp ? TscClock::ToNanoseconds(batch[i].timestamp) : batch[i].timestamp;
+			entry.timestamp = std::min(entry.timestamp, (int64_t) timestamp);
+		}
+
+		if (count > 0 && write(fd, &entry, sizeof(entry)) != (ssize_t) sizeof(entry))
+			syslog(LOG_WARNING, "FileSink::WriteBatch() failed to write the time index (%s)", strerror(errno));
+	}
+
+	//! Closes a time index file descriptor (if open)
+	static void CloseIndex(int& fd)
+	{
+		if (fd >= 0)
+			close(fd);
+		fd = -1;
+	}
+
+	/**
+	 * Pops a batch of records from the queue of a sink and writes it to the sink. Once the first record of a
+	 * batch is available, waits up to batchLatencyMs for the batch to fill up to batchSize records. The records
+	 * the queue has dropped are reported along with the batch once it has recovered.
+	 *
+	 * @param	sink	The sink (serviced by the calling writer thread only).
+	 * @param	batch	The batch buffer of the writer thread.
+	 *
+	 * @return	true is returned if a batch is written. Otherwise (the queue is empty), false is returned.
+	 */
+	bool LoggerWorker::ServiceSink(LogSink& sink, std::vector<LogRecord>& batch)
+	{
+		size_t maxCount = batchSize > 0 ? batchSize : 1;
+		size_t count = sink.PopBatch(batch, 0, maxCount);
+		if (count == 0)
+			return false;
+
+		// Give the batch up to batchLatencyMs to fill up
+		if (count < maxCount && batchLatencyMs > 0) {
+			steady_clock::time_point deadline = steady_clock::now() + milliseconds(batchLatencyMs);
+			while (count < maxCount && !isInterruptedWriters) {
+				long long remaining = duration_cast<milliseconds>(deadline - steady_clock::now()).count();
+				if (remaining <= 0)
+					break;
+				// Read before popping, a record pushed meanwhile to the queue of the sink or of a node rings
+				// the doorbell again
+				unsigned long rings = doorbell.Rings();
+				size_t popped = sink.PopBatch(batch, count, maxCount - count);
+				count += popped;
+				if (popped == 0)
+					doorbell.Wait(rings, remaining);
+			}
+		}
+
+		// Once the queue has recovered, report the records dropped meanwhile along with the batch
+		if (sink.dropped.hasPending.load(std::memory_order_acquire) &&
+			sink.Size() <= sink.queue.capacity() / 2) {
+			if (batch.size() <= count)
+				batch.resize(count + 1);
+			if (MakeDropSummary(sink.dropped, batch[count]))
+				count++;
+		}
+
+		try {
+			std::lock_guard<std::mutex> lock(sink.mtx);
+			sink.Write(batch, count);
+		} catch (std::exception& ex) {
+			Logger::SysLogError("LoggerWorker::ServiceSink() failed to write to a sink(%s)", ex.what());
+		}
+		return true;
+	}
+
+	/**
+	 * Writer thread: services the queues of all the sinks until StopWriters() is called and the queues have
+	 * drained. A sink is serviced by one writer thread at a time; the threads sleep on the doorbell of the queues
+	 * while all of them are empty, or until a sink has something due (see LogSink::Flush()).
+	 *
+	 * @param	index	The index of the writer thread, part of its name.
+	 */
+	void LoggerWorker::WriteToSinks(unsigned int index)
+	{
+		SetUpThread("w" + std::to_string(index), true);
+		std::vector<LogRecord> batch;
+
+		for (;;) {
+			// Read before looking at the queues, a record pushed meanwhile rings the doorbell again
+			unsigned long rings = doorbell.Rings();
+			bool interrupted = isInterruptedWriters;
+			bool written = false;
+			long long timeoutMs = -1;
+
+			size_t count = routeCount.load(std::memory_order_acquire);
+			for (size_t i = 0; i < count; i++) {
+				LogSink& sink = *routes[i].sink.load(std::memory_order_relaxed);
+				bool expected = false;
+				if (!sink.busy.compare_exchange_strong(expected, true, std::memory_order_acquire))
+					continue;
+
+				if (ServiceSink(sink, batch)) {
+					written = true;
+				} else {
+					std::lock_guard<std::mutex> lock(sink.mtx);
+					long long dueMs = sink.Flush(interrupted);
+					if (dueMs >= 0 && (timeoutMs < 0 || dueMs < timeoutMs))
+						timeoutMs = dueMs;
+				}
+				sink.busy.store(false, std::memory_order_release);
+			}
+
+			if (written)
+				continue;
+
+			// Queues have drained, stop once interrupted
+			if (interrupted)
+				break;
+
+			doorbell.Wait(rings, timeoutMs);
+		}
+	}
+
+	/**
+	 * Allocates the queues of the NUMA nodes of every sink. The queues of a node are allocated by a thread pinned
+	 * to the CPUs of the node, so that they are placed in its memory (first touch); the first node uses the queue
+	 * of the sink.
+	 *
+	 * @return	The number of nodes with queues, 1 if the host has a single node or the nodes cannot be read.
+	 */
+	size_t LoggerWorker::CreateNodeQueues()
+	{
+		if (numaNodes.Count() == 0 && !numaNodes.Load()) {
+			Logger::SysLogWarn("LoggerWorker::CreateNodeQueues() failed to read the NUMA nodes (%s)", NUMA_NODE_PATH);
+			return 1;
+		}
+
+		size_t nodes = std::min(numaNodes.Count(), (size_t) NUMA_NODES_MAX);
+		size_t count = routeCount.load(std::memory_order_acquire);
+		for (size_t node = 1; node < nodes; node++) {
+			bool allocated = true;
+			std::thread allocator([this, node, count, &allocated]() {
+				cpu_set_t cpus;
+				CPU_ZERO(&cpus);
+				const std::vector<int>& nodeCpus = numaNodes.Cpus(node);
+				for (size_t i = 0; i < nodeCpus.size(); i++)
+					CPU_SET(nodeCpus[i], &cpus);
+				if (nodeCpus.empty() || pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) != 0)
+					Logger::SysLogWarn("LoggerWorker::CreateNodeQueues() failed to run on node %u", (unsigned int) node);
+
+				try {
+					for (size_t i = 0; i < count; i++)
+						routes[i].sink.load(std::memory_order_relaxed)->AllocateNodeQueue(node, &doorbell);
+				} catch (...) {
+					allocated = false;
+				}
+			});
+			allocator.join();
+
+			// The nodes are allocated in order, the nodes after a failed one use the queue of the sink
+			if (!allocated) {
+				Logger::SysLogWarn("LoggerWorker::CreateNodeQueues() failed to allocate the queues of node %u",
+					(unsigned int) node);
+				return node;
+			}
+		}
+		return nodes;
+	}
+
+	/**
+	 * Starts the writer threads, which service the queues of all the sinks.
+	 *
+	 * @param	count	The number of writer threads (0 is treated as 1).
+	 */
+	void LoggerWorker::StartWriters(unsigned int count)
+	{
+		if (!mWriterThreads.empty())
+			return;
+
+		isInterruptedWriters = false;
+		for (unsigned int i = 0; i < std::max(count, 1u); i++)
+			mWriterThreads.push_back(new std::thread(&LoggerWorker::WriteToSinks, this, i));
+		hasWriterThreads = true;
+	}
+
+	/**
+	 * Stops the writer threads once they have drained the queues of all the sinks. The syslog messages are sent
+	 * on the calling threads afterwards.
+	 */
+	void LoggerWorker::StopWriters()
+	{
+		hasWriterThreads = false;
+		isInterruptedWriters = true;
+		doorbell.Ring();
+
+		// Release the writer threads waiting for a batch to fill up
+		size_t count = routeCount.load(std::memory_order_acquire);
+		for (size_t i = 0; i < count; i++)
+			routes[i].sink.load(std::memory_order_relaxed)->Wake();
+
+		for (size_t i = 0; i < mWriterThreads.size(); i++) {
+			if (mWriterThreads[i]->joinable() && mWriterThreads[i]->get_id() != std::this_thread::get_id())
+				mWriterThreads[i]->join();
+			delete mWriterThreads[i];
+		}
+		mWriterThreads.clear();
+	}
+
+	//! Constructor
+	FileSink::FileSink() : fileSize(0), indexFd(-1), indexedSize(0), rotateAt(0) { }
+
+	//! Destructor
+	FileSink::~FileSink()
+	{
+		CloseIndex(indexFd);
+	}
+
+	/**
+	 * Sets the log file path, the sink opens the log file on its next batch.
+	 *
+	 * @param	path	The log file path.
+	 */
+	void FileSink::SetPath(const std::string& path)
+	{
+		this->path = path;
+	}
+
+	/**
+	 * Writes a batch of records to the log file, collapsing the repeated records first if enabled.
+	 *
+	 * @param	batch	The batch.
+	 * @param	count	The number of records in the batch.
+	 */
+	void FileSink::Write(std::vector<LogRecord>& batch, size_t count)
+	{
+		// Collapse identical consecutive records into 'last message repeated N times'
+		if (worker.options.repeatFlushMs > 0) {
+			count = repeats.Collapse(batch, count, worker.options.repeatFlushMs, false);
+			if (count == 0)
+				return;
+		}
+		WriteBatch(batch, count);
+	}
+
+	/**
+	 * Writes the 'last message repeated N times' record of the collapsed repeats once due, or when closing.
+	 *
+	 * @param	closing	The writer threads are stopping.
+	 *
+	 * @return	The time in milliseconds until the collapsed repeats are due, negative for none.
+	 */
+	long long FileSink::Flush(bool closing)
+	{
+		if (!repeats.IsPending())
+			return -1;
+
+		long long remaining = repeats.GetRemaining();
+		if (remaining > 0 && !closing)
+			return remaining;
+
+		std::vector<LogRecord> batch;
+		size_t count = repeats.Collapse(batch, 0, worker.options.repeatFlushMs, true);
+		WriteBatch(batch, count);
+		return -1;
+	}
+
+	/**
+	 * Formats a batch and writes it to the log file with a single write and a single flush, opening (and
+	 * rotating) the log file as needed. The records are written to syslog if the log file cannot be written.
+	 *
+	 * @param	batch	The batch.
+	 * @param	count	The number of records in the batch.
+	 */
+	void FileSink::WriteBatch(std::vector<LogRecord>& batch, size_t count)
+	{
+		const LoggerOptions& options = worker.options;
+		FormatBatch(batch, count, options.binaryFormat ? &binary : NULL, buffer);
+
+		// Rotate before the batch that would grow the file beyond rotateSize, or once the interval has elapsed.
+		// Only this sink writes the file, the logging threads keep pushing to the queue meanwhile.
+		bool isOpen = mapped.IsOpen() || uring.IsOpen() || stream.is_open();
+		if (isOpen && fileSize > 0 &&
+			((options.rotateSize > 0 && fileSize + buffer.size() > options.rotateSize) ||
+			(rotateAt > 0 && LoggerUtil::GetTimestamp() >= rotateAt))) {
+			mapped.Close();
+			uring.Close();
+			stream.close();
+			CloseIndex(indexFd);
+			worker.RotateFile(path);
+			isOpen = false;
+		}
+
+		// The sink is chosen when the log file is opened, the memory-mapped and io_uring files fall back to the
+		// stream
+		if (!isOpen) {
+			struct stat st;
+			fileSize = stat(path.c_str(), &st) == 0 ? (size_t) st.st_size : 0;
+			rotateAt = options.rotateIntervalSec > 0 ? NextRotation(options.rotateIntervalSec) : 0;
+
+			// A binary log keeps the NUL bytes left by a killed process, its last entry may end with NUL bytes
+			if (worker.hasMappedFile && !mapped.Open(path, MMAP_EXTENT_SIZE, !options.binaryFormat)) {
+				Logger::SysLogWarn(
+					"FileSink::WriteBatch() failed to map log file (%s), using file stream", path.c_str());
+			} else if (!worker.hasMappedFile && worker.hasUringFile && !uring.Open(path)) {
+				Logger::SysLogWarn(
+					"FileSink::WriteBatch() io_uring is not available (%s), using file stream", path.c_str());
+			}
+			// The size of a mapped file left by a killed process covers its last extent
+			if (mapped.IsOpen())
+				fileSize = mapped.Size();
+
+			// Each opened binary log file starts a new session with its own dictionary
+			if (options.binaryFormat) {
+				binary.Reset();
+				FormatBatch(batch, count, &binary, buffer);
+			}
+
+			// The time index of the text format, restarted along with the log file
+			CloseIndex(indexFd);
+			if (options.indexInterval > 0 && !options.binaryFormat) {
+				indexFd = open(IndexPath(path).c_str(),
+					O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC | (fileSize == 0 ? O_TRUNC : 0), 0644);
+				indexedSize = SIZE_MAX;
+			}
+		}
+
+		bool written = false;
+		if (mapped.IsOpen()) {
+			written = mapped.Write(buffer.data(), buffer.size());
+			if (!written)
+				mapped.Close();
+		} else if (uring.IsOpen()) {
+			// The buffer is copied to a write buffer, the next batch is formatted while the write is in flight
+			written = uring.Write(buffer.data(), buffer.size());
+			if (!written)
+				uring.Close();
+		} else {
+			if (!stream.is_open())
+				stream.open(path, std::ofstream::out | std::ofstream::app | std::ostream::binary);
+
+			if (!stream.bad() && !stream.fail()) {
+				stream.write(buffer.data(), buffer.size());
+				stream.flush();
+				written = true;
+			} else {
+				stream.close();
+			}
+		}
+
+		if (written) {
+			// Sparse time index entry: the oldest time stamp of the batch and the file offset it starts at
+			if (indexFd >= 0 && (indexedSize == SIZE_MAX || fileSize - indexedSize >= options.indexInterval)) {
+				AppendIndex(indexFd, batch, count, fileSize);
+				indexedSize = fileSize;
+			}
+			fileSize += buffer.size();
+		}
+
+		// Write errors to syslog when stream error occurred
+		if (!written) {
+			for (size_t i = 0; i < count; i++) {
+				const char *record = GetLine(batch[i], stringBuffer);
+				if (record != NULL)
+					Logger::SysLogInfo("%s", record);
+			}
+		}
+	}
+
+	/**
+	 * Closes the log file, trimming a memory-mapped file to the written length and completing the io_uring
+	 * writes in flight.
+	 *
+	 * @throw	The logger exception if the file stream cannot be closed.
+	 */
+	void FileSink::Close()
+	{
+		mapped.Close();
+		uring.Close();
+		CloseIndex(indexFd);
 		try {
-			if (dbgLogFileStream.is_open())
-				dbgLogFileStream.close();
+			if (stream.is_open())
+				stream.close();
 		} catch (...) {
 			throw LoggerException(
-				LOGGER_EXCEPTION_EXIT, L"LoggerWorker::DropAll() failed to close debug log file stream");
+				LOGGER_EXCEPTION_EXIT,
+				LoggerUtil::StrFormat(L"FileSink::Close() failed to close log file stream (%s)", path.c_str()));
+		}
+	}
+
+	//! ANSI escape sequence
+	struct AnsiSequence
+	{
+		//! The sequence
+		const char *data;
+		//! Length of the sequence
+		size_t len;
+	};
+
+	// Color prefixes of the console lines per severity level. \033 is the ESC character, it is followed by [, then
+	// numbers separated by ; and finally the letter m. The numbers used are 0 (reset), 1 (bold/bright), 7 (inverse),
+	// and the foreground (background) colors red 31 (41), green 32 (42), yellow 33 (43) and white 37 (47).
+#define ANSI_SEQUENCE(seq) { seq, sizeof(seq) - 1 }
+	static const AnsiSequence consoleColors[SEVERITY_LEVEL_COUNT] = {
+		ANSI_SEQUENCE(""),					// INFO
+		ANSI_SEQUENCE("\033[1;32m"),		// EVENT
+		ANSI_SEQUENCE(""), ANSI_SEQUENCE(""), ANSI_SEQUENCE(""), ANSI_SEQUENCE(""),
+		ANSI_SEQUENCE(""),					// DEBUG
+		ANSI_SEQUENCE("\033[1;33m"),		// WARNING
+		ANSI_SEQUENCE("\033[1;31m"),		// ERROR
+		ANSI_SEQUENCE("\033[1;7;31;47m")	// CRITICAL
+	};
+	static const AnsiSequence consoleReset = ANSI_SEQUENCE("\033[0m");
+#undef ANSI_SEQUENCE
+
+	//! Queue options of the sinks which drop records rather than blocking the logging threads
+	static QueueOptions NonBlockingQueue()
+	{
+		QueueOptions queueOptions;
+		queueOptions.overflow = OVERFLOW_DROP_NEWEST;
+		return queueOptions;
+	}
+
+	//! Constructor
+	ConsoleSink::ConsoleSink() : LogSink(NonBlockingQueue()), isTerminal(false)
+	{
+		DetectTerminal();
+	}
+
+	/**
+	 * Checks whether stdout is a terminal, so that Write() colors the lines without a system call per batch.
+	 * Called again when console logging is enabled, in case stdout was redirected since.
+	 */
+	void ConsoleSink::DetectTerminal()
+	{
+		isTerminal.store(isatty(STDOUT_FILENO) == 1, std::memory_order_relaxed);
+	}
+
+	/**
+	 * Writes a batch of records to stdout with a single write(2). The colors are written to terminals only,
+	 * pipes and files get the plain lines.
+	 *
+	 * @param	batch	The batch.
+	 * @param	count	The number of records in the batch.
+	 */
+	void ConsoleSink::Write(std::vector<LogRecord>& batch, size_t count)
+	{
+		bool terminal = isTerminal.load(std::memory_order_relaxed);
+		buffer.clear();
+		for (size_t i = 0; i < count; i++) {
+			const char *line = GetLine(batch[i], stringBuffer);
+			if (line == NULL)
+				continue;
+
+			const AnsiSequence& color = consoleColors[(size_t) batch[i].level < SEVERITY_LEVEL_COUNT ? batch[i].level : 0];
+			if (terminal && color.len > 0) {
+				buffer.append(color.data, color.len);
+				buffer.append(line);
+				buffer.append(consoleReset.data, consoleReset.len);
+			} else {
+				buffer.append(line);
+			}
+			buffer.push_back('\n');
+		}
+
+		// The lines are lost if stdout is closed, there is nowhere else to write them
+		WriteAll(STDOUT_FILENO, buffer.data(), buffer.size());
+	}
+
+	/**
+	 * Keeps a batch of records, dropping the oldest lines beyond maxLines.
+	 *
+	 * @param	batch	The batch.
+	 * @param	count	The number of records in the batch.
+	 */
+	void MemorySink::Write(std::vector<LogRecord>& batch, size_t count)
+	{
+		std::lock_guard<std::mutex> lock(mtxLines);
+		for (size_t i = 0; i < count; i++) {
+			const char *line = GetLine(batch[i], stringBuffer);
+			if (line == NULL)
+				continue;
+			lines.push_back(line);
+			if (lines.size() > maxLines)
+				lines.pop_front();
+		}
+	}
+
+	/**
+	 * Retrieves the lines kept.
+	 *
+	 * @return	The lines, oldest first.
+	 */
+	std::vector<std::string> MemorySink::GetLines()
+	{
+		std::lock_guard<std::mutex> lock(mtxLines);
+		return std::vector<std::string>(lines.begin(), lines.end());
+	}
+
+	//! Destructor
+	SocketSink::~SocketSink()
+	{
+		Close();
+	}
+
+	/**
+	 * Connects to the socket.
+	 *
+	 * @return	true is returned if the socket is connected. Otherwise, false is returned.
+	 */
+	bool SocketSink::Connect()
+	{
+		Close();
+
+		struct sockaddr_un addr;
+		if (path.size() >= sizeof(addr.sun_path))
+			return false;
+
+		fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+		if (fd < 0)
+			return false;
+
+		memset(&addr, 0, sizeof(addr));
+		addr.sun_family = AF_UNIX;
+		memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+		if (connect(fd, (struct sockaddr *) &addr, sizeof(addr)) != 0) {
+			Close();
+			return false;
+		}
+		return true;
+	}
+
+	/**
+	 * Writes a batch of records to the socket, reconnecting once if the peer has gone away.
+	 *
+	 * @param	batch	The batch.
+	 * @param	count	The number of records in the batch.
+	 */
+	void SocketSink::Write(std::vector<LogRecord>& batch, size_t count)
+	{
+		buffer.clear();
+		for (size_t i = 0; i < count; i++) {
+			const char *line = GetLine(batch[i], stringBuffer);
+			if (line == NULL)
+				continue;
+			buffer.append(line);
+			buffer.push_back('\n');
+		}
+
+		for (int attempt = 0; attempt < 2; attempt++) {
+			if (fd < 0 && !Connect())
+				return;
+
+			size_t done = 0;
+			while (done < buffer.size()) {
+				ssize_t n = send(fd, buffer.data() + done, buffer.size() - done, MSG_NOSIGNAL);
+				if (n < 0 && errno == EINTR)
+					continue;
+				if (n <= 0)
+					break;
+				done += (size_t) n;
+			}
+			if (done == buffer.size())
+				return;
+
+			// A partly written batch is not resent, the peer would get the first lines twice
+			Close();
+			if (done > 0)
+				return;
+		}
+	}
+
+	//! Close the socket
+	void SocketSink::Close()
+	{
+		if (fd >= 0) {
+			close(fd);
+			fd = -1;
+		}
+	}
+
+	//! Constructor
+	MappedFile::MappedFile() : fd(-1), base(NULL), mapOffset(0), mapLength(0), tail(0), extentSize(0) { }
+
+	//! Destructor
+	MappedFile::~MappedFile()
+	{
+		Close();
+	}
+
+	/**
+	 * Opens (or creates) the file for appending through memory-mapped extents.
+	 *
+	 * @param	path		The file path.
+	 * @param	extentSize	The size of the extents preallocated and mapped at a time (rounded up to pages).
+	 * @param	trimNul		Append after the last non-NUL byte, overwriting the NUL filled rest of the last extent
+	 *						left by a killed process (text files, whose lines end with a newline).
+	 *
+	 * @return	true is returned if the file is opened and mapped. Otherwise, false is returned.
+	 */
+	bool MappedFile::Open(const std::string& path, size_t extentSize, bool trimNul)
+	{
+		Close();
+
+		fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+		if (fd < 0)
+			return false;
+
+		struct stat st;
+		if (fstat(fd, &st) != 0) {
+			Close();
+			return false;
+		}
+
+		size_t pageSize = (size_t) sysconf(_SC_PAGESIZE);
+		this->extentSize = (extentSize + pageSize - 1) / pageSize * pageSize;
+		tail = (size_t) st.st_size;
+
+		// The file size covers whole extents until Close(), scan back to the written data
+		char chunk[4096];
+		while (trimNul && tail > 0) {
+			size_t n = std::min(tail, sizeof(chunk));
+			if (pread(fd, chunk, n, (off_t) (tail - n)) != (ssize_t) n) {
+				Close();
+				return false;
+			}
+			size_t len = n;
+			while (len > 0 && chunk[len - 1] == '\0')
+				len--;
+			tail -= n - len;
+			if (len > 0)
+				break;
+		}
+
+		if (!Map(tail)) {
+			Close();
+			return false;
+		}
+		return true;
+	}
+
+	/**
+	 * Preallocates the extent that contains the file offset and maps it, unmapping the current extent.
+	 *
+	 * @param	offset	The file offset.
+	 *
+	 * @return	true is returned if the extent is mapped. Otherwise, false is returned.
+	 */
+	bool MappedFile::Map(size_t offset)
+	{
+		if (base != NULL) {
+			munmap(base, mapLength);
+			base = NULL;
+		}
+
+		size_t pageSize = (size_t) sysconf(_SC_PAGESIZE);
+		size_t alignedOffset = offset / pageSize * pageSize;
+
+		// Allocate the blocks (and the file size) once per extent, so that a full disk fails here instead of raising
+		// SIGBUS on a store. posix_fallocate() writes to every block where the file system lacks fallocate().
+		int ret = fallocate(fd, 0, (off_t) alignedOffset, (off_t) extentSize);
+		if (ret != 0 && (errno == EOPNOTSUPP || errno == ENOSYS))
+			ret = posix_fallocate(fd, (off_t) alignedOffset, (off_t) extentSize);
+		if (ret != 0)
+			return false;
+
+		void *addr = mmap(NULL, extentSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, (off_t) alignedOffset);
+		if (addr == MAP_FAILED)
+			return false;
+
+		base = (char *) addr;
+		mapOffset = alignedOffset;
+		mapLength = extentSize;
+		return true;
+	}
+
+	/**
+	 * Copies data to the mapped region at the tail and advances the tail, mapping the next extent when the
+	 * current one is full.
+	 *
+	 * @param	data	Pointer to the data.
+	 * @param	len		The size of the data.
+	 *
+	 * @return	true is returned if all the data is written. Otherwise, false is returned.
+	 */
+	bool MappedFile::Write(const char *data, size_t len)
+	{
+		if (base == NULL)
+			return false;
+
+		while (len > 0) {
+			if (tail >= mapOffset + mapLength && !Map(tail))
+				return false;
+
+			size_t n = std::min(len, mapOffset + mapLength - tail);
+			memcpy(base + (tail - mapOffset), data, n);
+			tail += n;
+			data += n;
+			len -= n;
+		}
+		return true;
+	}
+
+	/**
+	 * Unmaps the file and trims it to the written length (the preallocated tail is released).
+	 */
+	void MappedFile::Close()
+	{
+		if (base != NULL) {
+			munmap(base, mapLength);
+			base = NULL;
+		}
+
+		if (fd >= 0) {
+			if (ftruncate(fd, (off_t) tail) != 0)
+				syslog(LOG_ERR, "MappedFile::Close() failed to trim log file (%s)", strerror(errno));
+			close(fd);
+			fd = -1;
+		}
+		mapOffset = 0;
+		mapLength = 0;
+		tail = 0;
+	}
+
+	//! Constructor
+	UringFile::UringFile()
+		: fd(-1), ringFd(-1), tail(0), failed(false), fixedBuffers(false), sqRing(NULL), sqRingSize(0), cqRing(NULL),
+		cqRingSize(0), sqes(NULL), sqesSize(0), sqTail(NULL), sqMask(NULL), sqArray(NULL), cqHead(NULL), cqTail(NULL),
+		cqMask(NULL), cqes(NULL)
+	{
+		memset(buffers, 0, sizeof(buffers));
+	}
+
+	//! Destructor
+	UringFile::~UringFile()
+	{
+		Close();
+	}
+
+	/**
+	 * Opens (or creates) the file for appending, sets up the io_uring instance and registers the write buffers.
+	 *
+	 * @param	path	The file path.
+	 *
+	 * @return	true is returned if the file is opened. Otherwise (e.g. io_uring is not supported by the kernel),
+	 *			false is returned.
+	 */
+	bool UringFile::Open(const std::string& path)
+	{
+#ifdef CPPLOGGER_HAVE_IO_URING
+		Close();
+
+		fd = open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+		if (fd < 0)
+			return false;
+
+		struct stat st;
+		if (fstat(fd, &st) != 0) {
+			Close();
+			return false;
+		}
+		tail = (size_t) st.st_size;
+
+		io_uring_params params;
+		memset(&params, 0, sizeof(params));
+		int ret = (int) syscall(__NR_io_uring_setup, URING_BUFFER_COUNT, &params);
+		if (ret < 0) {
+			Close();
+			return false;
+		}
+		ringFd = ret;
+
+		// Map the submission/completion queue rings and the submission queue entries
+		sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+		cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+		if (params.features & IORING_FEAT_SINGLE_MMAP)
+			sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+		sqRing = mmap(NULL, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+		if (sqRing == MAP_FAILED) {
+			sqRing = NULL;
+			Close();
+			return false;
+		}
+		if (params.features & IORING_FEAT_SINGLE_MMAP) {
+			cqRing = sqRing;
+		} else {
+			cqRing = mmap(
+				NULL, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_CQ_RING);
+			if (cqRing == MAP_FAILED) {
+				cqRing = NULL;
+				Close();
+				return false;
+			}
+		}
+		sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+		sqes = mmap(NULL, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES);
+		if (sqes == MAP_FAILED) {
+			sqes = NULL;
+			Close();
+			return false;
+		}
+
+		char *sq = (char *) sqRing;
+		char *cq = (char *) cqRing;
+		sqTail = (unsigned int *) (sq + params.sq_off.tail);
+		sqMask = (unsigned int *) (sq + params.sq_off.ring_mask);
+		sqArray = (unsigned int *) (sq + params.sq_off.array);
+		cqHead = (unsigned int *) (cq + params.cq_off.head);
+		cqTail = (unsigned int *) (cq + params.cq_off.tail);
+		cqMask = (unsigned int *) (cq + params.cq_off.ring_mask);
+		cqes = cq + params.cq_off.cqes;
+
+		// Allocate and register the write buffers, plain writes are used if registration is not permitted
+		iovec iov[URING_BUFFER_COUNT];
+		for (int i = 0; i < URING_BUFFER_COUNT; i++) {
+			void *data = NULL;
+			if (posix_memalign(&data, 4096, URING_BUFFER_SIZE) != 0) {
+				Close();
+				return false;
+			}
+			buffers[i].data = (char *) data;
+			buffers[i].inFlight = false;
+			iov[i].iov_base = data;
+			iov[i].iov_len = URING_BUFFER_SIZE;
+		}
+		fixedBuffers =
+			syscall(__NR_io_uring_register, ringFd, IORING_REGISTER_BUFFERS, iov, URING_BUFFER_COUNT) == 0;
+		failed = false;
+		return true;
+#else
+		(void) path;
+		return false;
+#endif
+	}
+
+	/**
+	 * Submits the (remaining) write of a buffer at its file offset.
+	 *
+	 * @param	index	The buffer index.
+	 *
+	 * @return	true is returned if the write is submitted. Otherwise, false is returned.
+	 */
+	bool UringFile::Submit(int index)
+	{
+#ifdef CPPLOGGER_HAVE_IO_URING
+		Buffer& buffer = buffers[index];
+		unsigned int sqIndex = *sqTail & *sqMask;
+		io_uring_sqe *sqe = (io_uring_sqe *) sqes + sqIndex;
+		memset(sqe, 0, sizeof(*sqe));
+		sqe->opcode = fixedBuffers ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+		sqe->fd = fd;
+		sqe->addr = (unsigned long long) (uintptr_t) (buffer.data + buffer.done);
+		sqe->len = (unsigned int) (buffer.len - buffer.done);
+		sqe->off = buffer.offset + buffer.done;
+		sqe->buf_index = (unsigned short) index;
+		sqe->user_data = (unsigned long long) index;
+		sqArray[sqIndex] = sqIndex;
+
+		// Only this thread submits, publish the entry before the kernel reads the tail
+		__atomic_store_n(sqTail, *sqTail + 1, __ATOMIC_RELEASE);
+		buffer.inFlight = true;
+
+		int ret;
+		do {
+			ret = (int) syscall(__NR_io_uring_enter, ringFd, 1, 0, 0, NULL, 0);
+		} while (ret < 0 && errno == EINTR);
+		return ret >= 0;
+#else
+		(void) index;
+		return false;
+#endif
+	}
+
+	/**
+	 * Processes the completed writes, resubmitting short writes. A failed write is reported to syslog and
+	 * fails the following Write() calls.
+	 *
+	 * @param	wait	true to wait for at least one completion.
+	 */
+	void UringFile::Reap(bool wait)
+	{
+#ifdef CPPLOGGER_HAVE_IO_URING
+		if (wait) {
+			int ret;
+			do {
+				ret = (int) syscall(__NR_io_uring_enter, ringFd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+			} while (ret < 0 && errno == EINTR);
+			if (ret < 0) {
+				failed = true;
+				for (int i = 0; i < URING_BUFFER_COUNT; i++)
+					buffers[i].inFlight = false;
+				return;
+			}
+		}
+
+		unsigned int head = *cqHead;
+		while (head != __atomic_load_n(cqTail, __ATOMIC_ACQUIRE)) {
+			io_uring_cqe *cqe = (io_uring_cqe *) cqes + (head & *cqMask);
+			Buffer& buffer = buffers[cqe->user_data];
+			int res = cqe->res;
+			head++;
+			__atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+
+			buffer.inFlight = false;
+			if (res == -EAGAIN || res == -EINTR) {
+				if (!Submit((int) cqe->user_data))
+					failed = true;
+			} else if (res <= 0) {
+				syslog(LOG_ERR, "UringFile::Reap() failed to write log file (%s)", strerror(res < 0 ? -res : EIO));
+				failed = true;
+			} else {
+				buffer.done += (size_t) res;
+				if (buffer.done < buffer.len && !Submit((int) cqe->user_data))
+					failed = true;
+			}
+		}
+#else
+		(void) wait;
+#endif
+	}
+
+	/**
+	 * Copies data to free write buffers and submits them at the tail offset, without waiting for the writes
+	 * unless every buffer is in flight.
+	 *
+	 * @param	data	Pointer to the data.
+	 * @param	len		The size of the data.
+	 *
+	 * @return	true is returned if the data is submitted (and no earlier write has failed). Otherwise, false is
+	 *			returned.
+	 */
+	bool UringFile::Write(const char *data, size_t len)
+	{
+		if (ringFd < 0 || failed)
+			return false;
+
+		Reap(false);
+		while (len > 0 && !failed) {
+			int index = -1;
+			for (int i = 0; i < URING_BUFFER_COUNT && index < 0; i++) {
+				if (!buffers[i].inFlight)
+					index = i;
+			}
+			if (index < 0) {
+				Reap(true);
+				continue;
+			}
+
+			Buffer& buffer = buffers[index];
+			size_t n = std::min(len, (size_t) URING_BUFFER_SIZE);
+			memcpy(buffer.data, data, n);
+			buffer.offset = tail;
+			buffer.len = n;
+			buffer.done = 0;
+			if (!Submit(index)) {
+				buffer.inFlight = false;
+				failed = true;
+				break;
+			}
+			tail += n;
+			data += n;
+			len -= n;
 		}
+		return !failed;
+	}
 
-		try {
-			if (evntLogFileStream.is_open())
-				evntLogFileStream.close();
-		} catch (...) {
-			throw LoggerException(
-				LOGGER_EXCEPTION_EXIT, L"LoggerWorker::DropAll() failed to close event log file stream");
+	/**
+	 * Waits for the writes in flight.
+	 */
+	void UringFile::Flush()
+	{
+		if (ringFd < 0)
+			return;
+
+		for (;;) {
+			bool inFlight = false;
+			for (int i = 0; i < URING_BUFFER_COUNT; i++)
+				inFlight = inFlight || buffers[i].inFlight;
+			if (!inFlight)
+				break;
+			Reap(true);
+		}
+	}
+
+	/**
+	 * Waits for the writes in flight, releases the io_uring instance and closes the file.
+	 */
+	void UringFile::Close()
+	{
+		Flush();
+		if (sqes != NULL)
+			munmap(sqes, sqesSize);
+		if (cqRing != NULL && cqRing != sqRing)
+			munmap(cqRing, cqRingSize);
+		if (sqRing != NULL)
+			munmap(sqRing, sqRingSize);
+		sqes = sqRing = cqRing = NULL;
+
+		if (ringFd >= 0) {
+			close(ringFd);
+			ringFd = -1;
+		}
+		for (int i = 0; i < URING_BUFFER_COUNT; i++) {
+			free(buffers[i].data);
+			buffers[i].data = NULL;
+			buffers[i].inFlight = false;
+		}
+		if (fd >= 0) {
+			close(fd);
+			fd = -1;
+		}
+		tail = 0;
+		fixedBuffers = false;
+	}
+
+	/**
+	 * Connects to the syslog daemon.
+	 *
+	 * @param	path	The socket path.
+	 *
+	 * @return	true is returned if the socket is connected. Otherwise, false is returned.
+	 */
+	bool SysLogSocket::Open(const std::string& path)
+	{
+		Close();
+
+		struct sockaddr_un addr;
+		if (path.size() >= sizeof(addr.sun_path))
+			return false;
+
+		fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+		if (fd < 0)
+			return false;
+
+		memset(&addr, 0, sizeof(addr));
+		addr.sun_family = AF_UNIX;
+		memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+		if (connect(fd, (struct sockaddr *) &addr, sizeof(addr)) != 0) {
+			Close();
+			return false;
+		}
+
+		this->path = path;
+		return true;
+	}
+
+	/**
+	 * Sends a batch of datagrams (the text of the records) with sendmmsg(). The socket is (re)connected when it
+	 * is closed, the path has changed or a send fails, as the daemon may have restarted; a datagram too large for
+	 * the socket is skipped.
+	 *
+	 * @param	records	The records.
+	 * @param	count	The number of records.
+	 * @param	path	The socket path.
+	 *
+	 * @return	true is returned if the datagrams are sent. Otherwise, false is returned.
+	 */
+	bool SysLogSocket::Send(const LogRecord *records, size_t count, const std::string& path)
+	{
+		if (fd >= 0 && path != this->path)
+			Close();
+
+		for (int attempt = 0; attempt < 2 && count > 0; attempt++) {
+			if (fd < 0 && !Open(path))
+				return false;
+
+			if (headers.size() < count) {
+				headers.resize(count);
+				iovecs.resize(count);
+			}
+			for (size_t i = 0; i < count; i++) {
+				iovecs[i].iov_base = (void *) records[i].text.data();
+				iovecs[i].iov_len = records[i].text.size();
+				memset(&headers[i], 0, sizeof(headers[i]));
+				headers[i].msg_hdr.msg_iov = &iovecs[i];
+				headers[i].msg_hdr.msg_iovlen = 1;
+			}
+
+			size_t sent = 0;
+			while (sent < count) {
+				int n = sendmmsg(fd, &headers[sent], (unsigned int) (count - sent), MSG_NOSIGNAL);
+				if (n < 0 && errno == EINTR)
+					continue;
+				if (n < 0 && errno == EMSGSIZE) {
+					sent++;
+					continue;
+				}
+				if (n <= 0)
+					break;
+				sent += (size_t) n;
+			}
+			if (sent == count)
+				return true;
+
+			// Reconnect and send the rest once more
+			records += sent;
+			count -= sent;
+			Close();
+		}
+		return count == 0;
+	}
+
+	//! Close the socket
+	void SysLogSocket::Close()
+	{
+		if (fd >= 0) {
+			close(fd);
+			fd = -1;
+		}
+	}
+
+	/**
+	 * Maps a syslog priority to the log severity level its dropped records are counted as.
+	 *
+	 * @param	priority	The syslog priority.
+	 *
+	 * @return	The log severity level.
+	 */
+	static SeverityLevel SysLogSeverity(int priority)
+	{
+		switch (priority & LOG_PRIMASK) {
+			case LOG_EMERG:
+			case LOG_ALERT:
+			case LOG_CRIT:
+			return CRITICAL;
+			case LOG_ERR:
+			return ERROR;
+			case LOG_WARNING:
+			return WARNING;
+			case LOG_DEBUG:
+			return DEBUG;
+			default:
+			return INFO;
+		}
+	}
+
+	/**
+	 * Gets the host name of the RFC 5424 datagrams.
+	 *
+	 * @return	The host name, '-' if it is not available.
+	 */
+	static std::string GetHostName()
+	{
+		char name[256];
+		if (gethostname(name, sizeof(name)) != 0 || name[0] == '\0')
+			return "-";
+		name[sizeof(name) - 1] = '\0';
+		return name;
+	}
+
+	/**
+	 * Builds a syslog datagram in the format of the options (RFC 3164 as syslog(3) sends it to '/dev/log', or
+	 * RFC 5424).
+	 *
+	 * @param	dst			The datagram.
+	 * @param	priority	The syslog priority (LOG_ERR, ...), combined with the facility of the options.
+	 * @param	msg			The (UTF-8) message.
+	 * @param	len			The length of the message.
+	 */
+	static void MakeSysLogDatagram(std::string& dst, int priority, const char *msg, size_t len)
+	{
+		static const std::string hostname = GetHostName();
+		const LoggerOptions& options = worker.options;
+		const char *ident = options.sysLogIdent.empty() ? program_invocation_short_name : options.sysLogIdent.c_str();
+		int pri = (options.sysLogFacility & LOG_FACMASK) | (priority & LOG_PRIMASK);
+
+		struct timespec ts;
+		struct tm tm;
+		clock_gettime(CLOCK_REALTIME, &ts);
+		localtime_r(&ts.tv_sec, &tm);
+
+		char time[64];
+		char header[MAX_LEN_DATE_BUFFER + 512];
+		int n;
+		if (options.sysLogFormat == SYSLOG_RFC5424) {
+			long offset = tm.tm_gmtoff < 0 ? -tm.tm_gmtoff : tm.tm_gmtoff;
+			strftime(time, sizeof(time), "%Y-%m-%dT%H:%M:%S", &tm);
+			n = snprintf(header, sizeof(header), "<%d>1 %s.%06ld%c%02ld:%02ld %s %s %d - - ", pri, time,
+				ts.tv_nsec / 1000, tm.tm_gmtoff < 0 ? '-' : '+', offset / 3600, offset % 3600 / 60, hostname.c_str(),
+				ident, (int) getpid());
+		} else {
+			strftime(time, sizeof(time), "%b %e %H:%M:%S", &tm);
+			n = snprintf(header, sizeof(header), "<%d>%s %s[%d]: ", pri, time, ident, (int) getpid());
+		}
+
+		dst.assign(header, n > 0 ? std::min((size_t) n, sizeof(header) - 1) : 0);
+		dst.append(msg, len);
+	}
+
+	/**
+	 * Maps a log severity level to the syslog priority of its datagrams.
+	 *
+	 * @param	level	The log severity level.
+	 *
+	 * @return	The syslog priority.
+	 */
+	static int SysLogPriority(SeverityLevel level)
+	{
+		switch (level) {
+			case CRITICAL:
+			return LOG_CRIT;
+			case ERROR:
+			return LOG_ERR;
+			case WARNING:
+			return LOG_WARNING;
+			case DEBUG:
+			return LOG_DEBUG;
+			case EVENT:
+			return LOG_NOTICE;
+			default:
+			return LOG_INFO;
+		}
+	}
+
+	//! Constructor
+	SysLogSink::SysLogSink() : LogSink(NonBlockingQueue()) { }
+
+	/**
+	 * Sends a batch of records to the syslog daemon, a single sendmmsg() per batch.
+	 *
+	 * @param	batch	The batch.
+	 * @param	count	The number of records in the batch.
+	 */
+	void SysLogSink::Write(std::vector<LogRecord>& batch, size_t count)
+	{
+		if (datagrams.size() < count)
+			datagrams.resize(count);
+
+		size_t n = 0;
+		for (size_t i = 0; i < count; i++) {
+			const char *line = GetLine(batch[i], stringBuffer);
+			if (line != NULL)
+				MakeSysLogDatagram(datagrams[n++].text, SysLogPriority(batch[i].level), line, strlen(line));
+		}
+		socket.Send(datagrams.data(), n, worker.options.sysLogPath);
+	}
+
+	/**
+	 * Sends a record to the syslog daemon right away, while the writer threads are not running.
+	 *
+	 * @param	record	The record.
+	 */
+	void SysLogSink::Send(const LogRecord& record)
+	{
+		std::vector<LogRecord> batch(1, record);
+		Write(batch, 1);
+	}
+
+	//! Close the socket
+	void SysLogSink::Close()
+	{
+		socket.Close();
+	}
+
+	/**
+	 * Sends a message to syslog. While the writer threads are running (between Init() and DropAll()) the message
+	 * is pushed to the queue of the syslog sink, and dropped (and counted) if the queue is full; otherwise it is
+	 * sent on the calling thread.
+	 *
+	 * @param	priority	The syslog priority (LOG_ERR, ...).
+	 * @param	msg			The (UTF-8) message.
+	 * @param	len			The length of the message.
+	 */
+	void LoggerWorker::OutputSysLogLine(int priority, const char *msg, size_t len)
+	{
+		static thread_local LogRecord record;
+		record.level = SysLogSeverity(priority);
+		record.code = 0;
+		record.text.assign(msg, len);
+
+		if (hasWriterThreads) {
+			Enqueue(sysLogSink, record);
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(sysLogSink.mtx);
+		sysLogSink.Send(record);
+	}
+
+	/**
+	 * Starts the TSC calibration thread, which recalibrates the TSC clock every TSC_CALIBRATION_MS.
+	 */
+	void LoggerWorker::StartTscCalibration()
+	{
+		if (mTscThread != 0)
+			return;
+
+		isInterruptedTscCalibration = false;
+		mTscThread = new std::thread(&LoggerWorker::CalibrateTsc, this);
+	}
+
+	/**
+	 * Stops the TSC calibration thread.
+	 */
+	void LoggerWorker::StopTscCalibration()
+	{
+		if (mTscThread == 0)
+			return;
+
+		{
+			std::lock_guard<std::mutex> lock(mtxTscCalibration);
+			isInterruptedTscCalibration = true;
+		}
+		condTscCalibration.notify_one();
+		if (mTscThread->joinable() && mTscThread->get_id() != std::this_thread::get_id())
+			mTscThread->join();
+		delete mTscThread;
+		mTscThread = 0;
+	}
+
+	/**
+	 * Recalibrates the TSC clock every TSC_CALIBRATION_MS until StopTscCalibration() is called.
+	 */
+	void LoggerWorker::CalibrateTsc()
+	{
+		SetUpThread("tsc", false);
+		std::unique_lock<std::mutex> lock(mtxTscCalibration);
+		while (!isInterruptedTscCalibration) {
+			condTscCalibration.wait_for(lock, milliseconds(TSC_CALIBRATION_MS));
+			if (!isInterruptedTscCalibration)
+				TscClock::Calibrate();
+		}
+	}
+
+	/**
+	 * Release and close all loggers
+	 *
+	 * @throw	The logger exception with exception details.
+	 */
+	void LoggerWorker::DropAll()
+	{
+		// Wait for the writer threads to drain the queues of the sinks
+		StopWriters();
+		StopTscCalibration();
+
+		// Stop the compression thread, an interrupted compression is redone by the next Init()
+		if (mCompressThread != 0) {
+			{
+				std::lock_guard<std::mutex> lock(mtxRotation);
+				isInterruptedCompression = true;
+			}
+			condCompression.notify_one();
+			if (mCompressThread->joinable() && mCompressThread->get_id() != std::this_thread::get_id())
+				mCompressThread->join();
+			delete mCompressThread;
+			mCompressThread = 0;
+		}
+
+		// Trim the memory-mapped log files to the written length, complete the io_uring writes in flight
+		size_t count = routeCount.load(std::memory_order_acquire);
+		for (size_t i = 0; i < count; i++) {
+			LogSink *sink = routes[i].sink.load(std::memory_order_relaxed);
+			try {
+				std::lock_guard<std::mutex> lock(sink->mtx);
+				sink->Close();
+			} catch (...) {
+				throw LoggerException(LOGGER_EXCEPTION_EXIT, L"LoggerWorker::DropAll() failed to close a log sink");
+			}
 		}
 
 		// Disable all logging operations
@@ -510,115 +4381,275 @@ namespace cpplogger {
 		hasDbgLog = false;
 		hasEvntLog = false;
 		hasConsoleLogging = false;
+		SetRouteLevels(&consoleSink, 0);
+	}
+
+	//! Destructor
+	LoggerWorker::~LoggerWorker()
+	{
+		try {
+			DropAll();
+		} catch (LoggerException& le) {
+			std::cout << "LoggerWorker::~LoggerWorker() error closing stream (" << le.GetMsg() << ")" << std::endl;
+			syslog(
+				LOG_ERR, "LoggerWorker::~LoggerWorker() error closing stream (%s)", le.GetMsg());
+		}
+	}
+
+	//! Constructor
+	Logger::Logger() { }
+
+	/**
+	 * Pushes the log record to the log queue of its severity level.
+	 *
+	 * @param	record	The log record.
+	 */
+	static void OutputRecord(const LogRecord& record)
+	{
+		switch (record.level) {
+			case CRITICAL:
+			case ERROR:
+			case INFO:
+			case WARNING:
+			worker.OutputAplLine(record);
+			break;
+			case DEBUG:
+			worker.OutputDbgLine(record);
+			break;
+			case EVENT:
+			worker.OutputEvntLine(record);
+			break;
+			default:
+			break;
+		}
+	}
+
+	/**
+	 * Stamps a deferred log record with the time stamp counter (if enabled) or the wall clock.
+	 *
+	 * @param	record	The log record.
+	 */
+	static void StampRecord(LogRecord& record)
+	{
+		if (worker.hasTscClock) {
+			record.timestamp = (long long) TscClock::Read();
+			record.tscTimestamp = true;
+		} else {
+			record.timestamp = LoggerUtil::GetTimestamp(worker.hasCoarseClock);
+			record.tscTimestamp = false;
+		}
+	}
+
+	/**
+	 * Completes the log record with the formatted (UTF-8) message and pushes it to the respective log queue.
+	 *
+	 * @param	record	The log record with the level and code set.
+	 * @param	msg		The formatted log message.
+	 * @param	msgLen	The length of the log message.
+	 */
+	static void OutputMessage(LogRecord& record, const char *msg, size_t msgLen)
+	{
+		char time[MAX_LEN_DATE_BUFFER];
+		record.timestamp = LoggerUtil::GetTimestamp(worker.hasCoarseClock);
+		record.tscTimestamp = false;
+		LoggerUtil::GetTimeString(time, record.timestamp, worker.timestampFormat);
+
+		record.format = NULL;
+		record.narrowFormat = NULL;
+		record.args.clear();
+		record.text.clear();
+		if (!LoggerUtil::FormatLine(record.text, record.level, record.code, time, msg, msgLen))
+			return;
+
+		OutputRecord(record);
+	}
+
+	/*
+	 * Write the formatted log record to the respective log queue.
+	 *
+	 * @param	level	The log severity level
+	 * @param	code	The 5 digit custom defined code to each record.
+	 * @param	format	C string that contains a format string that follows the same specifications as format in
+	 *					printf (see printf for details)
+	 * @param	args	The variable argument list (va_list)
+	 */
+	void Logger::WriteLog(SeverityLevel level, unsigned long code, const wchar_t* format, va_list args)
+	{
+		if (!IsRateAllowed(level, code, format))
+			return;
+
+		// Reused per thread, so that the record buffers are allocated once
+		static thread_local LogRecord record;
+		record.level = level;
+		record.code = code;
+
+		if (worker.hasDeferredFormatting) {
+			// Capture the time stamp and the arguments only, the write thread formats the record
+			StampRecord(record);
+			record.format = format;
+			record.narrowFormat = NULL;
+			LoggerUtil::EncodeArgs(format, args, record.args);
+			record.text.clear();
+			OutputRecord(record);
+			return;
+		}
+
+		wchar_t formatBuffer[MAX_LEN_FMT_BUFFER];
+		int ret = vswprintf(formatBuffer, MAX_LEN_FMT_BUFFER, format, args);
+		if (ret == -1)
+			return;
+
+		// Convert the message to UTF-8 once, everything downstream is narrow
+		static thread_local std::string message;
+		message.clear();
+		LoggerUtil::ToUtf8(formatBuffer, ret, message);
+		OutputMessage(record, message.data(), message.size());
+	}
+
+	/*
+	 * Write the formatted (UTF-8) log record to the respective log queue.
+	 *
+	 * @param	level	The log severity level
+	 * @param	code	The 5 digit custom defined code to each record.
+	 * @param	format	UTF-8 C string that contains a format string that follows the same specifications as format
+	 *					in printf (see printf for details)
+	 * @param	args	The variable argument list (va_list)
+	 */
+	void Logger::WriteLog(SeverityLevel level, unsigned long code, const char* format, va_list args)
+	{
+		if (!IsRateAllowed(level, code, format))
+			return;
+
+		// Reused per thread, so that the record buffers are allocated once
+		static thread_local LogRecord record;
+		record.level = level;
+		record.code = code;
+
+		if (worker.hasDeferredFormatting) {
+			// Capture the time stamp and the arguments only, the write thread formats the record
+			StampRecord(record);
+			record.format = NULL;
+			record.narrowFormat = format;
+			LoggerUtil::EncodeArgs(format, args, record.args);
+			record.text.clear();
+			OutputRecord(record);
+			return;
+		}
+
+		char formatBuffer[MAX_LEN_FMT_BUFFER];
+		int ret = vsnprintf(formatBuffer, MAX_LEN_FMT_BUFFER, format, args);
+		if (ret < 0)
+			return;
+
+		// Truncate to the buffer size, as the wide version does
+		if (ret >= MAX_LEN_FMT_BUFFER)
+			ret = MAX_LEN_FMT_BUFFER - 1;
+		OutputMessage(record, formatBuffer, ret);
+	}
+
+	/*
+	 * Write a log message formatted by the type-safe interfaces to the respective log queue.
+	 *
+	 * @param	level	The log severity level
+	 * @param	code	The 5 digit custom defined code to each record.
+	 * @param	msg		The formatted (UTF-8) log message.
+	 */
+	void Logger::WriteMessage(SeverityLevel level, unsigned long code, const char *msg)
+	{
+		static thread_local LogRecord record;
+		record.level = level;
+		record.code = code;
+		OutputMessage(record, msg, strlen(msg));
+	}
+
+	/**
+	 * Checks the rate limit of a log record before it is formatted, and writes the summary of the records of its
+	 * code (or call site) suppressed by the limit when it is due.
+	 *
+	 * @param	level		The log severity level.
+	 * @param	code		The code.
+	 * @param	callSite	The call site (format string).
+	 *
+	 * @return	true is returned if the record may be written. Otherwise, false is returned.
+	 */
+	bool Logger::IsRateAllowed(SeverityLevel level, unsigned long code, const void *callSite)
+	{
+		if (!worker.rateLimiter.IsEnabled())
+			return true;
+
+		unsigned long suppressed;
+		bool allowed = worker.rateLimiter.Allow(level, code, callSite, suppressed);
+		if (suppressed > 0)
+			WriteSuppressed(level, code, suppressed);
+		return allowed;
 	}
 
-	//! Destructor
-	LoggerWorker::~LoggerWorker()
+	/*
+	 * Write the summary of the records suppressed by a rate limit, e.g. 'suppressed 120 occurrences of E800002',
+	 * with the level and code of the records.
+	 *
+	 * @param	level		The log severity level
+	 * @param	code		The code.
+	 * @param	suppressed	The number of suppressed records.
+	 */
+	void Logger::WriteSuppressed(SeverityLevel level, unsigned long code, unsigned long suppressed)
 	{
-		try {
-			DropAll();
-		} catch (LoggerException& le) {
-			std::cout << "LoggerWorker::~LoggerWorker() error closing stream (" << le.GetMsg() << ")" << std::endl;
-			syslog(
-				LOG_ERR, "LoggerWorker::~LoggerWorker() error closing stream (%s)", le.GetMsg());
-		}
-	}
+		static const char *prefixes[SEVERITY_LEVEL_COUNT] = {
+			"I0", "EVENT", NULL, NULL, NULL, NULL, "DEBUG", "W7", "E8", "C9" };
 
-	//! Constructor
-	Logger::Logger() { }
+		char msg[MAX_LEN_FMT_BUFFER];
+		const char *prefix = (size_t) level < SEVERITY_LEVEL_COUNT ? prefixes[level] : NULL;
+		if (prefix == NULL)
+			return;
+		if (level == DEBUG || level == EVENT)
+			snprintf(msg, sizeof(msg), "suppressed %lu occurrences of %s records", suppressed, prefix);
+		else
+			snprintf(msg, sizeof(msg), "suppressed %lu occurrences of %s%05lu", suppressed, prefix, code);
+
+		LogRecord record;
+		record.level = level;
+		record.code = code;
+		OutputMessage(record, msg, strlen(msg));
+	}
 
 	/*
-	 * Write the formatted log record to the respective log queue.
+	 * Write the formatted log record to syslog (/var/log/messages).
 	 *
-	 * @param	level	The log severity level
-	 * @param	code	The 5 digit custom defined code to each record.
+	 * @param	level	The log level
 	 * @param	format	C string that contains a format string that follows the same specifications as format in
 	 *					printf (see printf for details)
 	 * @param	args	The variable argument list (va_list)
 	 */
-	void Logger::WriteLog(SeverityLevel level, unsigned long code, const wchar_t* format, va_list args)
+	void Logger::WriteSysLog(int level, const wchar_t* format, va_list args)
 	{
-		wchar_t time[MAX_LEN_DATE_BUFFER];
 		wchar_t formatBuffer[MAX_LEN_FMT_BUFFER];
-		wchar_t stringBuffer[MAX_LEN_STR_BUFFER];
-		memset(formatBuffer, 0, sizeof(formatBuffer));
-		memset(stringBuffer, 0, sizeof(stringBuffer));
-		LoggerUtil::GetTimeString(time);
-		
 		int ret = vswprintf(formatBuffer, MAX_LEN_FMT_BUFFER, format, args);
 
-		if (ret != -1) {
-			ret = 0;
-			switch (level) {
-				case CRITICAL:
-				ret = swprintf(stringBuffer, MAX_LEN_STR_BUFFER, L"%S [CRIT]: C9%05lu, %S", time, code, formatBuffer);
-				break;
-				case ERROR:
-				ret = swprintf(stringBuffer, MAX_LEN_STR_BUFFER, L"%S [ERR ]: E8%05lu, %S", time, code, formatBuffer);
-				break;
-				case INFO:
-				ret = swprintf(stringBuffer, MAX_LEN_STR_BUFFER, L"%S [INFO]: I0%05lu, %S", time, code, formatBuffer);
-				break;
-				case WARNING:
-				ret = swprintf(stringBuffer, MAX_LEN_STR_BUFFER, L"%S [WARN]: W7%05lu, %S", time, code, formatBuffer);
-				break;
-				case DEBUG:
-				ret = swprintf(stringBuffer, MAX_LEN_STR_BUFFER, L"%S [DEBUG]: %S", time, formatBuffer);
-				break;
-				case EVENT:
-				ret = swprintf(stringBuffer, MAX_LEN_STR_BUFFER, L"%S [EVENT]: %S", time, formatBuffer);
-				break;
-				default:
-				ret = 0;
-				break;
-			}
-			
-			if (ret > 0) {
-				switch (level) {
-					case CRITICAL:
-					case ERROR:
-					case INFO:
-					case WARNING:
-					worker.OutputAplLine(level, stringBuffer);
-					break;
-					case DEBUG:
-					worker.OutputDbgLine(stringBuffer);
-					break;
-					case EVENT:
-					worker.OutputEvntLine(stringBuffer);
-					break;
-					default:
-					break;
-				}
-			}
+		if (ret > 0) {
+			std::string str;
+			LoggerUtil::ToUtf8(formatBuffer, ret, str);
+			worker.OutputSysLogLine(level, str.data(), str.size());
 		}
 	}
 
 	/*
-	 * Write the formatted log record to syslog (/var/log/messages).
+	 * Write the formatted (UTF-8) log record to syslog (/var/log/messages).
 	 *
 	 * @param	level	The log level
-	 * @param	format	C string that contains a format string that follows the same specifications as format in
-	 *					printf (see printf for details)
+	 * @param	format	UTF-8 C string that contains a format string that follows the same specifications as format
+	 *					in printf (see printf for details)
 	 * @param	args	The variable argument list (va_list)
 	 */
-	void Logger::WriteSysLog(int level, const wchar_t* format, va_list args)
+	void Logger::WriteSysLog(int level, const char* format, va_list args)
 	{
-		wchar_t formatBuffer[MAX_LEN_FMT_BUFFER];
-		wchar_t stringBuffer[MAX_LEN_STR_BUFFER];
-		memset(formatBuffer, 0, sizeof(formatBuffer));
-		memset(stringBuffer, 0, sizeof(stringBuffer));
-		int ret = vswprintf(formatBuffer, MAX_LEN_FMT_BUFFER, format, args);
+		char formatBuffer[MAX_LEN_FMT_BUFFER];
+		int ret = vsnprintf(formatBuffer, MAX_LEN_FMT_BUFFER, format, args);
 
-		if (ret != -1) {
-			ret = swprintf(stringBuffer, MAX_LEN_STR_BUFFER, L"%S", formatBuffer);
-			if (ret > 0) {
-				wstring wstr(stringBuffer);
-				string str(wstr.begin(), wstr.end());
-				std::wcout << wstr << std::endl;
-				syslog(level, str.c_str());
-			}
-		}
+		// Truncate to the buffer size, as the wide version does
+		if (ret >= MAX_LEN_FMT_BUFFER)
+			ret = MAX_LEN_FMT_BUFFER - 1;
+		if (ret > 0)
+			worker.OutputSysLogLine(level, formatBuffer, ret);
 	}
 
 	/**
@@ -632,11 +4663,37 @@ namespace cpplogger {
 	 * @throw	The logger exception with exception details.
 	 */
 	void Logger::Init(std::string& aplLogPath, std::string& dbgLogPath, std::string& evntLogPath)
+	{
+		Init(aplLogPath, dbgLogPath, evntLogPath, LoggerOptions());
+	}
+
+	/**
+	 * Validate all the log files and initialize logger worker process with options (log rotation).<br>
+	 * Set all log file paths to default, if no values provided from calling module.
+	 *
+	 * @param	aplLogPath	Pointer to the application log file name
+	 * @param	dbgLogPath	Pointer to the debug log file name
+	 * @param	evntLogPath	Pointer to the event log file name
+	 * @param	options		The logger options
+	 *
+	 * @throw	The logger exception with exception details.
+	 */
+	void Logger::Init(std::string& aplLogPath, std::string& dbgLogPath, std::string& evntLogPath,
+		const LoggerOptions& options)
 	{
 		// Set all log file paths to default, if no values provided from calling module.
-		locale loc = locale::global(locale(LOCALE_DEFAULT));
-		string tempLocale = LOCALE_DEFAULT;
-		SysLogInfo(L"Logger::Init() locale has changed from (%s) to (%s)", loc.name().c_str(), tempLocale.c_str());
+		// The wide interfaces need a UTF-8 locale to convert narrow arguments (%s), fall back to C.UTF-8 when the
+		// default locale is not installed
+		const char *localeNames[] = { LOCALE_DEFAULT, LOCALE_FALLBACK };
+		for (size_t i = 0; i < sizeof(localeNames) / sizeof(localeNames[0]); i++) {
+			try {
+				locale loc = locale::global(locale(localeNames[i]));
+				SysLogInfo("Logger::Init() locale has changed from (%s) to (%s)", loc.name().c_str(), localeNames[i]);
+				break;
+			} catch (const std::runtime_error&) {
+				SysLogWarn("Logger::Init() locale (%s) is not available", localeNames[i]);
+			}
+		}
 
 		{
 			// Set application log file path to default, if empty.
@@ -732,7 +4789,7 @@ namespace cpplogger {
 						L"Logger::Init() failed to validate event log file (%s) permissions", evntLogPath.c_str()));
 			}
 		}
-		worker.Init(aplLogPath, dbgLogPath, evntLogPath);
+		worker.Init(aplLogPath, dbgLogPath, evntLogPath, options);
 	}
 
 	/**
@@ -765,6 +4822,213 @@ namespace cpplogger {
 	void Logger::EnableConsoleLogging(bool value)
 	{
 		worker.hasConsoleLogging = value;
+		if (value)
+			worker.consoleSink.DetectTerminal();
+		worker.SetRouteLevels(&worker.consoleSink, value ? SEVERITY_MASK_ALL : 0);
+	}
+
+	/**
+	 * Enable/disable deferred formatting. When enabled, the logging thread only captures the time stamp, the
+	 * format string pointer and the binary encoded arguments, and the write threads format the log records.<br>
+	 * The format strings must stay valid until the records are written (e.g. string literals), and %n is not
+	 * supported.
+	 *
+	 * @param	value	the parameter to enable or disable deferred formatting.
+	 */
+	void Logger::EnableDeferredFormatting(bool value)
+	{
+		worker.hasDeferredFormatting = value;
+	}
+
+	/**
+	 * Set the time stamp format of the log records: local time ('yyyy-MM-dd HH:mm:ss.SSS', default), UTC
+	 * ('yyyy-MM-dd HH:mm:ss.SSSZ') or nanoseconds since epoch.
+	 *
+	 * @param	format	the time stamp format.
+	 */
+	void Logger::SetTimestampFormat(TimestampFormat format)
+	{
+		worker.timestampFormat = format;
+	}
+
+	/**
+	 * Enable/disable reading the time stamps from CLOCK_REALTIME_COARSE, which is cheaper than CLOCK_REALTIME
+	 * but only advances once per scheduler tick (typically 1-4 ms).
+	 *
+	 * @param	value	the parameter to enable or disable the coarse clock.
+	 */
+	void Logger::EnableCoarseClock(bool value)
+	{
+		worker.hasCoarseClock = value;
+	}
+
+	/**
+	 * Enable/disable stamping the deferred records with the time stamp counter (rdtsc) instead of the wall
+	 * clock. A calibration thread maps the counter to wall clock time, which the write threads use to render
+	 * the time stamps. Ignored (the wall clock is used) on CPUs without an invariant time stamp counter.
+	 *
+	 * @param	value	the parameter to enable or disable the TSC clock.
+	 */
+	void Logger::EnableTscClock(bool value)
+	{
+		if (value && !TscClock::IsInvariant()) {
+			SysLogWarn("Logger::EnableTscClock() no invariant TSC, using clock_gettime()");
+			value = false;
+		}
+
+		if (value) {
+			TscClock::Calibrate();
+			worker.StartTscCalibration();
+		} else {
+			worker.StopTscCalibration();
+		}
+		worker.hasTscClock = value;
+	}
+
+	/**
+	 * Enable/disable writing the log files through memory-mapped extents preallocated with fallocate() instead
+	 * of the file streams. Takes effect when a log file is opened (call it before Init()), and the files are
+	 * trimmed to their real length by DropAll(). Until then a file ends with the preallocated (zero filled)
+	 * space of the current extent; when the process is killed, the next run appends after the written data.
+	 *
+	 * @param	value	the parameter to enable or disable the memory-mapped log files.
+	 */
+	void Logger::EnableMappedFile(bool value)
+	{
+		worker.hasMappedFile = value;
+	}
+
+	/**
+	 * Enable/disable writing the log files asynchronously through io_uring (batched writes from registered
+	 * buffers, several in flight per file) instead of the file streams. Takes effect when a log file is opened
+	 * (call it before Init()), the file streams are used if io_uring is not available.
+	 *
+	 * @param	value	the parameter to enable or disable the io_uring log files.
+	 */
+	void Logger::EnableUringFile(bool value)
+	{
+		worker.hasUringFile = value;
+	}
+
+	/**
+	 * Set the maximum number of records the write threads take from a log queue and write to the log file
+	 * with a single write.
+	 *
+	 * @param	size	the maximum number of records per batch (0 is treated as 1).
+	 */
+	void Logger::SetBatchSize(size_t size)
+	{
+		worker.batchSize = size;
+	}
+
+	/**
+	 * Get the number of records of a severity level the queues of the sinks have dropped on overflow since the
+	 * process started (see QueueOptions).
+	 *
+	 * @param	level	the log severity level.
+	 *
+	 * @return	The number of dropped records.
+	 */
+	unsigned long Logger::GetDroppedCount(SeverityLevel level)
+	{
+		if ((size_t) level >= SEVERITY_LEVEL_COUNT)
+			return 0;
+
+		unsigned long total = 0;
+		size_t count = worker.routeCount.load(std::memory_order_acquire);
+		for (size_t i = 0; i < count; i++)
+			total += worker.routes[i].sink.load(std::memory_order_relaxed)->dropped.total[level].load(
+				std::memory_order_relaxed);
+		return total;
+	}
+
+	/**
+	 * Route severity levels to an additional sink, along with the log files. The writer threads service the sink
+	 * from then on; the sinks stay routed until RemoveSinks() is called.
+	 *
+	 * @param	sink	the sink.
+	 * @param	levels	the severity levels (SEVERITY_MASK() bits, e.g. SEVERITY_MASK_ALL).
+	 *
+	 * @return	false is returned if the sink is NULL or SINK_COUNT_MAX sinks are routed already. Otherwise, true
+	 *			is returned.
+	 */
+	bool Logger::AddSink(std::shared_ptr<LogSink> sink, unsigned int levels)
+	{
+		if (!sink)
+			return false;
+
+		{
+			std::lock_guard<std::mutex> lock(worker.mtxRoutes);
+			worker.userSinks.push_back(sink);
+		}
+		if (worker.AddRoute(sink.get(), levels))
+			return true;
+
+		std::lock_guard<std::mutex> lock(worker.mtxRoutes);
+		for (size_t i = worker.userSinks.size(); i > 0; i--) {
+			if (worker.userSinks[i - 1] == sink) {
+				worker.userSinks.erase(worker.userSinks.begin() + (i - 1));
+				break;
+			}
+		}
+		return false;
+	}
+
+	/**
+	 * Remove the sinks added by AddSink(), while the writer threads are stopped (before Init() or after
+	 * DropAll()).
+	 *
+	 * @return	false is returned if the writer threads are running. Otherwise, true is returned.
+	 */
+	bool Logger::RemoveSinks()
+	{
+		if (worker.hasWriterThreads)
+			return false;
+
+		std::lock_guard<std::mutex> lock(worker.mtxRoutes);
+		worker.routeCount.store(SINK_COUNT_BUILTIN, std::memory_order_release);
+		worker.userSinks.clear();
+		return true;
+	}
+
+	/**
+	 * Limit the rate of the log records of every code without a limit of its own. The records over the limit are
+	 * suppressed before they are formatted, and every RATE_LIMIT_SUMMARY_MS a summary like 'suppressed 120
+	 * occurrences of E800002' is written with the level and code of the suppressed records.
+	 *
+	 * @param	rate		the records per second (0 for no limit).
+	 * @param	burst		the records allowed at once.
+	 * @param	perCallSite	true to limit per call site (format string) instead of per code.
+	 */
+	void Logger::SetRateLimit(unsigned int rate, unsigned int burst, bool perCallSite)
+	{
+		worker.rateLimiter.SetDefault(rate, burst, perCallSite);
+	}
+
+	/**
+	 * Limit the rate of the log records of a code, overriding the limit set for every code.
+	 *
+	 * @param	level	the log severity level.
+	 * @param	code	the code (0 for DEBUG and EVENT).
+	 * @param	rate	the records per second (0 for no limit).
+	 * @param	burst	the records allowed at once.
+	 *
+	 * @return	false is returned if RATE_LIMIT_CODES codes already have a limit. Otherwise, true is returned.
+	 */
+	bool Logger::SetRateLimit(SeverityLevel level, unsigned long code, unsigned int rate, unsigned int burst)
+	{
+		return worker.rateLimiter.SetLimit(level, code, rate, burst);
+	}
+
+	/**
+	 * Set the maximum time the write threads wait for a batch to fill up before writing it.<br>
+	 * 0 (default) writes whatever is pending as soon as the first record arrives.
+	 *
+	 * @param	milliseconds	the maximum batch latency in milliseconds.
+	 */
+	void Logger::SetBatchLatency(unsigned int milliseconds)
+	{
+		worker.batchLatencyMs = milliseconds;
 	}
 
 	/**
@@ -798,7 +5062,121 @@ namespace cpplogger {
 	}
 
 	/**
-	 * Write (application) critical level log records to the application log file.
+	 * Write (application) critical level log records to the application log file.
+	 *
+	 * @param	format	C string that contains a format string that follows the same specifications as format in
+	 *					printf (see printf for details)
+	 * @param	...		(additional arguments) Depending on the format string, the function may expect a sequence
+	 *					of additional arguments, each containing a value to be used to replace a format specifier
+	 *					in the format string (or a pointer to a storage location, for n). There should be at least
+	 *					as many of these arguments as the number of values specified in the format specifiers.
+	 *					Additional arguments are ignored by the function.
+	 */
+	void Logger::Crit(const wchar_t* format, ...)
+	{
+		// If requested log level is less than the default log level[set by program], skip writing
+		if (CRITICAL < worker.severityLevel) {
+			return;
+		}
+
+		if (!worker.hasAplLog) {
+			return;
+		}
+
+		va_list vl;
+		va_start(vl, format);
+		WriteLog(CRITICAL, LOGGER_CODE_CRIT_DEFAULT, format, vl);
+		va_end(vl);
+	}
+
+	/**
+	 * Write (application) critical level log records to the application log file.
+	 *
+	 * @param	format	UTF-8 C string that contains a format string that follows the same specifications as format
+	 *					in printf (see printf for details)
+	 * @param	...		(additional arguments) Depending on the format string, the function may expect a sequence
+	 *					of additional arguments, each containing a value to be used to replace a format specifier
+	 *					in the format string (or a pointer to a storage location, for n). There should be at least
+	 *					as many of these arguments as the number of values specified in the format specifiers.
+	 *					Additional arguments are ignored by the function.
+	 */
+	void Logger::Crit(const char* format, ...)
+	{
+		// If requested log level is less than the default log level[set by program], skip writing
+		if (CRITICAL < worker.severityLevel) {
+			return;
+		}
+
+		if (!worker.hasAplLog) {
+			return;
+		}
+
+		va_list vl;
+		va_start(vl, format);
+		WriteLog(CRITICAL, LOGGER_CODE_CRIT_DEFAULT, format, vl);
+		va_end(vl);
+	}
+
+	/**
+	 * Write (application) critical level log record to the application log file.
+	 *
+	 * @param 	code 	The 5 digit custom defined code to each record.
+	 * @param	format	C string that contains a format string that follows the same specifications as format in
+	 *					printf (see printf for details)
+	 * @param	...		(additional arguments) Depending on the format string, the function may expect a sequence
+	 *					of additional arguments, each containing a value to be used to replace a format specifier
+	 *					in the format string (or a pointer to a storage location, for n). There should be at least
+	 *					as many of these arguments as the number of values specified in the format specifiers.
+	 *					Additional arguments are ignored by the function.
+	 */
+	void Logger::Crit(unsigned long code, const wchar_t* format, ...)
+	{
+		// If requested log level is less than the default log level[set by program], skip writing
+		if (CRITICAL < worker.severityLevel) {
+			return;
+		}
+
+		if (!worker.hasAplLog) {
+			return;
+		}
+
+		va_list vl;
+		va_start(vl, format);
+		WriteLog(CRITICAL, code, format, vl);
+		va_end(vl);
+	}
+
+	/**
+	 * Write (application) critical level log record to the application log file.
+	 *
+	 * @param 	code 	The 5 digit custom defined code to each record.
+	 * @param	format	UTF-8 C string that contains a format string that follows the same specifications as format
+	 *					in printf (see printf for details)
+	 * @param	...		(additional arguments) Depending on the format string, the function may expect a sequence
+	 *					of additional arguments, each containing a value to be used to replace a format specifier
+	 *					in the format string (or a pointer to a storage location, for n). There should be at least
+	 *					as many of these arguments as the number of values specified in the format specifiers.
+	 *					Additional arguments are ignored by the function.
+	 */
+	void Logger::Crit(unsigned long code, const char* format, ...)
+	{
+		// If requested log level is less than the default log level[set by program], skip writing
+		if (CRITICAL < worker.severityLevel) {
+			return;
+		}
+
+		if (!worker.hasAplLog) {
+			return;
+		}
+
+		va_list vl;
+		va_start(vl, format);
+		WriteLog(CRITICAL, code, format, vl);
+		va_end(vl);
+	}
+
+	/**
+	 * Write (application) error level log record to the application log file.
 	 *
 	 * @param	format	C string that contains a format string that follows the same specifications as format in
 	 *					printf (see printf for details)
@@ -808,10 +5186,10 @@ namespace cpplogger {
 	 *					as many of these arguments as the number of values specified in the format specifiers.
 	 *					Additional arguments are ignored by the function.
 	 */
-	void Logger::Crit(const wchar_t* format, ...)
+	void Logger::Error(const wchar_t* format, ...)
 	{
 		// If requested log level is less than the default log level[set by program], skip writing
-		if (CRITICAL < worker.severityLevel) {
+		if (ERROR < worker.severityLevel) {
 			return;
 		}
 
@@ -821,26 +5199,25 @@ namespace cpplogger {
 
 		va_list vl;
 		va_start(vl, format);
-		WriteLog(CRITICAL, LOGGER_CODE_CRIT_DEFAULT, format, vl);
+		WriteLog(ERROR, LOGGER_CODE_ERRR_DEFAULT, format, vl);
 		va_end(vl);
 	}
 
 	/**
-	 * Write (application) critical level log record to the application log file.
+	 * Write (application) error level log record to the application log file.
 	 *
-	 * @param 	code 	The 5 digit custom defined code to each record.
-	 * @param	format	C string that contains a format string that follows the same specifications as format in
-	 *					printf (see printf for details)
+	 * @param	format	UTF-8 C string that contains a format string that follows the same specifications as format
+	 *					in printf (see printf for details)
 	 * @param	...		(additional arguments) Depending on the format string, the function may expect a sequence
 	 *					of additional arguments, each containing a value to be used to replace a format specifier
 	 *					in the format string (or a pointer to a storage location, for n). There should be at least
 	 *					as many of these arguments as the number of values specified in the format specifiers.
 	 *					Additional arguments are ignored by the function.
 	 */
-	void Logger::Crit(unsigned long code, const wchar_t* format, ...)
+	void Logger::Error(const char* format, ...)
 	{
 		// If requested log level is less than the default log level[set by program], skip writing
-		if (CRITICAL < worker.severityLevel) {
+		if (ERROR < worker.severityLevel) {
 			return;
 		}
 
@@ -850,13 +5227,14 @@ namespace cpplogger {
 
 		va_list vl;
 		va_start(vl, format);
-		WriteLog(CRITICAL, code, format, vl);
+		WriteLog(ERROR, LOGGER_CODE_ERRR_DEFAULT, format, vl);
 		va_end(vl);
 	}
 
 	/**
 	 * Write (application) error level log record to the application log file.
 	 *
+	 * @param 	code 	The 5 digit custom defined code to each record.
 	 * @param	format	C string that contains a format string that follows the same specifications as format in
 	 *					printf (see printf for details)
 	 * @param	...		(additional arguments) Depending on the format string, the function may expect a sequence
@@ -865,7 +5243,7 @@ namespace cpplogger {
 	 *					as many of these arguments as the number of values specified in the format specifiers.
 	 *					Additional arguments are ignored by the function.
 	 */
-	void Logger::Error(const wchar_t* format, ...)
+	void Logger::Error(unsigned long code, const wchar_t* format, ...)
 	{
 		// If requested log level is less than the default log level[set by program], skip writing
 		if (ERROR < worker.severityLevel) {
@@ -878,7 +5256,7 @@ namespace cpplogger {
 
 		va_list vl;
 		va_start(vl, format);
-		WriteLog(ERROR, LOGGER_CODE_ERRR_DEFAULT, format, vl);
+		WriteLog(ERROR, code, format, vl);
 		va_end(vl);
 	}
 
@@ -886,15 +5264,15 @@ namespace cpplogger {
 	 * Write (application) error level log record to the application log file.
 	 *
 	 * @param 	code 	The 5 digit custom defined code to each record.
-	 * @param	format	C string that contains a format string that follows the same specifications as format in
-	 *					printf (see printf for details)
+	 * @param	format	UTF-8 C string that contains a format string that follows the same specifications as format
+	 *					in printf (see printf for details)
 	 * @param	...		(additional arguments) Depending on the format string, the function may expect a sequence
 	 *					of additional arguments, each containing a value to be used to replace a format specifier
 	 *					in the format string (or a pointer to a storage location, for n). There should be at least
 	 *					as many of these arguments as the number of values specified in the format specifiers.
 	 *					Additional arguments are ignored by the function.
 	 */
-	void Logger::Error(unsigned long code, const wchar_t* format, ...)
+	void Logger::Error(unsigned long code, const char* format, ...)
 	{
 		// If requested log level is less than the default log level[set by program], skip writing
 		if (ERROR < worker.severityLevel) {
@@ -939,6 +5317,34 @@ namespace cpplogger {
 		va_end(vl);
 	}
 
+	/**
+	 * Write (application) info level log record to the application log file.
+	 *
+	 * @param	format	UTF-8 C string that contains a format string that follows the same specifications as format
+	 *					in printf (see printf for details)
+	 * @param	...		(additional arguments) Depending on the format string, the function may expect a sequence
+	 *					of additional arguments, each containing a value to be used to replace a format specifier
+	 *					in the format string (or a pointer to a storage location, for n). There should be at least
+	 *					as many of these arguments as the number of values specified in the format specifiers.
+	 *					Additional arguments are ignored by the function.
+	 */
+	void Logger::Info(const char* format, ...)
+	{
+		// If requested log level is less than the default log level[set by program], skip writing
+		if (INFO < worker.severityLevel) {
+			return;
+		}
+
+		if (!worker.hasAplLog) {
+			return;
+		}
+
+		va_list vl;
+		va_start(vl, format);
+		WriteLog(INFO, LOGGER_CODE_INFO_DEFAULT, format, vl);
+		va_end(vl);
+	}
+
 	/**
 	 * Write (application) info level log record to the application log file.
 	 *
@@ -968,6 +5374,35 @@ namespace cpplogger {
 		va_end(vl);
 	}
 
+	/**
+	 * Write (application) info level log record to the application log file.
+	 *
+	 * @param 	code 	The 5 digit custom defined code to each record.
+	 * @param	format	UTF-8 C string that contains a format string that follows the same specifications as format
+	 *					in printf (see printf for details)
+	 * @param	...		(additional arguments) Depending on the format string, the function may expect a sequence
+	 *					of additional arguments, each containing a value to be used to replace a format specifier
+	 *					in the format string (or a pointer to a storage location, for n). There should be at least
+	 *					as many of these arguments as the number of values specified in the format specifiers.
+	 *					Additional arguments are ignored by the function.
+	 */
+	void Logger::Info(unsigned long code, const char* format, ...)
+	{
+		// If requested log level is less than the default log level[set by program], skip writing
+		if (INFO < worker.severityLevel) {
+			return;
+		}
+
+		if (!worker.hasAplLog) {
+			return;
+		}
+
+		va_list vl;
+		va_start(vl, format);
+		WriteLog(INFO, code, format, vl);
+		va_end(vl);
+	}
+
 	/**
 	 * Write (application) warning level log record to the application log file.
 	 *
@@ -996,6 +5431,34 @@ namespace cpplogger {
 		va_end(vl);
 	}
 
+	/**
+	 * Write (application) warning level log record to the application log file.
+	 *
+	 * @param	format	UTF-8 C string that contains a format string that follows the same specifications as format
+	 *					in printf (see printf for details)
+	 * @param	...		(additional arguments) Depending on the format string, the function may expect a sequence
+	 *					of additional arguments, each containing a value to be used to replace a format specifier
+	 *					in the format string (or a pointer to a storage location, for n). There should be at least
+	 *					as many of these arguments as the number of values specified in the format specifiers.
+	 *					Additional arguments are ignored by the function.
+	 */
+	void Logger::Warn(const char* format, ...)
+	{
+		// If requested log level is less than the default log level[set by program], skip writing
+		if (WARNING < worker.severityLevel) {
+			return;
+		}
+
+		if (!worker.hasAplLog) {
+			return;
+		}
+
+		va_list vl;
+		va_start(vl, format);
+		WriteLog(WARNING, LOGGER_CODE_WARN_DEFAULT, format, vl);
+		va_end(vl);
+	}
+
 	/**
 	 * Write (application) warning level log record to the application log file.
 	 *
@@ -1025,6 +5488,35 @@ namespace cpplogger {
 		va_end(vl);
 	}
 
+	/**
+	 * Write (application) warning level log record to the application log file.
+	 *
+	 * @param 	code 	The 5 digit custom defined code to each record.
+	 * @param	format	UTF-8 C string that contains a format string that follows the same specifications as format
+	 *					in printf (see printf for details)
+	 * @param	...		(additional arguments) Depending on the format string, the function may expect a sequence
+	 *					of additional arguments, each containing a value to be used to replace a format specifier
+	 *					in the format string (or a pointer to a storage location, for n). There should be at least
+	 *					as many of these arguments as the number of values specified in the format specifiers.
+	 *					Additional arguments are ignored by the function.
+	 */
+	void Logger::Warn(unsigned long code, const char* format, ...)
+	{
+		// If requested log level is less than the default log level[set by program], skip writing
+		if (WARNING < worker.severityLevel) {
+			return;
+		}
+
+		if (!worker.hasAplLog) {
+			return;
+		}
+
+		va_list vl;
+		va_start(vl, format);
+		WriteLog(WARNING, code, format, vl);
+		va_end(vl);
+	}
+
 	/**
 	 * Write debug level log record to the debug log file.
 	 *
@@ -1048,6 +5540,29 @@ namespace cpplogger {
 		va_end(vl);
 	}
 
+	/**
+	 * Write debug level log record to the debug log file.
+	 *
+	 * @param	format	UTF-8 C string that contains a format string that follows the same specifications as format
+	 *					in printf (see printf for details)
+	 * @param	...		(additional arguments) Depending on the format string, the function may expect a sequence
+	 *					of additional arguments, each containing a value to be used to replace a format specifier
+	 *					in the format string (or a pointer to a storage location, for n). There should be at least
+	 *					as many of these arguments as the number of values specified in the format specifiers.
+	 *					Additional arguments are ignored by the function.
+	 */
+	void Logger::Debug(const char* format, ...)
+	{
+		if (!worker.hasDbgLog) {
+			return;
+		}
+
+		va_list vl;
+		va_start(vl, format);
+		WriteLog(DEBUG, 0, format, vl);
+		va_end(vl);
+	}
+
 	/**
 	 * Write event level log record to the event log file.
 	 *
@@ -1071,6 +5586,29 @@ namespace cpplogger {
 		va_end(vl);
 	}
 
+	/**
+	 * Write event level log record to the event log file.
+	 *
+	 * @param	format	UTF-8 C string that contains a format string that follows the same specifications as format
+	 *					in printf (see printf for details)
+	 * @param	...		(additional arguments) Depending on the format string, the function may expect a sequence
+	 *					of additional arguments, each containing a value to be used to replace a format specifier
+	 *					in the format string (or a pointer to a storage location, for n). There should be at least
+	 *					as many of these arguments as the number of values specified in the format specifiers.
+	 *					Additional arguments are ignored by the function.
+	 */
+	void Logger::Event(const char* format, ...)
+	{
+		if (!worker.hasEvntLog) {
+			return;
+		}
+
+		va_list vl;
+		va_start(vl, format);
+		WriteLog(EVENT, 0, format, vl);
+		va_end(vl);
+	}
+
 	/**
 	 * Write the critical level log record to syslog (/var/log/messages).
 	 *
@@ -1090,6 +5628,25 @@ namespace cpplogger {
 		va_end(vl);
 	}
 
+	/**
+	 * Write the critical level log record to syslog (/var/log/messages).
+	 *
+	 * @param	format	UTF-8 C string that contains a format string that follows the same specifications as format
+	 *					in printf (see printf for details)
+	 * @param	...		(additional arguments) Depending on the format string, the function may expect a sequence
+	 *					of additional arguments, each containing a value to be used to replace a format specifier
+	 *					in the format string (or a pointer to a storage location, for n). There should be at least
+	 *					as many of these arguments as the number of values specified in the format specifiers.
+	 *					Additional arguments are ignored by the function.
+	 */
+	void Logger::SysLogCrit(const char* format, ...)
+	{
+		va_list vl;
+		va_start(vl, format);
+		WriteSysLog(LOG_CRIT, format, vl);
+		va_end(vl);
+	}
+
 	/**
 	 * Write the debug level log record to syslog (/var/log/messages).
 	 *
@@ -1109,6 +5666,25 @@ namespace cpplogger {
 		va_end(vl);
 	}
 
+	/**
+	 * Write the debug level log record to syslog (/var/log/messages).
+	 *
+	 * @param	format	UTF-8 C string that contains a format string that follows the same specifications as format
+	 *					in printf (see printf for details)
+	 * @param	...		(additional arguments) Depending on the format string, the function may expect a sequence
+	 *					of additional arguments, each containing a value to be used to replace a format specifier
+	 *					in the format string (or a pointer to a storage location, for n). There should be at least
+	 *					as many of these arguments as the number of values specified in the format specifiers.
+	 *					Additional arguments are ignored by the function.
+	 */
+	void Logger::SysLogDebug(const char* format, ...)
+	{
+		va_list vl;
+		va_start(vl, format);
+		WriteSysLog(LOG_DEBUG, format, vl);
+		va_end(vl);
+	}
+
 	/**
 	 * Write the error level log record to syslog (/var/log/messages).
 	 *
@@ -1128,6 +5704,25 @@ namespace cpplogger {
 		va_end(vl);
 	}
 
+	/**
+	 * Write the error level log record to syslog (/var/log/messages).
+	 *
+	 * @param	format	UTF-8 C string that contains a format string that follows the same specifications as format
+	 *					in printf (see printf for details)
+	 * @param	...		(additional arguments) Depending on the format string, the function may expect a sequence
+	 *					of additional arguments, each containing a value to be used to replace a format specifier
+	 *					in the format string (or a pointer to a storage location, for n). There should be at least
+	 *					as many of these arguments as the number of values specified in the format specifiers.
+	 *					Additional arguments are ignored by the function.
+	 */
+	void Logger::SysLogError(const char* format, ...)
+	{
+		va_list vl;
+		va_start(vl, format);
+		WriteSysLog(LOG_ERR, format, vl);
+		va_end(vl);
+	}
+
 	/**
 	 * Write the information level log record to syslog (/var/log/messages).
 	 *
@@ -1147,6 +5742,25 @@ namespace cpplogger {
 		va_end(vl);
 	}
 
+	/**
+	 * Write the information level log record to syslog (/var/log/messages).
+	 *
+	 * @param	format	UTF-8 C string that contains a format string that follows the same specifications as format
+	 *					in printf (see printf for details)
+	 * @param	...		(additional arguments) Depending on the format string, the function may expect a sequence
+	 *					of additional arguments, each containing a value to be used to replace a format specifier
+	 *					in the format string (or a pointer to a storage location, for n). There should be at least
+	 *					as many of these arguments as the number of values specified in the format specifiers.
+	 *					Additional arguments are ignored by the function.
+	 */
+	void Logger::SysLogInfo(const char* format, ...)
+	{
+		va_list vl;
+		va_start(vl, format);
+		WriteSysLog(LOG_INFO, format, vl);
+		va_end(vl);
+	}
+
 	/**
 	 * Write the warning level log record to syslog (/var/log/messages).
 	 *
@@ -1166,6 +5780,25 @@ namespace cpplogger {
 		va_end(vl);
 	}
 
+	/**
+	 * Write the warning level log record to syslog (/var/log/messages).
+	 *
+	 * @param	format	UTF-8 C string that contains a format string that follows the same specifications as format
+	 *					in printf (see printf for details)
+	 * @param	...		(additional arguments) Depending on the format string, the function may expect a sequence
+	 *					of additional arguments, each containing a value to be used to replace a format specifier
+	 *					in the format string (or a pointer to a storage location, for n). There should be at least
+	 *					as many of these arguments as the number of values specified in the format specifiers.
+	 *					Additional arguments are ignored by the function.
+	 */
+	void Logger::SysLogWarn(const char* format, ...)
+	{
+		va_list vl;
+		va_start(vl, format);
+		WriteSysLog(LOG_WARNING, format, vl);
+		va_end(vl);
+	}
+
 	/**
 	 * Release and close all loggers
 	 *
@@ -1173,8 +5806,13 @@ namespace cpplogger {
 	 */
 	void Logger::DropAll()
 	{
-		// Sleep server for 200ms to break the write threads wait
-		LoggerUtil::Sleep(2 * SLEEP_IN_MS);
+		// Report the records suppressed by the rate limits since their last summary
+		SeverityLevel level;
+		unsigned long code, suppressed;
+		for (size_t i = 0; i < RATE_LIMIT_BUCKETS && worker.rateLimiter.IsEnabled(); i++) {
+			if (worker.rateLimiter.TakeSuppressed(i, level, code, suppressed) && IsLogEnabled(level))
+				WriteSuppressed(level, code, suppressed);
+		}
 
 		try {
 			worker.DropAll();
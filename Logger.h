@@ -26,27 +26,99 @@
 #include <iostream>
 #include <thread>
 #include <mutex>
-#include <queue>
+#include <condition_variable>
+#include <atomic>
+#include <new>
+#include <stdint.h>
+#include <deque>
+#include <memory>
 #include <libgen.h>
 #include <fstream>
 #include <string>
+#include <type_traits>
+#include <algorithm>
 #include <vector>
+#include <unordered_map>
 #include <stdlib.h>
 #include <stdio.h>
 #include <unistd.h>
 #include <chrono>
+#include <time.h>
 #include <locale>
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <dirent.h>
+#include <climits>
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#define CPPLOGGER_HAVE_IO_URING
+#endif
+#endif
+#ifdef CPPLOGGER_HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef CPPLOGGER_HAVE_ZSTD
+#include <zstd.h>
+#endif
+#include <sys/resource.h>
+#include <pthread.h>
+#include <sched.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#include <cpuid.h>
+#endif
 
 #define MAX_LEN_FMT_BUFFER			2048
 #define MAX_LEN_STR_BUFFER			2080
 #define MAX_LEN_DATE_BUFFER			32
 #define SLEEP_IN_MS					100
+#define LOG_QUEUE_CAPACITY			8192
+#define LOG_RECORD_RESERVE			128
+#define SEVERITY_LEVEL_COUNT		10
+#define SEVERITY_MASK(level)		(1u << (level))
+#define SEVERITY_MASK_ALL			0x3C3
+#define SINK_COUNT_MAX				16
+#define SINK_COUNT_BUILTIN			5
+#define WRITER_THREADS_DEFAULT		1
+#define THREAD_NAME_DEFAULT			"cpplogger"
+#define THREAD_NAME_MAX				15
+#define NUMA_NODES_MAX				8
+#define NUMA_NODE_PATH				"/sys/devices/system/node"
+#define MEMORY_SINK_LINES_DEFAULT	1000
+#define RATE_LIMIT_BUCKETS			4096
+#define RATE_LIMIT_CODES			256
+#define RATE_LIMIT_PROBES			16
+#define RATE_LIMIT_SUMMARY_MS		10000
+#define CACHE_LINE_SIZE				64
+#define BATCH_SIZE_DEFAULT			1024
+#define BATCH_LATENCY_MS_DEFAULT	0
+#define TSC_CALIBRATION_MS			1000
+#define MMAP_EXTENT_SIZE			(64 * 1024 * 1024)
+#define URING_BUFFER_COUNT			4
+#define ROTATE_MAX_FILES_DEFAULT	10
+#define COMPRESS_RATE_DEFAULT		(8 * 1024 * 1024)
+#define COMPRESS_CHUNK_SIZE			(64 * 1024)
+#define INDEX_INTERVAL_DEFAULT		(64 * 1024)
+#define URING_BUFFER_SIZE			(256 * 1024)
+#define BINLOG_VERSION				1
+#define BINLOG_ENTRY_MAX			(64 * 1024 * 1024)
+#define BINLOG_READ_CHUNK			(64 * 1024)
 
 #define LOCALE_DEFAULT				"en_US.UTF8"
+#define LOCALE_FALLBACK				"C.UTF-8"
 #define APL_LOG_PATH_DEFAULT		"/var/log/cpplogger/apl.log"
 #define DBG_LOG_PATH_DEFAULT		"/var/log/cpplogger/debug.log"
 #define EVNT_LOG_PATH_DEFAULT		"/var/log/cpplogger/event.log"
+#define SYSLOG_PATH_DEFAULT			"/dev/log"
+#define BINLOG_MAGIC				"CPPLGBIN"
+#define BINLOG_MAGIC_LEN			8
 
 // Information level message code
 #define LOGGER_CODE_INFO_DEFAULT    		00001
@@ -64,8 +136,99 @@
 #define LOGGER_CODE_WARN_DEFAULT	 		00001
 #define LOGGER_CODE_WARN_APP_START	 		00002
 #define LOGGER_CODE_WARN_APP_STOP	 		00003
+#define LOGGER_CODE_WARN_RECORDS_DROPPED	00004
 //......and more
 
+/**
+ * Wraps a string literal into a compile-time format string for the type-safe logging interfaces.<br>
+ * Each '{}' is replaced by the next argument, '{{' and '}}' write literal braces. A placeholder/argument count
+ * mismatch fails the build.
+ *
+ * Usage: Logger::Info(LOGGER_CODE_INFO_DEFAULT, CPPLOGGER_FMT("user {} took {} ms"), id, ms);
+ */
+#define CPPLOGGER_FMT(str) \
+	([]() { \
+		struct FormatString : public cpplogger::FormatStringBase { \
+			static constexpr const char *Value() { return str; } \
+		}; \
+		return FormatString(); \
+	}())
+
+// Severity level values for CPPLOGGER_MIN_LEVEL (same values as SeverityLevel)
+#define CPPLOGGER_LEVEL_INFO				0
+#define CPPLOGGER_LEVEL_EVENT				1
+#define CPPLOGGER_LEVEL_DEBUG				6
+#define CPPLOGGER_LEVEL_WARNING				7
+#define CPPLOGGER_LEVEL_ERROR				8
+#define CPPLOGGER_LEVEL_CRITICAL			9
+
+// Compile-time severity floor of the CPPLOGGER_<LEVEL>() macros, e.g. -DCPPLOGGER_MIN_LEVEL=CPPLOGGER_LEVEL_WARNING
+// strips the info, event and debug statements from the build
+#ifndef CPPLOGGER_MIN_LEVEL
+#define CPPLOGGER_MIN_LEVEL					CPPLOGGER_LEVEL_INFO
+#endif
+
+// Branch prediction hints
+#define CPPLOGGER_LIKELY(x)					__builtin_expect(!!(x), 1)
+#define CPPLOGGER_UNLIKELY(x)				__builtin_expect(!!(x), 0)
+
+/**
+ * Logging macros which check the severity level before the arguments are evaluated. Each macro takes the
+ * arguments of the respective Logger interface (printf style, with or without code, or CPPLOGGER_FMT()).<br>
+ * Levels below CPPLOGGER_MIN_LEVEL compile to nothing (the statement is type checked, never executed). At run
+ * time, CPPLOGGER_DEBUG() and CPPLOGGER_EVENT() are skipped when their log file is disabled, not by the severity
+ * level (see Logger::IsLogEnabled()).
+ *
+ * Usage: CPPLOGGER_DEBUG(L"state=%s", DumpState().c_str());
+ */
+#define CPPLOGGER_LOG(level, func, ...) \
+	do { \
+		if (CPPLOGGER_UNLIKELY(cpplogger::Logger::IsLogEnabled(level))) \
+			cpplogger::Logger::func(__VA_ARGS__); \
+	} while (0)
+
+#define CPPLOGGER_DISCARD(func, ...) \
+	do { \
+		if (false) \
+			cpplogger::Logger::func(__VA_ARGS__); \
+	} while (0)
+
+#if CPPLOGGER_MIN_LEVEL <= CPPLOGGER_LEVEL_INFO
+#define CPPLOGGER_INFO(...)			CPPLOGGER_LOG(cpplogger::INFO, Info, __VA_ARGS__)
+#else
+#define CPPLOGGER_INFO(...)			CPPLOGGER_DISCARD(Info, __VA_ARGS__)
+#endif
+
+#if CPPLOGGER_MIN_LEVEL <= CPPLOGGER_LEVEL_EVENT
+#define CPPLOGGER_EVENT(...)		CPPLOGGER_LOG(cpplogger::EVENT, Event, __VA_ARGS__)
+#else
+#define CPPLOGGER_EVENT(...)		CPPLOGGER_DISCARD(Event, __VA_ARGS__)
+#endif
+
+#if CPPLOGGER_MIN_LEVEL <= CPPLOGGER_LEVEL_DEBUG
+#define CPPLOGGER_DEBUG(...)		CPPLOGGER_LOG(cpplogger::DEBUG, Debug, __VA_ARGS__)
+#else
+#define CPPLOGGER_DEBUG(...)		CPPLOGGER_DISCARD(Debug, __VA_ARGS__)
+#endif
+
+#if CPPLOGGER_MIN_LEVEL <= CPPLOGGER_LEVEL_WARNING
+#define CPPLOGGER_WARN(...)			CPPLOGGER_LOG(cpplogger::WARNING, Warn, __VA_ARGS__)
+#else
+#define CPPLOGGER_WARN(...)			CPPLOGGER_DISCARD(Warn, __VA_ARGS__)
+#endif
+
+#if CPPLOGGER_MIN_LEVEL <= CPPLOGGER_LEVEL_ERROR
+#define CPPLOGGER_ERROR(...)		CPPLOGGER_LOG(cpplogger::ERROR, Error, __VA_ARGS__)
+#else
+#define CPPLOGGER_ERROR(...)		CPPLOGGER_DISCARD(Error, __VA_ARGS__)
+#endif
+
+#if CPPLOGGER_MIN_LEVEL <= CPPLOGGER_LEVEL_CRITICAL
+#define CPPLOGGER_CRIT(...)			CPPLOGGER_LOG(cpplogger::CRITICAL, Crit, __VA_ARGS__)
+#else
+#define CPPLOGGER_CRIT(...)			CPPLOGGER_DISCARD(Crit, __VA_ARGS__)
+#endif
+
 // Critical level message code
 #define LOGGER_CODE_CRIT_DEFAULT	    	00001
 #define LOGGER_CODE_CRIT_APP_START	    	00002
@@ -104,6 +267,25 @@ namespace cpplogger {
 		CRITICAL = 9
 	};
 
+	/**
+	 * @enum TimestampFormat
+	 *
+	 * @brief Enumerator which defines the time stamp formats of the log records. <br>
+	 * Available formats are:
+	 *
+	 * <b>TIMESTAMP_LOCAL(0)</b>	<br>Local time in 'yyyy-MM-dd HH:mm:ss.SSS' format (default).
+	 *
+	 * <b>TIMESTAMP_UTC(1)</b>		<br>UTC in 'yyyy-MM-dd HH:mm:ss.SSSZ' format.
+	 *
+	 * <b>TIMESTAMP_EPOCH_NS(2)</b>	<br>Nanoseconds since epoch.
+	 */
+	enum TimestampFormat
+	{
+		TIMESTAMP_LOCAL = 0,
+		TIMESTAMP_UTC = 1,
+		TIMESTAMP_EPOCH_NS = 2
+	};
+
 	/**
 	 * @enum LoggerExceptionType
 	 *
@@ -133,151 +315,2184 @@ namespace cpplogger {
 	};
 
 	/**
-	 * @class LoggerException
+	 * @class LoggerException
+	 *
+	 * @brief Class which implements logger general exception handler.
+	 */
+	class LoggerException
+	{
+
+	private:
+
+		//! Logger exception message
+		std::string message;
+		//! Logger exception type
+		LoggerExceptionType type;
+
+	public:
+
+		//! Constructor 
+		/*! Sets the logger exception type.
+		 *
+		 * @param	type The logger exception type.
+		 */
+		LoggerException(LoggerExceptionType type)
+		{
+			this->type = type;
+		};
+
+		//! Constructor 
+		/*! Sets the logger exception type & message in C-wstring format (stored as UTF-8).
+		 *
+		 * @param	type	The logger exception type.
+		 * @param	msg		The logger exception message in C-wstring format.
+		 */
+		LoggerException(LoggerExceptionType type, const wstring& msg);
+
+		//! Constructor 
+		/*! Sets the logger exception type & message in C-string format.
+		 *
+		 * @param	type	The logger exception type.
+		 * @param	msg		The logger exception message in C-string format.
+		 */
+		LoggerException(LoggerExceptionType type, const string& msg)
+		{
+			this->type = type;
+			this->message = msg;
+		};
+
+		/**
+		 * Retrieves the logger exception type.
+		 *
+		 * @return	The logger exception type.
+		 */
+		LoggerExceptionType GetType()
+		{
+			return type;
+		};
+
+		/**
+		 * Retrieves the logger exception message as (UTF-8) C-string.
+		 *
+		 * @return	The logger exception message as C-string.
+		 */
+		const char *GetMsg()
+		{
+			return message.c_str();
+		};
+	};
+
+	/**
+	 * @class Doorbell
+	 *
+	 * @brief Wakes the writer threads when any of the log queues they service turns non-empty. A waiter passes the
+	 * ring count read before it looked at the queues, so a ring in between is not lost.
+	 */
+	class Doorbell
+	{
+
+	private:
+
+		//! mutex lock
+		std::mutex mtx;
+		//! Condition signalled on each ring
+		std::condition_variable cond;
+		//! Number of rings
+		unsigned long rings;
+
+	public:
+
+		//! Constructor
+		Doorbell() : rings(0) { };
+
+		/**
+		 * Retrieves the number of rings so far.
+		 *
+		 * @return	The number of rings.
+		 */
+		unsigned long Rings()
+		{
+			std::lock_guard<std::mutex> lock(mtx);
+			return rings;
+		};
+
+		//! Wake the waiting threads
+		void Ring()
+		{
+			{
+				std::lock_guard<std::mutex> lock(mtx);
+				rings++;
+			}
+			cond.notify_all();
+		};
+
+		/**
+		 * Waits until the doorbell rings after seen rings, or the timeout expires.
+		 *
+		 * @param	seen		The number of rings read before looking at the queues.
+		 * @param	timeoutMs	The maximum time to wait in milliseconds, negative to wait indefinitely.
+		 */
+		void Wait(unsigned long seen, long long timeoutMs)
+		{
+			std::unique_lock<std::mutex> lock(mtx);
+			if (timeoutMs < 0)
+				cond.wait(lock, [this, seen]() { return rings != seen; });
+			else
+				cond.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this, seen]() { return rings != seen; });
+		};
+	};
+
+	/**
+	 * @class BlockingQueue
+	 *
+	 * @brief Utility queue class which performs pop/push operation under a mutex lock.
+	 *
+	 * The elements live in a preallocated ring of slots: values are assigned in place and swapped out on pop, so
+	 * that string buffers are recycled between producers and the consumer, and a push allocates no node.
+	 */
+	template <typename T>
+	class BlockingQueue
+	{
+
+	private:
+
+		//! mutex lock
+		std::mutex mtx;
+		//! Condition signalled when the queue turns non-empty
+		std::condition_variable cond;
+		//! Condition signalled when elements are popped from a full queue
+		std::condition_variable condNotFull;
+		//! Set by wake() to release a waiting consumer
+		bool woken;
+		//! Maximum number of elements
+		size_t limit;
+		//! Ring of slots (at least limit slots)
+		std::vector<T> slots;
+		//! Slot of the oldest element
+		size_t head;
+		//! Number of elements
+		size_t count;
+		//! Size reserved in each element (see reserve())
+		size_t valueReserve;
+		//! Doorbell rung when the queue turns non-empty (NULL for none)
+		Doorbell *doorbell;
+
+		//! Signal the consumer
+		void notify()
+		{
+			cond.notify_one();
+			if (doorbell != NULL)
+				doorbell->Ring();
+		};
+
+		//! Retrieves the slot of the element at given position from the oldest one
+		T& at(size_t pos)
+		{
+			pos += head;
+			return slots[pos < slots.size() ? pos : pos - slots.size()];
+		};
+
+		//! Swaps the oldest element out
+		void take(T& rslt)
+		{
+			std::swap(rslt, slots[head]);
+			if (++head == slots.size())
+				head = 0;
+			count--;
+		};
+
+	public:
+
+		//! Constructor
+		/*! Allocates the slots of the queue.
+		 *
+		 * @param	capacity	The maximum number of elements.
+		 * @param	size		The size reserved in each element (see reserve()).
+		 */
+		explicit BlockingQueue(size_t capacity = LOG_QUEUE_CAPACITY, size_t size = 0)
+			: woken(false), limit(capacity), slots(std::max(capacity, (size_t) 1)), head(0), count(0), valueReserve(0),
+			doorbell(NULL)
+		{
+			reserve(size);
+		};
+
+		/**
+		 * <b>Pop element from queue</b> <br>
+		 * Pop elements from queue, returning true if an item poped from the queue; false otherwise.
+		 *
+		 * @param	rslt	Reference to the element where the popped value is stored (swapped with the slot value).
+		 *
+		 * @return 	true is returned in the case that an item poped from the queue.
+		 *			Otherwise, false is returned.
+		 */
+		bool pop(T& rslt)
+		{
+			{
+				std::lock_guard<std::mutex> lock(mtx);
+				if (count == 0)
+					return false;
+				take(rslt);
+			}
+			condNotFull.notify_all();
+			return true;
+		};
+
+		/**
+		 * <b>Pop a batch of elements from queue</b> <br>
+		 * Pop up to maxCount elements from queue under a single lock.
+		 *
+		 * @param	rslt		Vector where the popped elements are stored (swapped with the slot values),
+		 *						starting at index offset.
+		 * @param	offset		Index of rslt where the first popped element is stored.
+		 * @param	maxCount	The maximum number of elements to pop.
+		 *
+		 * @return 	The number of popped elements.
+		 */
+		size_t pop_batch(std::vector<T>& rslt, size_t offset, size_t maxCount)
+		{
+			size_t popped = 0;
+			{
+				std::lock_guard<std::mutex> lock(mtx);
+				for (size_t i = rslt.size(); i < offset + maxCount; i++) {
+					rslt.push_back(T());
+					rslt.back().reserve(valueReserve);
+				}
+				while (popped < maxCount && count > 0)
+					take(rslt[offset + popped++]);
+			}
+			if (popped > 0)
+				condNotFull.notify_all();
+			return popped;
+		};
+
+		/**
+		 * <b>Try to push element to the queue</b><br>
+		 * Push an element to the queue, returning false without waiting if the queue is full.
+		 *
+		 * @param	src		The element that requires insertion.
+		 *
+		 * @return 	true is returned in the case that the element is pushed.
+		 *			Otherwise (queue is full), false is returned.
+		 */
+		bool try_push(const T& src)
+		{
+			bool wasEmpty;
+			{
+				std::lock_guard<std::mutex> lock(mtx);
+				if (count >= limit)
+					return false;
+				wasEmpty = count == 0;
+				at(count++) = src;
+			}
+
+			// Signal the consumer on the empty to non-empty transition only
+			if (wasEmpty)
+				notify();
+			return true;
+		};
+
+		/**
+		 * <b>Push element to the queue</b><br>
+		 * Push an element to the queue, waiting while the queue is full.
+		 *
+		 * @param	src		The element that requires insertion.
+		 */
+		void push(const T& src)
+		{
+			bool wasEmpty;
+			{
+				std::unique_lock<std::mutex> lock(mtx);
+				condNotFull.wait(lock, [this]() { return count < limit; });
+				wasEmpty = count == 0;
+				at(count++) = src;
+			}
+
+			// Signal the consumer on the empty to non-empty transition only
+			if (wasEmpty)
+				notify();
+		};
+
+		/**
+		 * <b>Number of elements</b><br>
+		 *
+		 * @return 	The number of elements in the queue.
+		 */
+		size_t size()
+		{
+			std::lock_guard<std::mutex> lock(mtx);
+			return count;
+		};
+
+		/**
+		 * <b>Capacity</b><br>
+		 *
+		 * @return 	The maximum number of elements.
+		 */
+		size_t capacity()
+		{
+			std::lock_guard<std::mutex> lock(mtx);
+			return limit;
+		};
+
+		/**
+		 * <b>Change the capacity</b><br>
+		 * Reallocates the slots. Elements beyond the new capacity stay queued, pushes wait until the queue shrinks
+		 * below it.
+		 *
+		 * @param	capacity	The maximum number of elements.
+		 *
+		 * @return 	true is returned (the capacity of a blocking queue can always be changed).
+		 */
+		bool resize(size_t capacity)
+		{
+			{
+				std::lock_guard<std::mutex> lock(mtx);
+				size_t size = std::max(std::max(capacity, count), (size_t) 1);
+				if (size != slots.size()) {
+					std::vector<T> ring(size);
+					for (size_t i = 0; i < count; i++)
+						std::swap(ring[i], at(i));
+					for (size_t i = count; i < size; i++)
+						ring[i].reserve(valueReserve);
+					slots.swap(ring);
+					head = 0;
+				}
+				limit = capacity;
+			}
+			condNotFull.notify_all();
+			return true;
+		};
+
+		/**
+		 * <b>Reserve the elements</b><br>
+		 * Reserve a size in each slot and in the elements pop_batch() adds to its vector, so that pushing
+		 * elements up to that size does not allocate (the elements need a reserve(size_t) method).
+		 *
+		 * @param	size	The size (0 for none).
+		 */
+		void reserve(size_t size)
+		{
+			std::lock_guard<std::mutex> lock(mtx);
+			valueReserve = size;
+			for (size_t i = 0; i < slots.size(); i++)
+				slots[i].reserve(size);
+		};
+
+		/**
+		 * <b>Wait for elements</b><br>
+		 * Block the consumer until the queue is non-empty, wake() is called or the timeout expires.
+		 *
+		 * @param	timeoutMs	The maximum time to wait in milliseconds, negative to wait indefinitely.
+		 */
+		void wait(int timeoutMs = -1)
+		{
+			std::unique_lock<std::mutex> lock(mtx);
+			if (timeoutMs < 0)
+				cond.wait(lock, [this]() { return count > 0 || woken; });
+			else
+				cond.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this]() { return count > 0 || woken; });
+			woken = false;
+		};
+
+		/**
+		 * <b>Set the doorbell</b><br>
+		 * Ring a doorbell shared with other queues when the queue turns non-empty, in addition to signalling
+		 * wait(). Set it before the queue is used.
+		 *
+		 * @param	bell	The doorbell (NULL for none).
+		 */
+		void set_doorbell(Doorbell *bell)
+		{
+			doorbell = bell;
+		};
+
+		/**
+		 * <b>Wake the consumer</b><br>
+		 * Release a consumer blocked in wait() even though the queue is empty.
+		 */
+		void wake()
+		{
+			{
+				std::lock_guard<std::mutex> lock(mtx);
+				woken = true;
+			}
+			cond.notify_one();
+		};
+	};
+
+	//! Blocking wstring queue
+	typedef BlockingQueue<std::wstring> BlockingWStringQueue;
+
+	/**
+	 * @class LockFreeQueue
+	 *
+	 * @brief Bounded lock-free queue with preallocated slots (multi-producer/multi-consumer use).
+	 *
+	 * Each slot carries a sequence number which tells producers and consumers whether the slot is free
+	 * or holds a published element, so no lock is taken on push or pop. Slot values are assigned in place and
+	 * swapped out on pop, which lets string buffers be recycled between producers and the consumer instead of
+	 * allocating a node per record.
+	 *
+	 * pop() and pop_batch() claim elements with a compare-and-swap on the dequeue position, so any thread may
+	 * pop (producers do so to drop the oldest element when the queue is full). Only one consumer may block in
+	 * wait().
+	 */
+	template <typename T>
+	class LockFreeQueue
+	{
+
+	private:
+
+		//! Queue slot, padded to a cache line so neighbouring producers do not share one
+		struct Slot
+		{
+			//! Slot sequence number
+			std::atomic<size_t> sequence;
+			//! Slot value
+			T value;
+		};
+
+		//! Preallocated slots
+		Slot *slots;
+		//! Slot stride in bytes (sizeof(Slot) rounded up to the cache line size)
+		size_t stride;
+		//! Capacity - 1 (capacity is a power of two)
+		size_t mask;
+		//! Next enqueue position
+		alignas(CACHE_LINE_SIZE) std::atomic<size_t> enqueuePos;
+		//! Next dequeue position
+		alignas(CACHE_LINE_SIZE) std::atomic<size_t> dequeuePos;
+		//! Number of published elements not yet popped (may briefly go negative)
+		alignas(CACHE_LINE_SIZE) std::atomic<long> pending;
+		//! Mutex guarding the consumer wait
+		std::mutex mtxWait;
+		//! Condition signalled when the oldest element is published
+		std::condition_variable cond;
+		//! Set by wake() to release a waiting consumer
+		bool woken;
+		//! Size reserved in each element (see reserve())
+		size_t valueReserve;
+		//! Doorbell rung when the oldest element is published (NULL for none)
+		Doorbell *doorbell;
+
+		//! Signal the consumer
+		void notify()
+		{
+			// Taking the lock orders the notification after the consumer's predicate check
+			{
+				std::lock_guard<std::mutex> lock(mtxWait);
+			}
+			cond.notify_one();
+			if (doorbell != NULL)
+				doorbell->Ring();
+		};
+
+		//! Retrieves the slot at given position
+		Slot& at(size_t pos)
+		{
+			return *reinterpret_cast<Slot *>(reinterpret_cast<char *>(slots) + (pos & mask) * stride);
+		};
+
+		//! Checks whether the slot at the dequeue position holds a published element (consumer side)
+		bool published()
+		{
+			// Pairs with the fence of try_push(): either the consumer sees the slot published, or its producer
+			// sees the consumer at the slot and signals it
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			size_t pos = dequeuePos.load(std::memory_order_relaxed);
+			return at(pos).sequence.load(std::memory_order_acquire) == pos + 1;
+		};
+
+		//! Rounds a capacity up to the next power of two
+		static size_t round_up(size_t capacity)
+		{
+			size_t size = 2;
+			while (size < capacity)
+				size <<= 1;
+			return size;
+		};
+
+		//! Allocates the slots of the queue (capacity is a power of two)
+		void allocate(size_t capacity)
+		{
+			mask = capacity - 1;
+			stride = (sizeof(Slot) + CACHE_LINE_SIZE - 1) & ~(size_t) (CACHE_LINE_SIZE - 1);
+			void *mem = NULL;
+			if (posix_memalign(&mem, CACHE_LINE_SIZE, stride * capacity) != 0)
+				throw std::bad_alloc();
+
+			slots = static_cast<Slot *>(mem);
+			for (size_t i = 0; i < capacity; i++) {
+				Slot *slot = new (&at(i)) Slot();
+				slot->sequence.store(i, std::memory_order_relaxed);
+				slot->value.reserve(valueReserve);
+			}
+			enqueuePos.store(0, std::memory_order_relaxed);
+			dequeuePos.store(0, std::memory_order_relaxed);
+			pending.store(0, std::memory_order_relaxed);
+		};
+
+		//! Releases the slots of the queue
+		void release()
+		{
+			for (size_t i = 0; i <= mask; i++)
+				at(i).~Slot();
+			free(slots);
+		};
+
+		// Non-copyable
+		LockFreeQueue(const LockFreeQueue&);
+		LockFreeQueue& operator=(const LockFreeQueue&);
+
+	public:
+
+		//! Constructor
+		/*! Allocates the slots of the queue.
+		 *
+		 * @param	capacity	The number of slots, rounded up to the next power of two.
+		 * @param	size		The size reserved in each element (see reserve()).
+		 */
+		explicit LockFreeQueue(size_t capacity = LOG_QUEUE_CAPACITY, size_t size = 0)
+		{
+			valueReserve = size;
+			allocate(round_up(capacity));
+			woken = false;
+			doorbell = NULL;
+		};
+
+		//! Destructor
+		~LockFreeQueue()
+		{
+			release();
+		};
+
+		/**
+		 * <b>Pop element from queue</b> <br>
+		 * Pop elements from queue, returning true if an item poped from the queue; false otherwise.
+		 *
+		 * @param	rslt	Reference to the element where the popped value is stored (swapped with the slot value).
+		 *
+		 * @return 	true is returned in the case that an item poped from the queue.
+		 *			Otherwise, false is returned.
+		 */
+		bool pop(T& rslt)
+		{
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			size_t pos = dequeuePos.load(std::memory_order_relaxed);
+			for (;;) {
+				Slot& slot = at(pos);
+				size_t seq = slot.sequence.load(std::memory_order_acquire);
+				intptr_t diff = (intptr_t) seq - (intptr_t) (pos + 1);
+				if (diff == 0) {
+					if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+						std::swap(rslt, slot.value);
+						slot.sequence.store(pos + mask + 1, std::memory_order_release);
+						pending.fetch_sub(1, std::memory_order_acq_rel);
+						return true;
+					}
+				} else if (diff < 0) {
+					return false;
+				} else {
+					pos = dequeuePos.load(std::memory_order_relaxed);
+				}
+			}
+		};
+
+		/**
+		 * <b>Pop a batch of elements from queue</b> <br>
+		 * Claims up to maxCount consecutive published elements with a single compare-and-swap and pops them.
+		 *
+		 * @param	rslt		Vector where the popped elements are stored (swapped with the slot values),
+		 *						starting at index offset.
+		 * @param	offset		Index of rslt where the first popped element is stored.
+		 * @param	maxCount	The maximum number of elements to pop.
+		 *
+		 * @return 	The number of popped elements.
+		 */
+		size_t pop_batch(std::vector<T>& rslt, size_t offset, size_t maxCount)
+		{
+			// The elements swapped into the slots keep the reserved size
+			for (size_t i = rslt.size(); i < offset + maxCount; i++) {
+				rslt.push_back(T());
+				rslt.back().reserve(valueReserve);
+			}
+
+			// See published()
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			size_t pos = dequeuePos.load(std::memory_order_relaxed);
+			size_t count;
+			for (;;) {
+				// Count the published slots from the current dequeue position
+				count = 0;
+				while (count < maxCount && count <= mask &&
+					at(pos + count).sequence.load(std::memory_order_acquire) == pos + count + 1)
+					count++;
+
+				if (count == 0)
+					return 0;
+				if (dequeuePos.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed))
+					break;
+			}
+
+			for (size_t i = 0; i < count; i++) {
+				Slot& slot = at(pos + i);
+				std::swap(rslt[offset + i], slot.value);
+				slot.sequence.store(pos + i + mask + 1, std::memory_order_release);
+			}
+			pending.fetch_sub((long) count, std::memory_order_acq_rel);
+			return count;
+		};
+
+		/**
+		 * <b>Try to push element to the queue</b><br>
+		 * Push an element to the queue, returning false without waiting if the queue is full.
+		 *
+		 * @param	src		The element that requires insertion.
+		 *
+		 * @return 	true is returned in the case that the element is pushed.
+		 *			Otherwise (queue is full), false is returned.
+		 */
+		bool try_push(const T& src)
+		{
+			size_t pos = enqueuePos.load(std::memory_order_relaxed);
+			for (;;) {
+				Slot& slot = at(pos);
+				size_t seq = slot.sequence.load(std::memory_order_acquire);
+				intptr_t diff = (intptr_t) seq - (intptr_t) pos;
+				if (diff == 0) {
+					if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+						slot.value = src;
+						slot.sequence.store(pos + 1, std::memory_order_release);
+						pending.fetch_add(1, std::memory_order_acq_rel);
+
+						// Signal the consumer only when this slot is the one it waits for: the producer of an
+						// earlier slot may still be writing it, then that producer signals once it publishes
+						std::atomic_thread_fence(std::memory_order_seq_cst);
+						if (dequeuePos.load(std::memory_order_relaxed) == pos)
+							notify();
+						return true;
+					}
+				} else if (diff < 0) {
+					return false;
+				} else {
+					pos = enqueuePos.load(std::memory_order_relaxed);
+				}
+			}
+		};
+
+		/**
+		 * <b>Push element to the queue</b><br>
+		 * Push an element to the queue, yielding while the queue is full.
+		 *
+		 * @param	src		The element that requires insertion.
+		 */
+		void push(const T& src)
+		{
+			while (!try_push(src))
+				std::this_thread::yield();
+		};
+
+		/**
+		 * <b>Number of elements</b><br>
+		 *
+		 * @return 	The number of published elements not yet popped (approximate while pushes are in flight).
+		 */
+		size_t size()
+		{
+			long count = pending.load(std::memory_order_acquire);
+			return count > 0 ? (size_t) count : 0;
+		};
+
+		/**
+		 * <b>Capacity</b><br>
+		 *
+		 * @return 	The number of slots.
+		 */
+		size_t capacity()
+		{
+			return mask + 1;
+		};
+
+		/**
+		 * <b>Change the capacity</b><br>
+		 * Reallocates the slots. The queue must be empty, with no producer or consumer using it.
+		 *
+		 * @param	capacity	The number of slots, rounded up to the next power of two.
+		 *
+		 * @return 	true is returned if the queue has the new capacity. Otherwise (queue is not empty), false is
+		 *			returned.
+		 */
+		bool resize(size_t capacity)
+		{
+			if (enqueuePos.load(std::memory_order_acquire) != dequeuePos.load(std::memory_order_acquire))
+				return false;
+			if (round_up(capacity) != mask + 1) {
+				release();
+				allocate(round_up(capacity));
+			}
+			return true;
+		};
+
+		/**
+		 * <b>Reserve the elements</b><br>
+		 * Reserve a size in each slot and in the elements pop_batch() adds to its vector, so that pushing
+		 * elements up to that size does not allocate (the elements need a reserve(size_t) method). The queue
+		 * must be empty, with no producer or consumer using it.
+		 *
+		 * @param	size	The size (0 for none).
+		 */
+		void reserve(size_t size)
+		{
+			valueReserve = size;
+			for (size_t i = 0; i <= mask; i++)
+				at(i).value.reserve(size);
+		};
+
+		/**
+		 * <b>Wait for elements</b><br>
+		 * Block the consumer until the oldest element is published, wake() is called or the timeout expires.
+		 *
+		 * @param	timeoutMs	The maximum time to wait in milliseconds, negative to wait indefinitely.
+		 */
+		void wait(int timeoutMs = -1)
+		{
+			std::unique_lock<std::mutex> lock(mtxWait);
+			if (timeoutMs < 0)
+				cond.wait(lock, [this]() { return published() || woken; });
+			else
+				cond.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this]() { return published() || woken; });
+			woken = false;
+		};
+
+		/**
+		 * <b>Set the doorbell</b><br>
+		 * Ring a doorbell shared with other queues when the oldest element is published, in addition to
+		 * signalling wait(). Set it before the queue is used.
+		 *
+		 * @param	bell	The doorbell (NULL for none).
+		 */
+		void set_doorbell(Doorbell *bell)
+		{
+			doorbell = bell;
+		};
+
+		/**
+		 * <b>Wake the consumer</b><br>
+		 * Release a consumer blocked in wait() even though the queue is empty.
+		 */
+		void wake()
+		{
+			{
+				std::lock_guard<std::mutex> lock(mtxWait);
+				woken = true;
+			}
+			cond.notify_one();
+		};
+	};
+
+	//! Lock-free wstring queue
+	typedef LockFreeQueue<std::wstring> LockFreeWStringQueue;
+
+	/**
+	 * @struct LogRecord
+	 *
+	 * @brief Log record passed from the logging threads to the write threads.
+	 *
+	 * A record either carries the formatted (UTF-8) log line (text), or with deferred formatting enabled, the
+	 * format string pointer (wide or narrow), the time stamp and the binary encoded arguments, which the write
+	 * thread formats.
+	 */
+	struct LogRecord
+	{
+		//! The log severity level
+		SeverityLevel level;
+		//! The 5 digit custom defined code
+		unsigned long code;
+		//! Time stamp in nanoseconds since epoch (deferred records)
+		long long timestamp;
+		//! The time stamp is a raw TSC value (see TscClock)
+		bool tscTimestamp;
+		//! Wide format string (deferred records), must stay valid until the record is written
+		const wchar_t *format;
+		//! UTF-8 format string (deferred records), must stay valid until the record is written
+		const char *narrowFormat;
+		//! Binary encoded arguments (deferred records)
+		std::string args;
+		//! Formatted log line in UTF-8 (immediate records)
+		std::string text;
+
+		//! Constructor
+		LogRecord() : level(INFO), code(0), timestamp(0), tscTimestamp(false), format(NULL), narrowFormat(NULL) { };
+
+		/**
+		 * Reserves the buffers of the record, so that assigning a record up to that size does not allocate.
+		 *
+		 * @param	size	The size of the log line in bytes (the encoded arguments get half of it).
+		 */
+		void reserve(size_t size)
+		{
+			text.reserve(size);
+			args.reserve(size / 2);
+		};
+	};
+
+#ifdef CPPLOGGER_USE_BLOCKING_QUEUE
+	//! Log record queue (mutex based fallback, enabled by defining CPPLOGGER_USE_BLOCKING_QUEUE)
+	typedef BlockingQueue<LogRecord> LogQueue;
+#else
+	//! Log record queue
+	typedef LockFreeQueue<LogRecord> LogQueue;
+#endif
+
+	/**
+	 * @class SysLogSocket
+	 *
+	 * @brief Persistent AF_UNIX datagram socket to the syslog daemon ('/dev/log'). Batches of pre-built datagrams
+	 * are sent with a single sendmmsg(); the socket reconnects when the daemon has restarted.
+	 */
+	class SysLogSocket
+	{
+
+	private:
+
+		//! Socket descriptor
+		int fd;
+		//! The socket path connected to
+		std::string path;
+		//! Message headers of a batch
+		std::vector<struct mmsghdr> headers;
+		//! I/O vectors of a batch
+		std::vector<struct iovec> iovecs;
+
+		//! <b>Connect to the syslog daemon.</b><br>
+		bool Open(const std::string& path);
+
+	public:
+
+		//! Constructor
+		SysLogSocket() : fd(-1) { };
+
+		//! Destructor
+		~SysLogSocket()
+		{
+			Close();
+		};
+
+		//! <b>Send a batch of datagrams.</b><br>
+		bool Send(const LogRecord *records, size_t count, const std::string& path);
+
+		//! <b>Close the socket.</b><br>
+		void Close();
+	};
+
+	/**
+	 * @class LoggerUtil
+	 *
+	 * @brief Utility class which provides helper functions to logging operations.
+	 */
+	class LoggerUtil
+	{
+
+	public:
+		
+		//! <b>Check file existence.</b><br>
+		static bool FileExists(const std::string& fileName);
+
+		//! <b>Get time stamp in 'yyyy-MM-dd HH:mm:ss.SSS' format.</b><br>
+		static void GetTimeString(wchar_t *dst);
+
+		//! <b>Get given time stamp (nanoseconds since epoch) in the given format.</b><br>
+		static size_t GetTimeString(char *dst, long long timestamp, TimestampFormat format = TIMESTAMP_LOCAL);
+
+		//! <b>Get current time stamp in nanoseconds since epoch.</b><br>
+		static long long GetTimestamp(bool coarse = false);
+
+		//! <b>Encode a code point to UTF-8.</b><br>
+		static size_t EncodeUtf8(uint32_t codePoint, char *dst);
+
+		//! <b>Append a wide string converted to UTF-8.</b><br>
+		static void ToUtf8(const wchar_t *src, size_t len, std::string& dst);
+
+		//! <b>Convert a wide string to UTF-8.</b><br>
+		static std::string ToUtf8(const std::wstring& src);
+
+		//! <b>Append the log line (time stamp, severity, code and message) to a string.</b><br>
+		static bool FormatLine(std::string& dst, SeverityLevel level, unsigned long code, const char *time,
+			const char *msg, size_t msgLen);
+
+		//! <b>Encode the arguments of a format string to binary.</b><br>
+		static void EncodeArgs(const wchar_t *format, va_list args, std::string& dst);
+
+		//! <b>Encode the arguments of a UTF-8 format string to binary.</b><br>
+		static void EncodeArgs(const char *format, va_list args, std::string& dst);
+
+		//! <b>Write formatted data from a format string and its binary encoded arguments.</b><br>
+		static int FormatArgs(wchar_t *dst, size_t len, const wchar_t *format, const char *args, size_t argsLen);
+
+		//! <b>Write formatted data from a UTF-8 format string and its binary encoded arguments.</b><br>
+		static int FormatArgs(char *dst, size_t len, const char *format, const char *args, size_t argsLen);
+
+		//! <b>Append the (UTF-8) log line of a log record to a string.</b><br>
+		static bool FormatRecord(std::string& dst, const LogRecord& record);
+
+		//! <b>Validate file/directory permission.</b><br>
+		static int HasPermissions(const char* dirPath);
+
+		//! <b>Set sleep to the process.</b><br>
+		static void Sleep(unsigned int milliseconds);
+
+		//! <b>Write formatted data to wstring (wstring version sprintf).</b><br>
+		static wstring StrFormat(const wchar_t* format, ...);
+	};
+
+	/**
+	 * @class TscClock
+	 *
+	 * @brief Time stamp counter (rdtsc) clock. The logging threads stamp deferred records with the raw counter,
+	 * and the write threads convert it to wall clock time with the conversion calibrated by Calibrate().
+	 */
+	class TscClock
+	{
+
+	public:
+
+		//! <b>Check whether the CPU has an invariant (constant rate, non-stop) time stamp counter.</b><br>
+		static bool IsInvariant();
+
+		//! <b>Sample the time stamp counter against the wall clock and update the conversion.</b><br>
+		static void Calibrate();
+
+		//! <b>Convert a time stamp counter value to nanoseconds since epoch.</b><br>
+		static long long ToNanoseconds(unsigned long long tsc);
+
+		/**
+		 * Reads the time stamp counter.
+		 *
+		 * @return	The time stamp counter value (0 on CPUs without a time stamp counter).
+		 */
+		static unsigned long long Read()
+		{
+#if defined(__x86_64__) || defined(__i386__)
+			return __rdtsc();
+#else
+			return 0;
+#endif
+		};
+	};
+
+	/**
+	 * @struct FormatStringBase
+	 *
+	 * @brief Base of the compile-time format strings created by CPPLOGGER_FMT().
+	 */
+	struct FormatStringBase { };
+
+	/**
+	 * @struct FormatBuffer
+	 *
+	 * @brief Fixed size buffer the type-safe logging interfaces format the message to (truncates on overflow).
+	 */
+	struct FormatBuffer
+	{
+		//! Formatted characters
+		char data[MAX_LEN_FMT_BUFFER];
+		//! Number of formatted characters
+		size_t len;
+
+		//! Constructor
+		FormatBuffer() : len(0) { };
+
+		//! Append characters to the buffer
+		void append(const char *src, size_t n)
+		{
+			if (n > MAX_LEN_FMT_BUFFER - 1 - len)
+				n = MAX_LEN_FMT_BUFFER - 1 - len;
+			memcpy(data + len, src, n);
+			len += n;
+		};
+
+		//! Append a character to the buffer
+		void append(char c)
+		{
+			if (len < MAX_LEN_FMT_BUFFER - 1)
+				data[len++] = c;
+		};
+
+		//! Retrieves the formatted characters as C-string
+		const char *c_str()
+		{
+			data[len] = '\0';
+			return data;
+		};
+	};
+
+	/**
+	 * @class LogFormatter
+	 *
+	 * @brief Formatter of the type-safe logging interfaces. The format string is validated at compile time by
+	 * CountPlaceholders() and each argument is written by the FormatArg() overload of its type.
+	 */
+	class LogFormatter
+	{
+
+	public:
+
+		/**
+		 * Counts the '{}' placeholders of a format string at compile time.
+		 *
+		 * @param	format	The format string.
+		 * @param	count	The number of placeholders counted so far.
+		 *
+		 * @return	The number of placeholders, or -1 if the format string has an unmatched brace.
+		 */
+		static constexpr int CountPlaceholders(const char *format, int count = 0)
+		{
+			return *format == '\0' ? count
+				: (format[0] == '{' && format[1] == '{') ? CountPlaceholders(format + 2, count)
+				: (format[0] == '}' && format[1] == '}') ? CountPlaceholders(format + 2, count)
+				: (format[0] == '{' && format[1] == '}') ? CountPlaceholders(format + 2, count + 1)
+				: (format[0] == '{' || format[0] == '}') ? -1
+				: CountPlaceholders(format + 1, count);
+		};
+
+		//! <b>Copy the literal text of a format string up to the next placeholder.</b><br>
+		static const char *CopyLiteral(FormatBuffer& dst, const char *format);
+
+		//! <b>Write an unsigned integer.</b><br>
+		static void FormatUnsigned(FormatBuffer& dst, unsigned long long value, bool negative);
+
+		//! <b>Write a floating point value.</b><br>
+		static void FormatDouble(FormatBuffer& dst, long double value);
+
+		//! <b>Write a wide string.</b><br>
+		static void FormatWide(FormatBuffer& dst, const wchar_t *value, size_t len);
+
+		//! <b>Write a pointer value.</b><br>
+		static void FormatPointer(FormatBuffer& dst, const void *value);
+
+		//! Write a signed integer
+		static void FormatSigned(FormatBuffer& dst, long long value)
+		{
+			FormatUnsigned(dst, value < 0 ? 0ULL - (unsigned long long) value : (unsigned long long) value, value < 0);
+		};
+
+		//! Write a boolean value
+		static void FormatArg(FormatBuffer& dst, bool value) { value ? dst.append("true", 4) : dst.append("false", 5); };
+		//! Write a character
+		static void FormatArg(FormatBuffer& dst, char value) { dst.append(value); };
+		//! Write a signed char value
+		static void FormatArg(FormatBuffer& dst, signed char value) { FormatSigned(dst, value); };
+		//! Write an unsigned char value
+		static void FormatArg(FormatBuffer& dst, unsigned char value) { FormatUnsigned(dst, value, false); };
+		//! Write a short value
+		static void FormatArg(FormatBuffer& dst, short value) { FormatSigned(dst, value); };
+		//! Write an unsigned short value
+		static void FormatArg(FormatBuffer& dst, unsigned short value) { FormatUnsigned(dst, value, false); };
+		//! Write an int value
+		static void FormatArg(FormatBuffer& dst, int value) { FormatSigned(dst, value); };
+		//! Write an unsigned int value
+		static void FormatArg(FormatBuffer& dst, unsigned int value) { FormatUnsigned(dst, value, false); };
+		//! Write a long value
+		static void FormatArg(FormatBuffer& dst, long value) { FormatSigned(dst, value); };
+		//! Write an unsigned long value
+		static void FormatArg(FormatBuffer& dst, unsigned long value) { FormatUnsigned(dst, value, false); };
+		//! Write a long long value
+		static void FormatArg(FormatBuffer& dst, long long value) { FormatSigned(dst, value); };
+		//! Write an unsigned long long value
+		static void FormatArg(FormatBuffer& dst, unsigned long long value) { FormatUnsigned(dst, value, false); };
+		//! Write a float value
+		static void FormatArg(FormatBuffer& dst, float value) { FormatDouble(dst, value); };
+		//! Write a double value
+		static void FormatArg(FormatBuffer& dst, double value) { FormatDouble(dst, value); };
+		//! Write a long double value
+		static void FormatArg(FormatBuffer& dst, long double value) { FormatDouble(dst, value); };
+		//! Write a C-string
+		static void FormatArg(FormatBuffer& dst, const char *value)
+		{
+			value ? dst.append(value, strlen(value)) : dst.append("(null)", 6);
+		};
+		//! Write a string
+		static void FormatArg(FormatBuffer& dst, const std::string& value) { dst.append(value.data(), value.size()); };
+		//! Write a C-wstring
+		static void FormatArg(FormatBuffer& dst, const wchar_t *value)
+		{
+			value ? FormatWide(dst, value, wcslen(value)) : dst.append("(null)", 6);
+		};
+		//! Write a wstring
+		static void FormatArg(FormatBuffer& dst, const std::wstring& value) { FormatWide(dst, value.data(), value.size()); };
+		//! Write a mutable C-string (an exact match, so it is not taken for a pointer)
+		static void FormatArg(FormatBuffer& dst, char *value) { FormatArg(dst, (const char *) value); };
+		//! Write a mutable C-wstring
+		static void FormatArg(FormatBuffer& dst, wchar_t *value) { FormatArg(dst, (const wchar_t *) value); };
+		//! Write a pointer value
+		template <typename T>
+		static void FormatArg(FormatBuffer& dst, T *value) { FormatPointer(dst, value); };
+
+		//! Write the remaining literal text of the format string
+		static void Format(FormatBuffer& dst, const char *format)
+		{
+			while (*format)
+				format = CopyLiteral(dst, format);
+		};
+
+		//! Write the literal text up to the next placeholder, the argument and the rest of the format string
+		template <typename T, typename... Args>
+		static void Format(FormatBuffer& dst, const char *format, const T& value, const Args&... args)
+		{
+			format = CopyLiteral(dst, format);
+			FormatArg(dst, value);
+			Format(dst, format, args...);
+		};
+	};
+
+	//! Compile-time check of the placeholder/argument count of a CPPLOGGER_FMT() format string
+	#define CPPLOGGER_CHECK_FMT(F, Args) \
+		static_assert(LogFormatter::CountPlaceholders(F::Value()) == (int) sizeof...(Args), \
+			"cpplogger: the number of {} placeholders does not match the number of arguments")
+
+	/**
+	 * @enum SysLogFormat
+	 *
+	 * @brief Enumerator which defines the format of the syslog datagrams. <br>
+	 * Available formats are:
+	 *
+	 * <b>SYSLOG_RFC3164(0)</b>	<br>'&lt;PRI&gt;Mmm dd hh:mm:ss TAG[PID]: MSG', the format of syslog(3).
+	 *
+	 * <b>SYSLOG_RFC5424(1)</b>	<br>'&lt;PRI&gt;1 TIMESTAMP HOSTNAME APP-NAME PROCID - - MSG'.
+	 */
+	enum SysLogFormat
+	{
+		SYSLOG_RFC3164 = 0,
+		SYSLOG_RFC5424 = 1
+	};
+
+	/**
+	 * @enum CompressionType
+	 *
+	 * @brief Enumerator which defines the compression of the rotated log files. <br>
+	 * Available compression types are:
+	 *
+	 * <b>COMPRESSION_NONE(0)</b>	<br>Rotated files are not compressed.
+	 *
+	 * <b>COMPRESSION_GZIP(1)</b>	<br>gzip ('.gz'), requires building with -DCPPLOGGER_HAVE_ZLIB -lz.
+	 *
+	 * <b>COMPRESSION_ZSTD(2)</b>	<br>Zstandard ('.zst'), requires building with -DCPPLOGGER_HAVE_ZSTD -lzstd.
+	 */
+	enum CompressionType
+	{
+		COMPRESSION_NONE = 0,
+		COMPRESSION_GZIP = 1,
+		COMPRESSION_ZSTD = 2
+	};
+
+	/**
+	 * @enum OverflowPolicy
+	 *
+	 * @brief What a logging thread does with a record when the log queue is full. <br>
+	 * Available policies are:
+	 *
+	 * <b>OVERFLOW_BLOCK(0)</b>			<br>Wait for the write thread to make room (default).
+	 *
+	 * <b>OVERFLOW_DROP_NEWEST(1)</b>	<br>Drop the record.
+	 *
+	 * <b>OVERFLOW_DROP_OLDEST(2)</b>	<br>Drop the oldest queued record to make room.
+	 *
+	 * <b>OVERFLOW_DROP_BELOW(3)</b>		<br>Drop the record if its severity is below QueueOptions::dropBelow,
+	 *									wait otherwise.
+	 */
+	enum OverflowPolicy
+	{
+		OVERFLOW_BLOCK = 0,
+		OVERFLOW_DROP_NEWEST = 1,
+		OVERFLOW_DROP_OLDEST = 2,
+		OVERFLOW_DROP_BELOW = 3
+	};
+
+	/**
+	 * @struct QueueOptions
+	 *
+	 * @brief Capacity and overflow policy of a log queue. The queue holds at most capacity records, so the memory
+	 * of a channel stays bounded when its file cannot keep up.
+	 */
+	struct QueueOptions
+	{
+		//! Maximum number of queued records (rounded up to a power of two by the lock-free queue)
+		size_t capacity;
+		//! What to do with a record when the queue is full
+		OverflowPolicy overflow;
+		//! Records below this severity are dropped when the queue is full (OVERFLOW_DROP_BELOW)
+		SeverityLevel dropBelow;
+		//! Bytes reserved per queued record, records up to this size are queued without allocating
+		size_t recordReserve;
+
+		//! Constructor
+		QueueOptions()
+			: capacity(LOG_QUEUE_CAPACITY), overflow(OVERFLOW_BLOCK), dropBelow(WARNING), recordReserve(LOG_RECORD_RESERVE) { };
+	};
+
+	/**
+	 * @struct LoggerOptions
+	 *
+	 * @brief Options passed to Logger::Init(). The rotation options apply to each of the application, debug and
+	 * event log files: the write thread renames 'file' to 'file.1' (shifting 'file.1' to 'file.2' and so on) and
+	 * opens a new file.
+	 */
+	struct LoggerOptions
+	{
+		//! Rotate a log file before it grows beyond this size in bytes (0 disables size based rotation)
+		size_t rotateSize;
+		//! Rotate the log files every interval seconds, aligned to local time (0 disables time based rotation)
+		unsigned int rotateIntervalSec;
+		//! Number of rotated files kept per log file (0 keeps all)
+		unsigned int maxFiles;
+		//! Compression of the rotated files, done by a background thread at idle priority
+		CompressionType compression;
+		//! Maximum rate (bytes per second) the background thread reads the rotated files at (0 for no limit)
+		size_t compressRate;
+		//! Write the log files in the binary log format (see BinaryLogWriter, decoded by cpplogger-decode)
+		bool binaryFormat;
+		//! Append a time index entry ('file.idx') once this many bytes are written since the last one (0 disables)
+		size_t indexInterval;
+		//! Application log queue
+		QueueOptions aplQueue;
+		//! Debug log queue
+		QueueOptions dbgQueue;
+		//! Event log queue
+		QueueOptions evntQueue;
+		//! Collapse identical consecutive records into 'last message repeated N times', reported at the latest
+		//! this many milliseconds after the first repeat (0 disables)
+		unsigned int repeatFlushMs;
+		//! Socket of the syslog daemon the syslog interfaces send to
+		std::string sysLogPath;
+		//! Format of the syslog datagrams
+		SysLogFormat sysLogFormat;
+		//! Syslog facility (LOG_USER, LOG_LOCAL0, ...)
+		int sysLogFacility;
+		//! Syslog tag (APP-NAME), the program name if empty
+		std::string sysLogIdent;
+		//! Number of writer threads servicing the sinks (0 is treated as 1)
+		unsigned int writerThreads;
+		//! CPUs the background threads (writer, compression and TSC calibration) are pinned to (empty for any CPU)
+		std::vector<int> writerCpus;
+		//! Scheduling policy of the writer threads (SCHED_OTHER, SCHED_BATCH or SCHED_IDLE)
+		int writerPolicy;
+		//! Nice value of the writer threads (-20 to 19, below 0 needs CAP_SYS_NICE)
+		int writerNice;
+		//! Name prefix of the background threads as seen in top and perf ('cpplogger-w0', 'cpplogger-gz', ...)
+		std::string threadName;
+		//! Give each NUMA node its own queue per sink, allocated on the node and merged by time stamp
+		bool numaQueues;
+
+		//! Constructor
+		LoggerOptions()
+			: rotateSize(0), rotateIntervalSec(0), maxFiles(ROTATE_MAX_FILES_DEFAULT), compression(COMPRESSION_NONE),
+			compressRate(COMPRESS_RATE_DEFAULT), binaryFormat(false), indexInterval(INDEX_INTERVAL_DEFAULT),
+			repeatFlushMs(0), sysLogPath(SYSLOG_PATH_DEFAULT), sysLogFormat(SYSLOG_RFC3164), sysLogFacility(LOG_USER),
+			writerThreads(WRITER_THREADS_DEFAULT), writerPolicy(SCHED_OTHER), writerNice(0),
+			threadName(THREAD_NAME_DEFAULT), numaQueues(false) { };
+	};
+
+	/**
+	 * @class MappedFile
+	 *
+	 * @brief Append-only file written through memory-mapped extents. Each extent is preallocated with
+	 * fallocate() and mapped, records are copied to the mapped region at the tail, and Close() trims the file
+	 * to the written length. A file left by a killed process ends with the NUL filled rest of its last extent,
+	 * which Open() skips.
+	 */
+	class MappedFile
+	{
+
+	private:
+
+		//! File descriptor
+		int fd;
+		//! The mapped extent
+		char *base;
+		//! File offset of the mapped extent
+		size_t mapOffset;
+		//! Length of the mapped extent
+		size_t mapLength;
+		//! File offset the next write goes to
+		size_t tail;
+		//! Extent size
+		size_t extentSize;
+
+		//! <b>Preallocate and map the extent containing a file offset.</b><br>
+		bool Map(size_t offset);
+
+	public:
+
+		//! Constructor
+		MappedFile();
+
+		//! Destructor
+		~MappedFile();
+
+		//! <b>Open (or create) the file for appending.</b><br>
+		bool Open(const std::string& path, size_t extentSize = MMAP_EXTENT_SIZE, bool trimNul = true);
+
+		//! <b>Append data to the file.</b><br>
+		bool Write(const char *data, size_t len);
+
+		//! <b>Unmap the file and trim it to the written length.</b><br>
+		void Close();
+
+		/**
+		 * Checks whether the file is open.
+		 *
+		 * @return	true is returned if the file is open. Otherwise, false is returned.
+		 */
+		bool IsOpen() const
+		{
+			return base != NULL;
+		};
+
+		/**
+		 * Gets the written length of the file.
+		 *
+		 * @return	The file offset the next write goes to.
+		 */
+		size_t Size() const
+		{
+			return tail;
+		};
+	};
+
+	/**
+	 * @class UringFile
+	 *
+	 * @brief Append-only file written asynchronously through io_uring (raw system calls, no liburing). Data is
+	 * copied to one of URING_BUFFER_COUNT registered buffers and submitted as a fixed buffer write at the tail
+	 * offset, so the caller continues while earlier writes are in flight; it only waits when every buffer is
+	 * in flight.
+	 */
+	class UringFile
+	{
+
+	private:
+
+		//! A write buffer
+		struct Buffer
+		{
+			//! The buffer (URING_BUFFER_SIZE bytes)
+			char *data;
+			//! File offset of the data
+			size_t offset;
+			//! Length of the data
+			size_t len;
+			//! Bytes written so far
+			size_t done;
+			//! The write is in flight
+			bool inFlight;
+		};
+
+		//! File descriptor
+		int fd;
+		//! io_uring file descriptor
+		int ringFd;
+		//! File offset the next write goes to
+		size_t tail;
+		//! A write has failed
+		bool failed;
+		//! The buffers are registered (fixed buffer writes)
+		bool fixedBuffers;
+		//! The write buffers
+		Buffer buffers[URING_BUFFER_COUNT];
+
+		//! Submission queue ring
+		void *sqRing;
+		//! Submission queue ring size
+		size_t sqRingSize;
+		//! Completion queue ring (same as sqRing with IORING_FEAT_SINGLE_MMAP)
+		void *cqRing;
+		//! Completion queue ring size
+		size_t cqRingSize;
+		//! Submission queue entries
+		void *sqes;
+		//! Submission queue entries size
+		size_t sqesSize;
+		//! Submission queue tail/mask/array
+		unsigned int *sqTail, *sqMask, *sqArray;
+		//! Completion queue head/tail/mask
+		unsigned int *cqHead, *cqTail, *cqMask;
+		//! Completion queue entries
+		void *cqes;
+
+		//! <b>Submit the (remaining) write of a buffer.</b><br>
+		bool Submit(int index);
+
+		//! <b>Process the completed writes, optionally waiting for one.</b><br>
+		void Reap(bool wait);
+
+	public:
+
+		//! Constructor
+		UringFile();
+
+		//! Destructor
+		~UringFile();
+
+		//! <b>Open (or create) the file for appending.</b><br>
+		bool Open(const std::string& path);
+
+		//! <b>Append data to the file (asynchronously).</b><br>
+		bool Write(const char *data, size_t len);
+
+		//! <b>Wait for the writes in flight.</b><br>
+		void Flush();
+
+		//! <b>Wait for the writes in flight and close the file.</b><br>
+		void Close();
+
+		/**
+		 * Checks whether the file is open.
+		 *
+		 * @return	true is returned if the file is open. Otherwise, false is returned.
+		 */
+		bool IsOpen() const
+		{
+			return ringFd >= 0;
+		};
+	};
+
+	/**
+	 * @enum BinaryLogEntry
+	 *
+	 * @brief Entry types of the binary log format. A binary log file is a sequence of sessions, each starting with
+	 * the BINLOG_MAGIC header (written whenever the write thread opens the file), followed by entries made of the
+	 * entry type byte and its fields in host byte order. NUL bytes between entries are skipped (the rest of the
+	 * last extent of a memory-mapped file whose writer was killed).
+	 */
+	enum BinaryLogEntry
+	{
+		//! Format string: uint32 id, uint8 wide, uint32 size in bytes, the characters (without terminator)
+		BINLOG_ENTRY_FORMAT = 1,
+		//! Deferred record: uint32 format id, uint8 level, uint32 code, int64 time stamp (ns), uint32 size, arguments
+		BINLOG_ENTRY_RECORD = 2,
+		//! Formatted log line: uint32 size, the UTF-8 line (without newline)
+		BINLOG_ENTRY_TEXT = 3
+	};
+
+	/**
+	 * @class BinaryLogWriter
+	 *
+	 * @brief Encodes log records to the binary log format. Deferred records are stored as the format string ID,
+	 * severity, code, time stamp and the arguments encoded by LoggerUtil::EncodeArgs(), and each format string is
+	 * written to the dictionary once per session. Formatted records are stored as text entries.
+	 */
+	class BinaryLogWriter
+	{
+
+	private:
+
+		//! A format string of the dictionary
+		struct FormatEntry
+		{
+			//! The format string ID
+			uint32_t id;
+			//! The format string characters, checks that the pointer still refers to the same string
+			std::string bytes;
+		};
+
+		//! The dictionary, keyed by the format string pointer
+		std::unordered_map<const void *, FormatEntry> formats;
+		//! The next format string ID
+		uint32_t nextId;
+		//! The session header has been written
+		bool hasHeader;
+
+	public:
+
+		//! Constructor
+		BinaryLogWriter();
+
+		//! <b>Start a new session (a newly opened file), clearing the dictionary.</b><br>
+		void Reset();
+
+		//! <b>Append the binary entries of a log record to a buffer.</b><br>
+		void Append(std::string& dst, const LogRecord& record);
+	};
+
+	/**
+	 * @class BinaryLogReader
+	 *
+	 * @brief Decodes a binary log file back to the log lines of the text format.
+	 */
+	class BinaryLogReader
+	{
+
+	private:
+
+		//! The dictionary of the current session, indexed by the format string ID
+		std::vector<std::string> formats;
+		//! The format strings are wide
+		std::vector<bool> wideFormats;
+		//! The time stamp format of the current session
+		TimestampFormat timestampFormat;
+		//! The input is not a valid binary log
+		bool corrupt;
+
+	public:
+
+		//! Constructor
+		BinaryLogReader();
+
+		//! <b>Read the next log line.</b><br>
+		bool ReadLine(std::istream& in, std::string& line);
+
+		/**
+		 * Checks whether ReadLine() stopped on invalid input (rather than at the end of the input).
+		 *
+		 * @return	true is returned if the input is not a valid binary log. Otherwise, false is returned.
+		 */
+		bool IsCorrupt() const
+		{
+			return corrupt;
+		};
+	};
+
+	/**
+	 * @struct LogIndexEntry
+	 *
+	 * @brief Entry of the time index of a log file ('file.idx'). The write thread appends an entry every
+	 * LoggerOptions::indexInterval bytes, at the start of a batch.
+	 */
+	struct LogIndexEntry
+	{
+		//! The oldest time stamp of the batch (nanoseconds since epoch)
+		int64_t timestamp;
+		//! The file offset of the batch
+		uint64_t offset;
+	};
+
+	/**
+	 * @struct LogLine
+	 *
+	 * @brief Log line read by LogReader.
+	 */
+	struct LogLine
+	{
+		//! Time stamp of the line (nanoseconds since epoch, at the resolution of the time stamp format)
+		long long timestamp;
+		//! The log line (without newline)
+		std::string text;
+	};
+
+	/**
+	 * @class LogReader
+	 *
+	 * @brief Reads the lines of a time range from (text format) log files, seeking to the range through the time
+	 * index of the file when there is one.
+	 */
+	class LogReader
+	{
+
+	public:
+
+		//! <b>Parse the time stamp at the start of a log line (any TimestampFormat).</b><br>
+		static long long ParseTimestamp(const char *line, size_t len);
+
+		//! <b>Find the file offsets to read a time range from, using the time index of the file.</b><br>
+		static void FindRange(const std::string& path, long long from, long long to, size_t& begin, size_t& end);
+
+		//! <b>Read the lines of a log file within a time range.</b><br>
+		static bool ReadRange(const std::string& path, long long from, long long to, std::vector<LogLine>& lines);
+	};
+
+	/**
+	 * @struct DropCounts
+	 *
+	 * @brief Number of records a log queue has dropped on overflow, per severity level.
+	 */
+	struct DropCounts
+	{
+		//! Records dropped since the last summary line
+		std::atomic<unsigned long> pending[SEVERITY_LEVEL_COUNT];
+		//! Records dropped since the process started
+		std::atomic<unsigned long> total[SEVERITY_LEVEL_COUNT];
+		//! Some records are dropped since the last summary line
+		std::atomic<bool> hasPending;
+
+		//! Constructor
+		DropCounts()
+		{
+			for (int i = 0; i < SEVERITY_LEVEL_COUNT; i++) {
+				pending[i].store(0, std::memory_order_relaxed);
+				total[i].store(0, std::memory_order_relaxed);
+			}
+			hasPending.store(false, std::memory_order_relaxed);
+		};
+
+		//! <b>Count a dropped record.</b><br>
+		void Add(SeverityLevel level);
+
+		//! <b>Take the records dropped since the last summary line and describe them.</b><br>
+		unsigned long TakePending(std::string& summary);
+	};
+
+	/**
+	 * @class RepeatFilter
+	 *
+	 * @brief Collapses identical consecutive records of a log file into the first one and a 'last message repeated
+	 * N times' record, the way syslogd does. Deferred records are compared by their format string pointer and
+	 * encoded arguments, immediate records by their formatted message; the time stamps are not compared.
+	 */
+	class RepeatFilter
+	{
+
+	private:
+
+		//! The last record kept
+		LogRecord last;
+		//! The last record is set
+		bool hasLast;
+		//! Repeats of the last record collapsed since the last summary
+		unsigned long repeats;
+		//! Time stamp of the last collapsed repeat (ns since epoch)
+		long long repeatTimestamp;
+		//! Time the collapsed repeats are reported at the latest (ms, steady clock)
+		long long deadline;
+		//! The records kept, swapped with the batch
+		std::vector<LogRecord> kept;
+
+		//! <b>Check whether a record repeats the last record kept.</b><br>
+		bool IsRepeat(const LogRecord& record) const;
+
+		//! <b>Make the summary record of the collapsed repeats.</b><br>
+		void MakeSummary(LogRecord& record);
+
+	public:
+
+		//! Constructor
+		RepeatFilter() : hasLast(false), repeats(0), repeatTimestamp(0), deadline(0) { };
+
+		//! <b>Collapse the repeated records of a batch.</b><br>
+		size_t Collapse(std::vector<LogRecord>& batch, size_t count, unsigned int flushMs, bool flush);
+
+		//! <b>Get the time until the collapsed repeats are due to be reported.</b><br>
+		long long GetRemaining() const;
+
+		/**
+		 * Checks whether some collapsed repeats are not reported yet.
+		 *
+		 * @return	true is returned if some repeats are pending. Otherwise, false is returned.
+		 */
+		bool IsPending() const
+		{
+			return repeats > 0;
+		};
+	};
+
+	/**
+	 * @class RateLimiter
+	 *
+	 * @brief Lock-free token buckets limiting the log records per message code (or per call site). Each bucket
+	 * keeps the theoretical arrival time of its next record (GCRA, equivalent to a token bucket of burst tokens
+	 * refilled at rate tokens per second) in a single atomic, so the check is a hash lookup and a compare-and-swap,
+	 * done before the record is formatted. Buckets are claimed on first use in a fixed open addressing table.
+	 */
+	class RateLimiter
+	{
+
+	private:
+
+		//! Token bucket of a message code (or call site)
+		struct Bucket
+		{
+			//! Hash of the severity level, code and call site (0 for a free bucket)
+			std::atomic<uint64_t> key;
+			//! Severity level of the records
+			std::atomic<int> level;
+			//! Code of the records
+			std::atomic<unsigned long> code;
+			//! Theoretical arrival time of the next record (ns, monotonic clock)
+			std::atomic<long long> arrival;
+			//! Records suppressed since the last summary
+			std::atomic<unsigned long> suppressed;
+			//! Time of the next summary (ns, monotonic clock)
+			std::atomic<long long> nextSummary;
+		};
+
+		//! Rate limit of a message code
+		struct Limit
+		{
+			//! Severity level and code (0 for a free entry)
+			std::atomic<uint64_t> key;
+			//! Interval between two records (ns, 0 for no limit)
+			std::atomic<long long> interval;
+			//! Number of records allowed at once
+			std::atomic<unsigned int> burst;
+		};
+
+		//! The buckets
+		Bucket buckets[RATE_LIMIT_BUCKETS];
+		//! The limits set per code
+		Limit limits[RATE_LIMIT_CODES];
+		//! Number of limits set per code
+		std::atomic<unsigned int> limitCount;
+		//! Interval between two records of a code without its own limit (ns, 0 for no limit)
+		std::atomic<long long> defaultInterval;
+		//! Number of records of a code without its own limit allowed at once
+		std::atomic<unsigned int> defaultBurst;
+		//! Some limit is set
+		std::atomic<bool> enabled;
+		//! Limit per call site (format string) instead of per code
+		std::atomic<bool> perCallSite;
+
+		//! <b>Find the limit of a code.</b><br>
+		void FindLimit(SeverityLevel level, unsigned long code, long long& interval, unsigned int& burst);
+
+	public:
+
+		//! Constructor
+		RateLimiter();
+
+		//! <b>Set the limit of the codes without their own limit.</b><br>
+		void SetDefault(unsigned int rate, unsigned int burst, bool perCallSite);
+
+		//! <b>Set the limit of a code.</b><br>
+		bool SetLimit(SeverityLevel level, unsigned long code, unsigned int rate, unsigned int burst);
+
+		//! <b>Check whether a record may be written, taking a token from its bucket.</b><br>
+		bool Allow(SeverityLevel level, unsigned long code, const void *callSite, unsigned long& suppressed);
+
+		//! <b>Take the records suppressed since the last summary of a bucket.</b><br>
+		bool TakeSuppressed(size_t index, SeverityLevel& level, unsigned long& code, unsigned long& suppressed);
+
+		/**
+		 * Checks whether a limit is set.
+		 *
+		 * @return	true is returned if a limit is set. Otherwise, false is returned.
+		 */
+		bool IsEnabled() const
+		{
+			return enabled.load(std::memory_order_relaxed);
+		};
+	};
+
+	/**
+	 * @class NumaTopology
+	 *
+	 * @brief The NUMA nodes of the host and their CPUs, read from sysfs. The nodes are indexed in the order of
+	 * their IDs, a host without NUMA has a single node.
+	 */
+	class NumaTopology
+	{
+
+	private:
+
+		//! CPUs of each node
+		std::vector<std::vector<int> > nodeCpus;
+		//! Node of each CPU
+		std::vector<unsigned char> cpuNodes;
+
+	public:
+
+		//! <b>Read the nodes and their CPUs from a sysfs node directory.</b><br>
+		bool Load(const std::string& root = NUMA_NODE_PATH);
+
+		//! <b>Parse a CPU list ('0-3,8,10-11').</b><br>
+		static bool ParseCpuList(const std::string& list, std::vector<int>& cpus);
+
+		/**
+		 * Gets the number of nodes.
+		 *
+		 * @return	The number of nodes, 0 until loaded.
+		 */
+		size_t Count() const
+		{
+			return nodeCpus.size();
+		};
+
+		/**
+		 * Gets the node of a CPU.
+		 *
+		 * @param	cpu	The CPU (e.g. sched_getcpu()).
+		 *
+		 * @return	The node index, 0 for an unknown CPU.
+		 */
+		size_t NodeOf(int cpu) const
+		{
+			return cpu >= 0 && (size_t) cpu < cpuNodes.size() ? cpuNodes[cpu] : 0;
+		};
+
+		/**
+		 * Gets the CPUs of a node.
+		 *
+		 * @param	node	The node index.
+		 *
+		 * @return	The CPUs.
+		 */
+		const std::vector<int>& Cpus(size_t node) const
+		{
+			return nodeCpus[node];
+		};
+	};
+
+	class LogSink;
+
+	/**
+	 * @struct PushSlot
+	 *
+	 * @brief The sink a logging thread is pushing to, on a cache line of its own so that the threads do not share
+	 * a line on the push path.
+	 */
+	struct alignas(CACHE_LINE_SIZE) PushSlot
+	{
+		//! The sink the thread is pushing to (NULL when not pushing)
+		std::atomic<LogSink *> sink;
+		//! Owned by a thread
+		std::atomic<bool> inUse;
+		//! Next slot of the list
+		PushSlot *next;
+	};
+
+	/**
+	 * @class PushSlots
 	 *
-	 * @brief Class which implements logger general exception handler.
+	 * @brief Push slots of the logging threads. A thread takes a slot on its first log call and returns it when it
+	 * exits, the slots are reused and never freed, so LogSink::Quiesce() can scan them at any time.
 	 */
-	class LoggerException
+	class PushSlots
 	{
 
 	private:
 
-		//! Logger exception message
-		std::string message;
-		//! Logger exception type
-		LoggerExceptionType type;
+		//! First slot of the list
+		std::atomic<PushSlot *> head;
 
 	public:
 
-		//! Constructor 
-		/*! Sets the logger exception type.
-		 *
-		 * @param	type The logger exception type.
-		 */
-		LoggerException(LoggerExceptionType type)
+		//! Constructor
+		PushSlots()
 		{
-			this->type = type;
+			head.store(NULL, std::memory_order_relaxed);
 		};
 
-		//! Constructor 
-		/*! Sets the logger exception type & message in C-wstring format.
-		 *
-		 * @param	type	The logger exception type.
-		 * @param	msg		The logger exception message in C-wstring format.
-		 */
-		LoggerException(LoggerExceptionType type, const wstring& msg)
-		{
-			this->type = type;
-			string message(msg.begin(), msg.end());
-			this->message = message;
-		};
+		//! <b>Take a free slot, or add one.</b><br>
+		PushSlot *Acquire();
 
-		//! Constructor 
-		/*! Sets the logger exception type & message in C-string format.
+		//! <b>Return a slot (also when the list is destroyed, threads may exit later).</b><br>
+		static void Release(PushSlot *slot);
+
+		//! <b>Check whether a logging thread is pushing to a sink.</b><br>
+		bool IsPushing(const LogSink *sink);
+	};
+
+	/**
+	 * @class LogSink
+	 *
+	 * @brief Output of the log records. The router pushes each record to the queue of every sink its severity
+	 * level is routed to, and the writer threads pop the queues in batches and pass them to Write(), one thread
+	 * at a time per sink, so that the records of a sink stay in order. Derive from LogSink and register the sink
+	 * with Logger::AddSink() to add an output.
+	 */
+	class LogSink
+	{
+
+	public:
+
+		//! Queue of the records routed to the sink
+		LogQueue queue;
+		//! Capacity and overflow policy of the queue
+		QueueOptions queueOptions;
+		//! Records the queue has dropped on overflow
+		DropCounts dropped;
+		//! Sink mutex lock, held by the writer thread while it writes a batch
+		std::mutex mtx;
+		//! Set while a writer thread services the sink
+		std::atomic<bool> busy;
+		//! Queues of the NUMA nodes but the first (which uses queue), each allocated on its node
+		LogQueue *nodeQueues[NUMA_NODES_MAX - 1];
+		//! Number of node queues allocated, the writer threads pop all of them
+		std::atomic<size_t> nodeQueueCount;
+		//! The logging threads push to the queue of their node
+		std::atomic<bool> hasNodeQueues;
+		//! Set while the queues are reallocated, holds the logging threads back (see Quiesce()); read on every
+		//! push, so it has a cache line of its own
+		alignas(CACHE_LINE_SIZE) std::atomic<bool> quiescing;
+		//! Time stamps (in nanoseconds) and batch indexes PopBatch() merges the node queues by
+		alignas(CACHE_LINE_SIZE) std::vector<std::pair<long long, size_t> > mergeKeys;
+
+		//! Constructor
+		/*! @param	queueOptions	The capacity and overflow policy of the queue. */
+		explicit LogSink(const QueueOptions& queueOptions = QueueOptions());
+
+		//! Destructor
+		virtual ~LogSink();
+
+		/**
+		 * Allocates a sink aligned to the cache line of its queue (create the sinks with new, not make_shared).
 		 *
-		 * @param	type	The logger exception type.
-		 * @param	msg		The logger exception message in C-string format.
+		 * @param	size	The size of the sink.
+		 *
+		 * @return	The sink memory.
 		 */
-		LoggerException(LoggerExceptionType type, const string& msg)
+		static void *operator new(size_t size)
 		{
-			this->type = type;
-			this->message = msg;
+			void *mem = NULL;
+			if (posix_memalign(&mem, CACHE_LINE_SIZE, size) != 0)
+				throw std::bad_alloc();
+			return mem;
 		};
 
-		/**
-		 * Retrieves the logger exception type.
-		 *
-		 * @return	The logger exception type.
-		 */
-		LoggerExceptionType GetType()
+		//! <b>Release the sink memory.</b><br>
+		static void operator delete(void *mem)
 		{
-			return type;
+			free(mem);
 		};
 
+		//! <b>Write a batch of records.</b><br>
+		virtual void Write(std::vector<LogRecord>& batch, size_t count) = 0;
+
 		/**
-		 * Retrieves the logger exception message as C-string.
+		 * Writes what is due while the queue is empty, e.g. the records held back by the sink.
 		 *
-		 * @return	The logger exception message as C-string.
+		 * @param	closing	The writer threads are stopping, write everything now.
+		 *
+		 * @return	The time in milliseconds until the sink has something due, negative for nothing.
 		 */
-		const char *GetMsg()
+		virtual long long Flush(bool closing)
 		{
-			return message.c_str();
+			(void) closing;
+			return -1;
 		};
+
+		//! <b>Close the sink, called once the writer threads have stopped.</b><br>
+		virtual void Close() { };
+
+		//! <b>Retrieve the log line of a record, formatting deferred records to buffer.</b><br>
+		static const char *GetLine(const LogRecord& record, std::string& buffer);
+
+		//! <b>Retrieve the queue of the NUMA node of the calling thread.</b><br>
+		LogQueue& LocalQueue();
+
+		//! <b>Allocate (or resize) the queue of a NUMA node, on the calling thread.</b><br>
+		void AllocateNodeQueue(size_t node, Doorbell *doorbell);
+
+		//! <b>Pop records from the queues of all the nodes, merged by time stamp.</b><br>
+		size_t PopBatch(std::vector<LogRecord>& batch, size_t offset, size_t maxCount);
+
+		//! <b>Sort a batch popped from several queues by time stamp.</b><br>
+		void MergeBatch(std::vector<LogRecord>& batch, size_t count);
+
+		//! <b>Retrieve the number of records in the queues of all the nodes.</b><br>
+		size_t Size();
+
+		//! <b>Release the writer thread waiting on the queues.</b><br>
+		void Wake();
+
+		//! <b>Hold the logging threads back until Resume(), once none of them is pushing.</b><br>
+		bool Quiesce();
+
+		//! <b>Let the logging threads push again.</b><br>
+		void Resume();
 	};
 
 	/**
-	 * @class BlockingWStringQueue
+	 * @class FileSink
 	 *
-	 * @brief Utility queue class which performs wstring pop/push operation.
+	 * @brief Log file sink: writes the batches to the log file (file stream, memory-mapped or io_uring), in the
+	 * text or binary format, with rotation, the time index and repeated record collapsing of the LoggerOptions.
 	 */
-	class BlockingWStringQueue
+	class FileSink : public LogSink
 	{
 
 	private:
 
-		//! mutex lock
-		std::mutex mtx;
-		//! wstring queue
-		std::queue<std::wstring> queue;
+		//! Log file path
+		std::string path;
+		//! Log file stream
+		std::ofstream stream;
+		//! Memory-mapped log file
+		MappedFile mapped;
+		//! io_uring log file
+		UringFile uring;
+		//! Binary log writer (binary format)
+		BinaryLogWriter binary;
+		//! Repeated record filter
+		RepeatFilter repeats;
+		//! Write buffer
+		std::string buffer;
+		//! Buffer the deferred records are formatted to on the syslog fallback
+		std::string stringBuffer;
+		//! Size of the log file
+		size_t fileSize;
+		//! Time index file descriptor (-1 if closed)
+		int indexFd;
+		//! Log file size at the last time index entry
+		size_t indexedSize;
+		//! Time of the next time based rotation (0 for none)
+		long long rotateAt;
+
+		//! <b>Format a batch and write it to the log file.</b><br>
+		void WriteBatch(std::vector<LogRecord>& batch, size_t count);
 
 	public:
 
-		/**
-		 * <b>Pop element from queue</b> <br>
-		 * Pop elements from queue, returning true if an item poped from the queue; false otherwise.
-		 *
-		 * @param	rslt	Pointer to a wstring where the resulting C-wstring is stored.
-		 *
-		 * @return 	true is returned in the case that an item poped from the queue.
-		 *			Otherwise, false is returned.
-		 */
-		bool pop(std::wstring& rslt)
-		{
-			std::lock_guard<std::mutex> lock(mtx);
-			if (queue.empty())
-				return false;
-			rslt = queue.front();
-			queue.pop();
-			return true;
-		};
+		//! Constructor
+		FileSink();
+
+		//! Destructor
+		~FileSink();
+
+		//! <b>Set the log file path, while the sink is closed.</b><br>
+		void SetPath(const std::string& path);
 
 		/**
-		 * <b>Push element to the queue</b><br>
-		 * Push an element to the queue.
+		 * Gets the log file path.
 		 *
-		 * @param	src		The C-wstring element that requires insertion.
+		 * @return	The log file path.
 		 */
-		void push(std::wstring src)
+		const std::string& GetPath() const
 		{
-			std::lock_guard<std::mutex> lock(mtx);
-			queue.push(src);
+			return path;
 		};
+
+		//! <b>Write a batch of records to the log file.</b><br>
+		virtual void Write(std::vector<LogRecord>& batch, size_t count);
+
+		//! <b>Write the collapsed repeats once due.</b><br>
+		virtual long long Flush(bool closing);
+
+		//! <b>Close the log file.</b><br>
+		virtual void Close();
 	};
 
 	/**
-	 * @class LoggerUtil
+	 * @class ConsoleSink
 	 *
-	 * @brief Utility class which provides helper functions to logging operations.
+	 * @brief Console sink: writes the batches to stdout with write(2), with ANSI colors only when stdout is a
+	 * terminal. Its queue drops records rather than blocking the logging threads on a slow terminal or pipe.
 	 */
-	class LoggerUtil
+	class ConsoleSink : public LogSink
 	{
 
+	private:
+
+		//! Write buffer
+		std::string buffer;
+		//! Buffer the deferred records are formatted to
+		std::string stringBuffer;
+		//! Whether stdout is a terminal, resolved when the sink is created or enabled
+		std::atomic<bool> isTerminal;
+
 	public:
-		
-		//! <b>Check file existence.</b><br>
-		static bool FileExists(const std::string& fileName);
 
-		//! <b>Get time stamp in 'yyyy-MM-dd HH:mm:ss.SSS' format.</b><br>
-		static void GetTimeString(wchar_t *dst);
+		//! Constructor
+		ConsoleSink();
 
-		//! <b>Validate file/directory permission.</b><br>
-		static int HasPermissions(const char* dirPath);
+		//! <b>Check whether stdout is a terminal.</b><br>
+		void DetectTerminal();
 
-		//! <b>Set sleep to the process.</b><br>
-		static void Sleep(unsigned int milliseconds);
+		//! <b>Write a batch of records to stdout.</b><br>
+		virtual void Write(std::vector<LogRecord>& batch, size_t count);
+	};
 
-		//! <b>Write formatted data to wstring (wstring version sprintf).</b><br>
-		static wstring StrFormat(const wchar_t* format, ...);
+	/**
+	 * @class SysLogSink
+	 *
+	 * @brief Syslog sink: sends the records as datagrams (see SysLogSocket) to the syslog daemon, with the
+	 * priority of their severity level. Its queue drops records rather than blocking the logging threads.
+	 */
+	class SysLogSink : public LogSink
+	{
+
+	private:
+
+		//! Socket to the syslog daemon
+		SysLogSocket socket;
+		//! Datagrams of a batch
+		std::vector<LogRecord> datagrams;
+		//! Buffer the deferred records are formatted to
+		std::string stringBuffer;
+
+	public:
+
+		//! Constructor
+		SysLogSink();
+
+		//! <b>Send a batch of records to the syslog daemon.</b><br>
+		virtual void Write(std::vector<LogRecord>& batch, size_t count);
+
+		//! <b>Send a record to the syslog daemon right away (the caller holds mtx).</b><br>
+		void Send(const LogRecord& record);
+
+		//! <b>Close the socket.</b><br>
+		virtual void Close();
+	};
+
+	/**
+	 * @class MemorySink
+	 *
+	 * @brief Memory sink: keeps the last log lines in memory, e.g. to attach them to a crash report or to check
+	 * them in tests.
+	 */
+	class MemorySink : public LogSink
+	{
+
+	private:
+
+		//! Maximum number of lines kept
+		size_t maxLines;
+		//! The lines
+		std::deque<std::string> lines;
+		//! Lines mutex lock
+		std::mutex mtxLines;
+		//! Buffer the deferred records are formatted to
+		std::string stringBuffer;
+
+	public:
+
+		//! Constructor
+		/*! @param	maxLines	The maximum number of lines kept. */
+		explicit MemorySink(size_t maxLines = MEMORY_SINK_LINES_DEFAULT) : maxLines(maxLines) { };
+
+		//! <b>Keep a batch of records.</b><br>
+		virtual void Write(std::vector<LogRecord>& batch, size_t count);
+
+		//! <b>Retrieve the lines kept, oldest first.</b><br>
+		std::vector<std::string> GetLines();
+	};
+
+	/**
+	 * @class SocketSink
+	 *
+	 * @brief Socket sink: writes the log lines to an AF_UNIX stream socket (e.g. a log shipper), reconnecting
+	 * when the peer has gone away. A batch that cannot be written is dropped.
+	 */
+	class SocketSink : public LogSink
+	{
+
+	private:
+
+		//! Socket path
+		std::string path;
+		//! Socket descriptor (-1 if not connected)
+		int fd;
+		//! Write buffer
+		std::string buffer;
+		//! Buffer the deferred records are formatted to
+		std::string stringBuffer;
+
+		//! <b>Connect to the socket.</b><br>
+		bool Connect();
+
+	public:
+
+		//! Constructor
+		/*! @param	path	The socket path. */
+		explicit SocketSink(const std::string& path) : path(path), fd(-1) { };
+
+		//! Destructor
+		~SocketSink();
+
+		//! <b>Write a batch of records to the socket.</b><br>
+		virtual void Write(std::vector<LogRecord>& batch, size_t count);
+
+		//! <b>Close the socket.</b><br>
+		virtual void Close();
 	};
 
 	/**
@@ -290,45 +2505,88 @@ namespace cpplogger {
 
 	public:
 
+		//! Route of severity levels to a sink
+		struct SinkRoute
+		{
+			//! The sink
+			std::atomic<LogSink *> sink;
+			//! Severity levels routed to the sink (SEVERITY_MASK() bits)
+			std::atomic<unsigned int> levels;
+		};
+
 		//! Log severity level
 		SeverityLevel severityLevel;
-		//! std out mutex lock
-		std::mutex mtxStdOut;
 		//! Enable/disable the logging to console
 		volatile bool hasConsoleLogging;
+		//! Enable/disable deferred formatting (formatting on the write threads)
+		volatile bool hasDeferredFormatting;
+		//! Time stamp format of the log records
+		volatile TimestampFormat timestampFormat;
+		//! Enable/disable reading the time stamps from CLOCK_REALTIME_COARSE
+		volatile bool hasCoarseClock;
+		//! Enable/disable stamping the deferred records with the time stamp counter
+		volatile bool hasTscClock;
+		//! Enable/disable the memory-mapped log files
+		volatile bool hasMappedFile;
+		//! Enable/disable the io_uring log file writes
+		volatile bool hasUringFile;
+		//! Options passed to Init()
+		LoggerOptions options;
+		//! Rotated files mutex lock (the write threads renaming and the compression thread replacing files)
+		std::mutex mtxRotation;
+		//! Condition signalled when a file is rotated or the compression thread is stopped
+		std::condition_variable condCompression;
+		//! Set when a file is rotated, cleared when the compression thread scans the rotated files
+		bool hasRotatedFiles;
+		//! Sets the compression thread interruption status
+		volatile bool isInterruptedCompression;
+		//! TSC calibration mutex lock
+		std::mutex mtxTscCalibration;
+		//! Condition signalled to stop the TSC calibration thread
+		std::condition_variable condTscCalibration;
+		//! Sets the TSC calibration thread interruption status
+		bool isInterruptedTscCalibration;
+		//! Maximum number of records written per batch
+		volatile size_t batchSize;
+		//! Maximum time (ms) to wait for a batch to fill up before writing it
+		volatile unsigned int batchLatencyMs;
 
 		//! Enable/disable the application logging
 		volatile bool hasAplLog;
-		//! Application log file path
-		std::string aplLogFilePath;
-		//! Application log file stream
-		std::ofstream aplLogFileStream;
-		//! Application log mutex lock
-		std::mutex mtxAplLog;
-		//! Application log queue
-		BlockingWStringQueue aplLogQueue;
-
 		//! Enable/disable the debug logging
 		volatile bool hasDbgLog;
-		//! Debug log file path
-		std::string dbgLogFilePath;
-		//! Debug log file stream
-		std::ofstream dbgLogFileStream;
-		//! Debug log mutex lock
-		std::mutex mtxDbgLog;
-		//! Debug log queue
-		BlockingWStringQueue dbgLogQueue;
-
 		//! Enable/disable the event logging
 		volatile bool hasEvntLog;
-		//! Event log file path
-		std::string evntLogFilePath;
-		//! Event log file stream
-		std::ofstream evntLogFileStream;
-		//! Event log mutex lock
-		std::mutex mtxEvntlog;
-		//! Event log queue
-		BlockingWStringQueue evntLogQueue;
+
+		//! Application log file
+		FileSink aplSink;
+		//! Debug log file
+		FileSink dbgSink;
+		//! Event log file
+		FileSink evntSink;
+		//! Console
+		ConsoleSink consoleSink;
+		//! Syslog daemon (the syslog interfaces, and the records routed to it)
+		SysLogSink sysLogSink;
+
+		//! Routes of the severity levels to the sinks, the built-in sinks first
+		SinkRoute routes[SINK_COUNT_MAX];
+		//! Number of routes
+		std::atomic<size_t> routeCount;
+		//! Sinks added by Logger::AddSink()
+		std::vector<std::shared_ptr<LogSink> > userSinks;
+		//! Routes mutex lock (adding and removing routes)
+		std::mutex mtxRoutes;
+		//! Doorbell of the sink queues, wakes the writer threads
+		Doorbell doorbell;
+		//! The writer threads are running
+		volatile bool hasWriterThreads;
+		//! Rate limits of the log records
+		RateLimiter rateLimiter;
+		//! NUMA nodes (loaded by the first Init() with options.numaQueues)
+		NumaTopology numaNodes;
+		//! Push slots of the logging threads (see LogSink::Quiesce())
+		PushSlots pushSlots;
 
 	public:
 
@@ -339,25 +2597,74 @@ namespace cpplogger {
 		~LoggerWorker();
 
 		//! <b>Initialize LoggerWorker.</b><br>
-		void Init(std::string& aplLogPath, std::string& dbgLogPath, std::string& evntLogPath);
+		void Init(std::string& aplLogPath, std::string& dbgLogPath, std::string& evntLogPath,
+			const LoggerOptions& options);
 
+		//! <b>Push log record (UTF-8) to the application log queue.</b><br>
+		void OutputAplLine(SeverityLevel level, const char *logRecord);
 		//! <b>Push log record to the application log queue.</b><br>
-		void OutputAplLine(SeverityLevel level, const wchar_t *logRecord);
+		void OutputAplLine(const LogRecord& record);
 
+		//! <b>Push log record (UTF-8) to the debug log queue.</b><br>
+		void OutputDbgLine(const char *logRecord);
 		//! <b>Push log record to the debug log queue.</b><br>
-		void OutputDbgLine(const wchar_t *logRecord);
+		void OutputDbgLine(const LogRecord& record);
 
+		//! <b>Push log record (UTF-8) to the event log queue.</b><br>
+		void OutputEvntLine(const char *logRecord);
 		//! <b>Push log record to the event log queue.</b><br>
-		void OutputEvntLine(const wchar_t *logRecord);
+		void OutputEvntLine(const LogRecord& record);
+
+		//! <b>Push a log record to the sinks its severity level is routed to.</b><br>
+		void Route(const LogRecord& record);
+
+		//! <b>Route severity levels to a sink.</b><br>
+		bool AddRoute(LogSink *sink, unsigned int levels);
+
+		//! <b>Change the severity levels routed to a sink.</b><br>
+		void SetRouteLevels(LogSink *sink, unsigned int levels);
+
+		//! <b>Push a record to a sink queue, applying the overflow policy when the queue is full.</b><br>
+		void Enqueue(LogSink& sink, const LogRecord& record);
+
+		//! <b>Push a record to the queue of the node of the calling thread, applying the overflow policy.</b><br>
+		void PushRecord(LogSink& sink, const LogRecord& record);
+
+		//! <b>Write a batch from a sink queue to the sink.</b><br>
+		bool ServiceSink(LogSink& sink, std::vector<LogRecord>& batch);
+
+		//! <b>Service the sink queues (writer thread).</b><br>
+		void WriteToSinks(unsigned int index);
 
-		//! <b>Write to application log file.</b><br>
-		void WriteToAplFile();
+		//! <b>Allocate the queues of the NUMA nodes of every sink.</b><br>
+		size_t CreateNodeQueues();
 
-		//! <b>Write to debug log file.</b><br>
-		void WriteToDbgFile();
+		//! <b>Start the writer threads.</b><br>
+		void StartWriters(unsigned int count);
 
-		//! <b>Write to event log file.</b><br>
-		void WriteToEvntFile();
+		//! <b>Stop the writer threads once they have drained the sink queues.</b><br>
+		void StopWriters();
+
+		//! <b>Rename a log file to the first rotated file, shifting the rotated files.</b><br>
+		void RotateFile(const std::string& path);
+
+		//! <b>Compress the rotated files in the background.</b><br>
+		void CompressRotatedFiles();
+
+		//! <b>Compress a rotated file and replace it with the compressed file.</b><br>
+		bool CompressFile(const std::string& path, unsigned int index);
+
+		//! <b>Send a message to syslog, through the writer threads if they are running.</b><br>
+		void OutputSysLogLine(int priority, const char *msg, size_t len);
+
+		//! <b>Start the TSC calibration thread.</b><br>
+		void StartTscCalibration();
+
+		//! <b>Stop the TSC calibration thread.</b><br>
+		void StopTscCalibration();
+
+		//! <b>Calibrate the TSC clock periodically.</b><br>
+		void CalibrateTsc();
 
 		//! <b>Release and close all loggers</b><br>
 		void DropAll();
@@ -375,9 +2682,37 @@ namespace cpplogger {
 		//! <b>Write the formatted log record to the respective log queue.</b><br>
 		static void WriteLog(SeverityLevel level, unsigned long code, const wchar_t* format, va_list args);
 
+		//! <b>Write the formatted (UTF-8) log record to the respective log queue.</b><br>
+		static void WriteLog(SeverityLevel level, unsigned long code, const char* format, va_list args);
+
 		//! <b>Write the formatted log record to syslog.</b><br>
 		static void WriteSysLog(int level, const wchar_t* format, va_list args);
 
+		//! <b>Write the formatted (UTF-8) log record to syslog.</b><br>
+		static void WriteSysLog(int level, const char* format, va_list args);
+
+		//! <b>Write a log message formatted by the type-safe interfaces to the respective log queue.</b><br>
+		static void WriteMessage(SeverityLevel level, unsigned long code, const char *msg);
+
+		//! <b>Check the rate limit of a log record, writing the summary of the suppressed records when due.</b><br>
+		static bool IsRateAllowed(SeverityLevel level, unsigned long code, const void *callSite);
+
+		//! <b>Write the summary of the records suppressed by a rate limit.</b><br>
+		static void WriteSuppressed(SeverityLevel level, unsigned long code, unsigned long suppressed);
+
+		//! Format the message of the type-safe interfaces and write it to the respective log queue
+		template <typename F, typename... Args>
+		static void WriteFormatted(SeverityLevel level, unsigned long code, const Args&... args)
+		{
+			if (!IsLogEnabled(level) || !IsRateAllowed(level, code, F::Value())) {
+				return;
+			}
+
+			FormatBuffer buffer;
+			LogFormatter::Format(buffer, F::Value(), args...);
+			WriteMessage(level, code, buffer.c_str());
+		};
+
 	public:
 
 		//! Constructor
@@ -389,6 +2724,10 @@ namespace cpplogger {
 		//! <b>Interface to initialize the logger.</b><br>
 		static void Init(std::string& pathAplLog, std::string& pathDbgLog, std::string& pathEvntLog);
 
+		//! <b>Interface to initialize the logger with options.</b><br>
+		static void Init(std::string& pathAplLog, std::string& pathDbgLog, std::string& pathEvntLog,
+			const LoggerOptions& options);
+
 		//! <b>Interface to set log level.</b><br>
 		static void SetLogSeverityLevel(SeverityLevel level);
 
@@ -398,6 +2737,45 @@ namespace cpplogger {
 		//! <b>Interface to enable/disable console logging.</b><br>
 		static void EnableConsoleLogging(bool value);
 
+		//! <b>Interface to enable/disable deferred formatting on the write threads.</b><br>
+		static void EnableDeferredFormatting(bool value);
+
+		//! <b>Interface to set the time stamp format of the log records.</b><br>
+		static void SetTimestampFormat(TimestampFormat format);
+
+		//! <b>Interface to enable/disable the coarse (CLOCK_REALTIME_COARSE) time stamp clock.</b><br>
+		static void EnableCoarseClock(bool value);
+
+		//! <b>Interface to enable/disable stamping the deferred records with the time stamp counter.</b><br>
+		static void EnableTscClock(bool value);
+
+		//! <b>Interface to enable/disable the memory-mapped log files.</b><br>
+		static void EnableMappedFile(bool value);
+
+		//! <b>Interface to enable/disable the io_uring log file writes.</b><br>
+		static void EnableUringFile(bool value);
+
+		//! <b>Interface to set the maximum number of records written per batch.</b><br>
+		static void SetBatchSize(size_t size);
+
+		//! <b>Interface to get the number of records of a severity level dropped on queue overflow.</b><br>
+		static unsigned long GetDroppedCount(SeverityLevel level);
+
+		//! <b>Interface to route severity levels to an additional sink.</b><br>
+		static bool AddSink(std::shared_ptr<LogSink> sink, unsigned int levels);
+
+		//! <b>Interface to remove the sinks added by AddSink().</b><br>
+		static bool RemoveSinks();
+
+		//! <b>Interface to limit the rate of the log records of every code (or call site).</b><br>
+		static void SetRateLimit(unsigned int rate, unsigned int burst, bool perCallSite = false);
+
+		//! <b>Interface to limit the rate of the log records of a code.</b><br>
+		static bool SetRateLimit(SeverityLevel level, unsigned long code, unsigned int rate, unsigned int burst);
+
+		//! <b>Interface to set the maximum time to wait for a batch to fill up.</b><br>
+		static void SetBatchLatency(unsigned int milliseconds);
+
 		//! <b>Interface to enable/disable application logging.</b><br>
 		static void EnableAplLogging(bool value);
 
@@ -411,47 +2789,196 @@ namespace cpplogger {
 		static void Crit(const wchar_t * format, ...);
 		//! <b>Interface to write (application) critical level log records.</b><br>
 		static void Crit(unsigned long code, const wchar_t * format, ...);
+		//! <b>Interface to write (application) critical level log records (UTF-8).</b><br>
+		static void Crit(const char * format, ...);
+		//! <b>Interface to write (application) critical level log records (UTF-8).</b><br>
+		static void Crit(unsigned long code, const char * format, ...);
 
 		//! <b>Interface to write (application) error level log records.</b><br>
 		static void Error(const wchar_t * format, ...);
 		//! <b>Interface to write (application) error level log records.</b><br>
 		static void Error(unsigned long code, const wchar_t * format, ...);
+		//! <b>Interface to write (application) error level log records (UTF-8).</b><br>
+		static void Error(const char * format, ...);
+		//! <b>Interface to write (application) error level log records (UTF-8).</b><br>
+		static void Error(unsigned long code, const char * format, ...);
 
 		//! <b>Interface to write (application) info level log records.</b><br>
 		static void Info(const wchar_t * format, ...);
 		//! <b>Interface to write (application) info level log records.</b><br>
 		static void Info(unsigned long code, const wchar_t * format, ...);
+		//! <b>Interface to write (application) info level log records (UTF-8).</b><br>
+		static void Info(const char * format, ...);
+		//! <b>Interface to write (application) info level log records (UTF-8).</b><br>
+		static void Info(unsigned long code, const char * format, ...);
 
 		//! <b>Interface to write (application) warning level log records.</b><br>
 		static void Warn(const wchar_t * format, ...);
 		//! <b>Interface to write (application) warning level log records.</b><br>
 		static void Warn(unsigned long code, const wchar_t * format, ...);
+		//! <b>Interface to write (application) warning level log records (UTF-8).</b><br>
+		static void Warn(const char * format, ...);
+		//! <b>Interface to write (application) warning level log records (UTF-8).</b><br>
+		static void Warn(unsigned long code, const char * format, ...);
 
 		//! <b>Interface to write debug level log records.</b><br>
 		static void Debug(const wchar_t * format, ...);
+		//! <b>Interface to write debug level log records (UTF-8).</b><br>
+		static void Debug(const char * format, ...);
 
 		//! <b>Interface to write event level log records.</b><br>
 		static void Event(const wchar_t * format, ...);
+		//! <b>Interface to write event level log records (UTF-8).</b><br>
+		static void Event(const char * format, ...);
+
+		//! <b>Interface to check whether log records of a severity level are written.</b><br>
+		static inline bool IsLogEnabled(SeverityLevel level);
+
+		//! <b>Type-safe interface to write (application) critical level log records.</b><br>
+		template <typename F, typename... Args>
+		static typename std::enable_if<std::is_base_of<FormatStringBase, F>::value>::type
+		Crit(F, const Args&... args)
+		{
+			CPPLOGGER_CHECK_FMT(F, Args);
+			WriteFormatted<F>(CRITICAL, LOGGER_CODE_CRIT_DEFAULT, args...);
+		};
+		//! <b>Type-safe interface to write (application) critical level log records.</b><br>
+		template <typename F, typename... Args>
+		static typename std::enable_if<std::is_base_of<FormatStringBase, F>::value>::type
+		Crit(unsigned long code, F, const Args&... args)
+		{
+			CPPLOGGER_CHECK_FMT(F, Args);
+			WriteFormatted<F>(CRITICAL, code, args...);
+		};
+
+		//! <b>Type-safe interface to write (application) error level log records.</b><br>
+		template <typename F, typename... Args>
+		static typename std::enable_if<std::is_base_of<FormatStringBase, F>::value>::type
+		Error(F, const Args&... args)
+		{
+			CPPLOGGER_CHECK_FMT(F, Args);
+			WriteFormatted<F>(ERROR, LOGGER_CODE_ERRR_DEFAULT, args...);
+		};
+		//! <b>Type-safe interface to write (application) error level log records.</b><br>
+		template <typename F, typename... Args>
+		static typename std::enable_if<std::is_base_of<FormatStringBase, F>::value>::type
+		Error(unsigned long code, F, const Args&... args)
+		{
+			CPPLOGGER_CHECK_FMT(F, Args);
+			WriteFormatted<F>(ERROR, code, args...);
+		};
+
+		//! <b>Type-safe interface to write (application) info level log records.</b><br>
+		template <typename F, typename... Args>
+		static typename std::enable_if<std::is_base_of<FormatStringBase, F>::value>::type
+		Info(F, const Args&... args)
+		{
+			CPPLOGGER_CHECK_FMT(F, Args);
+			WriteFormatted<F>(INFO, LOGGER_CODE_INFO_DEFAULT, args...);
+		};
+		//! <b>Type-safe interface to write (application) info level log records.</b><br>
+		template <typename F, typename... Args>
+		static typename std::enable_if<std::is_base_of<FormatStringBase, F>::value>::type
+		Info(unsigned long code, F, const Args&... args)
+		{
+			CPPLOGGER_CHECK_FMT(F, Args);
+			WriteFormatted<F>(INFO, code, args...);
+		};
+
+		//! <b>Type-safe interface to write (application) warning level log records.</b><br>
+		template <typename F, typename... Args>
+		static typename std::enable_if<std::is_base_of<FormatStringBase, F>::value>::type
+		Warn(F, const Args&... args)
+		{
+			CPPLOGGER_CHECK_FMT(F, Args);
+			WriteFormatted<F>(WARNING, LOGGER_CODE_WARN_DEFAULT, args...);
+		};
+		//! <b>Type-safe interface to write (application) warning level log records.</b><br>
+		template <typename F, typename... Args>
+		static typename std::enable_if<std::is_base_of<FormatStringBase, F>::value>::type
+		Warn(unsigned long code, F, const Args&... args)
+		{
+			CPPLOGGER_CHECK_FMT(F, Args);
+			WriteFormatted<F>(WARNING, code, args...);
+		};
+
+		//! <b>Type-safe interface to write debug level log records.</b><br>
+		template <typename F, typename... Args>
+		static typename std::enable_if<std::is_base_of<FormatStringBase, F>::value>::type
+		Debug(F, const Args&... args)
+		{
+			CPPLOGGER_CHECK_FMT(F, Args);
+			WriteFormatted<F>(DEBUG, 0, args...);
+		};
+
+		//! <b>Type-safe interface to write event level log records.</b><br>
+		template <typename F, typename... Args>
+		static typename std::enable_if<std::is_base_of<FormatStringBase, F>::value>::type
+		Event(F, const Args&... args)
+		{
+			CPPLOGGER_CHECK_FMT(F, Args);
+			WriteFormatted<F>(EVENT, 0, args...);
+		};
 
 		//! <b>Interface to write the critical level log records to syslog.</b><br>
 		static void SysLogCrit(const wchar_t* format, ...);
+		//! <b>Interface to write the critical level log records (UTF-8) to syslog.</b><br>
+		static void SysLogCrit(const char* format, ...);
 
 		//! <b>Interface to write the debug level log records to syslog.</b><br>
 		static void SysLogDebug(const wchar_t* format, ...);
+		//! <b>Interface to write the debug level log records (UTF-8) to syslog.</b><br>
+		static void SysLogDebug(const char* format, ...);
 
 		//! <b>Interface to write the error level log records to syslog.</b><br>
 		static void SysLogError(const wchar_t* format, ...);
+		//! <b>Interface to write the error level log records (UTF-8) to syslog.</b><br>
+		static void SysLogError(const char* format, ...);
 
 		//! <b>Interface to write the information level log records to syslog.</b><br>
 		static void SysLogInfo(const wchar_t* format, ...);
+		//! <b>Interface to write the information level log records (UTF-8) to syslog.</b><br>
+		static void SysLogInfo(const char* format, ...);
 
 		//! <b>Interface to write the warning level log records to syslog.</b><br>
 		static void SysLogWarn(const wchar_t* format, ...);
+		//! <b>Interface to write the warning level log records (UTF-8) to syslog.</b><br>
+		static void SysLogWarn(const char* format, ...);
 
 		//! <b>Release and close all loggers.</b><br>
 		static void DropAll();
 	};
 
+	//! Instance to LoggerWorker class
+	extern LoggerWorker worker;
+
+	/**
+	 * Checks whether log records of a severity level are written (severity level and logging enabled).<br>
+	 * Inlined, so that the CPPLOGGER_<LEVEL>() macros skip disabled records without a call. Like Logger::Debug()
+	 * and Logger::Event(), the debug and event records (written to their own files) ignore the severity level and
+	 * only depend on EnableDbgLogging() and EnableEvntLogging().
+	 *
+	 * @param	level	the log severity level
+	 *
+	 * @return	true is returned in the case that the records are written. Otherwise, false is returned.
+	 */
+	inline bool Logger::IsLogEnabled(SeverityLevel level)
+	{
+		switch (level) {
+			case CRITICAL:
+			case ERROR:
+			case INFO:
+			case WARNING:
+			return level >= worker.severityLevel && worker.hasAplLog;
+			case DEBUG:
+			return worker.hasDbgLog;
+			case EVENT:
+			return worker.hasEvntLog;
+			default:
+			return false;
+		}
+	}
+
 	/**
 	 * @class CallLog
 	 *
@@ -476,7 +3003,13 @@ namespace cpplogger {
 				 Enter and Leave logs shall be write to the log file
 			 Result:
 				 ClassName.cpp [FunctionName():LineNo] START
-				 ClassName.cpp [FunctionName():LineNo] END</pre>
+				 ClassName.cpp [FunctionName():LineNo] END
+		 4) CallLog log(CPPLOGGER_FMT("ClassName::FunctionName(param1={}, param2={})"), value1, value2);
+			 Description:
+				 Same as 2), with a type-safe format string checked at compile time
+			 Result:
+				 ClassName::FunctionName(param1=value1, param2=value2) Enter
+				 ClassName::FunctionName(param1=value1, param2=value2) Leave</pre>
 	 */
 	class CallLog
 	{
@@ -491,6 +3024,8 @@ namespace cpplogger {
 		const char *func;
 		//! Buffer to hold the log information
 		wchar_t formatBuffer[MAX_LEN_FMT_BUFFER];
+		//! The (UTF-8) log information of the type-safe constructor
+		std::string message;
 
 	public:
 
@@ -542,6 +3077,33 @@ namespace cpplogger {
 			}
 		};
 
+		//! Constructor
+		/*!
+		 * Writes the function start-up log to the debug log file (type-safe version).
+		 *
+		 * @param	format	Compile-time format string created by CPPLOGGER_FMT(), each '{}' is replaced by the next
+		 *					argument.
+		 * @param	args	The arguments, there must be exactly one per placeholder.
+		 */
+		template <typename F, typename... Args,
+			typename = typename std::enable_if<std::is_base_of<FormatStringBase, F>::value>::type>
+		CallLog(F format, const Args&... args)
+		{
+			CPPLOGGER_CHECK_FMT(F, Args);
+			(void) format;
+			this->file = "";
+			this->line = 0;
+			this->func = "";
+
+			FormatBuffer buffer;
+			LogFormatter::Format(buffer, F::Value(), args...);
+			formatBuffer[0] = L'\0';
+			message.assign(buffer.data, buffer.len);
+
+			mode = 2;
+			Logger::Debug("%s Enter", message.c_str());
+		};
+
 		//! Destructor
 		/*!
 		 * Writes the function end log to the debug log file.
@@ -550,6 +3112,8 @@ namespace cpplogger {
 		{
 			if (mode == 0) {
 				Logger::Debug(L"%s()[%s:%d] END", func, file, line);
+			} else if (mode == 2) {
+				Logger::Debug("%s Leave", message.c_str());
 			} else {
 				Logger::Debug(L"%S Leave", formatBuffer);
 			}
@@ -0,0 +1,118 @@
+//////////////////////////////////////////////////////////////////////////////
+// @File Name:      jitter_bench.cpp                                        //
+// @Description:    Measures the jitter the writer threads cause on a       //
+//                  pinned logging thread, with and without pinning them    //
+//                                                                          //
+// Usage: jitter_bench [log directory] [records] [producer cpu]             //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include "../Logger.h"
+
+using namespace std;
+using namespace std::chrono;
+using namespace cpplogger;
+
+/**
+ * Logs records at a steady pace from a thread pinned to a CPU, and prints the latency percentiles of the logging
+ * calls and of a fixed spin loop between them. Preemptions by the writer threads show up in the tail.
+ *
+ * @param	name		The name of the run.
+ * @param	dir			The log directory.
+ * @param	options		The logger options.
+ * @param	records		The number of records.
+ * @param	cpu			The CPU of the logging thread.
+ */
+static void Run(const char *name, const string& dir, const LoggerOptions& options, int records, int cpu)
+{
+	string aplLogFile = dir + "/apl_jitter.log";
+	string dbgLogFile = dir + "/debug_jitter.log";
+	string evntLogFile = dir + "/event_jitter.log";
+	remove(aplLogFile.c_str());
+
+	Logger::Init(aplLogFile, dbgLogFile, evntLogFile, options);
+	Logger::EnableFileLogging(true);
+	Logger::EnableConsoleLogging(false);
+	Logger::SetLogSeverityLevel(INFO);
+
+	vector<long long> calls;
+	vector<long long> spins;
+	calls.reserve(records);
+	spins.reserve(records);
+	thread producer([&]() {
+		cpu_set_t cpus;
+		CPU_ZERO(&cpus);
+		CPU_SET(cpu, &cpus);
+		pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+
+		for (int i = 0; i < records; i++) {
+			steady_clock::time_point begin = steady_clock::now();
+			Logger::Info(L"Jitter record %d, with some payload text", i);
+			steady_clock::time_point logged = steady_clock::now();
+
+			// A fixed amount of work, it only takes longer when the thread is preempted
+			volatile unsigned int work = 0;
+			for (int w = 0; w < 2000; w++)
+				work += w;
+			steady_clock::time_point end = steady_clock::now();
+
+			calls.push_back(duration_cast<nanoseconds>(logged - begin).count());
+			spins.push_back(duration_cast<nanoseconds>(end - logged).count());
+		}
+	});
+	producer.join();
+
+	// Release and close all loggers
+	Logger::DropAll();
+
+	sort(calls.begin(), calls.end());
+	sort(spins.begin(), spins.end());
+	size_t count = calls.size();
+	printf("%-30s call p50 %6lld ns  p99.9 %8lld ns  max %9lld ns   spin p50 %6lld ns  p99.9 %8lld ns  max %9lld ns\n",
+		name, calls[count / 2], calls[count * 999 / 1000], calls[count - 1], spins[count / 2],
+		spins[count * 999 / 1000], spins[count - 1]);
+}
+
+int main(int argc, char *argv[])
+{
+	string dir = argc > 1 ? argv[1] : "/tmp";
+	int records = argc > 2 ? atoi(argv[2]) : 500000;
+	int cpus = (int) sysconf(_SC_NPROCESSORS_ONLN);
+	int cpu = argc > 3 ? atoi(argv[3]) : cpus - 1;
+
+	try {
+		LoggerOptions floating;
+		Run("writer floating", dir, floating, records, cpu);
+
+		// Every CPU but the one of the logging thread
+		LoggerOptions pinned;
+		for (int i = 0; i < cpus; i++) {
+			if (i != cpu)
+				pinned.writerCpus.push_back(i);
+		}
+		if (pinned.writerCpus.empty()) {
+			cerr << "jitter_bench: a single CPU, the writer threads share it with the logging thread" << endl;
+			pinned.writerCpus.push_back(cpu);
+		}
+		Run("writer pinned", dir, pinned, records, cpu);
+
+		LoggerOptions batch = pinned;
+		batch.writerPolicy = SCHED_BATCH;
+		batch.writerNice = 10;
+		Run("writer pinned, SCHED_BATCH", dir, batch, records, cpu);
+
+		LoggerOptions sameCpu;
+		sameCpu.writerCpus.push_back(cpu);
+		sameCpu.writerPolicy = SCHED_IDLE;
+		Run("writer on same CPU, SCHED_IDLE", dir, sameCpu, records, cpu);
+	} catch (LoggerException& e) {
+		cerr << "jitter_bench: " << e.GetMsg() << endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,115 @@
+//////////////////////////////////////////////////////////////////////////////
+// @File Name:      numa_bench.cpp                                          //
+// @Description:    Compares a queue per sink with a queue per NUMA node    //
+//                  per sink, with logging threads on every node            //
+//                                                                          //
+// Usage: numa_bench [log directory] [records per thread] [threads]         //
+//        perf stat -e node-loads,node-load-misses,node-stores ./numa_bench //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include "../Logger.h"
+
+using namespace std;
+using namespace std::chrono;
+using namespace cpplogger;
+
+/**
+ * Writes records from threads pinned round robin to the CPUs of the NUMA nodes, and prints the throughput and
+ * the latency percentiles of the logging calls.
+ *
+ * @param	name		The name of the run.
+ * @param	dir			The log directory.
+ * @param	options		The logger options.
+ * @param	nodes		The NUMA nodes.
+ * @param	records		The number of records per thread.
+ * @param	threads		The number of logging threads.
+ */
+static void Run(const char *name, const string& dir, const LoggerOptions& options, const NumaTopology& nodes,
+	int records, int threads)
+{
+	string aplLogFile = dir + "/apl_numa.log";
+	string dbgLogFile = dir + "/debug_numa.log";
+	string evntLogFile = dir + "/event_numa.log";
+	remove(aplLogFile.c_str());
+
+	Logger::Init(aplLogFile, dbgLogFile, evntLogFile, options);
+	Logger::EnableFileLogging(true);
+	Logger::EnableConsoleLogging(false);
+	Logger::SetLogSeverityLevel(INFO);
+
+	vector<vector<long long> > latencies(threads);
+	vector<thread> workers;
+	steady_clock::time_point start = steady_clock::now();
+	for (int t = 0; t < threads; t++) {
+		// Alternate the nodes, then the CPUs of a node
+		const vector<int>& cpus = nodes.Cpus(t % nodes.Count());
+		int cpu = cpus.empty() ? -1 : cpus[(t / nodes.Count()) % cpus.size()];
+		workers.push_back(thread([t, cpu, records, &latencies]() {
+			if (cpu >= 0) {
+				cpu_set_t set;
+				CPU_ZERO(&set);
+				CPU_SET(cpu, &set);
+				pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+			}
+			vector<long long>& samples = latencies[t];
+			samples.reserve(records);
+			for (int i = 0; i < records; i++) {
+				steady_clock::time_point begin = steady_clock::now();
+				Logger::Info(L"Benchmark record from thread %d, sequence %d, with some payload text", t, i);
+				samples.push_back(duration_cast<nanoseconds>(steady_clock::now() - begin).count());
+			}
+		}));
+	}
+	for (size_t t = 0; t < workers.size(); t++)
+		workers[t].join();
+	double callSec = duration_cast<duration<double> >(steady_clock::now() - start).count();
+
+	// Include the time the writer threads need to drain the queues
+	Logger::DropAll();
+	double totalSec = duration_cast<duration<double> >(steady_clock::now() - start).count();
+
+	vector<long long> all;
+	for (int t = 0; t < threads; t++)
+		all.insert(all.end(), latencies[t].begin(), latencies[t].end());
+	sort(all.begin(), all.end());
+
+	size_t count = all.size();
+	printf("%-22s %10.0f rec/s (drained %10.0f rec/s)  p50 %6lld ns  p99 %7lld ns  p99.9 %8lld ns  max %9lld ns\n",
+		name, count / callSec, count / totalSec, all[count / 2], all[count * 99 / 100], all[count * 999 / 1000],
+		all[count - 1]);
+}
+
+int main(int argc, char *argv[])
+{
+	string dir = argc > 1 ? argv[1] : "/tmp";
+	int records = argc > 2 ? atoi(argv[2]) : 200000;
+	int threads = argc > 3 ? atoi(argv[3]) : (int) sysconf(_SC_NPROCESSORS_ONLN);
+
+	NumaTopology nodes;
+	if (!nodes.Load()) {
+		cerr << "numa_bench: failed to read the NUMA nodes (" << NUMA_NODE_PATH << ")" << endl;
+		return 1;
+	}
+	printf("%u NUMA node(s), %d logging threads\n", (unsigned int) nodes.Count(), threads);
+	if (nodes.Count() < 2)
+		cerr << "numa_bench: a single node, both runs use the queue of the sink" << endl;
+
+	try {
+		LoggerOptions shared;
+		Run("queue per sink", dir, shared, nodes, records, threads);
+
+		LoggerOptions local;
+		local.numaQueues = true;
+		Run("queue per node", dir, local, nodes, records, threads);
+	} catch (LoggerException& e) {
+		cerr << "numa_bench: " << e.GetMsg() << endl;
+		return 1;
+	}
+	return 0;
+}
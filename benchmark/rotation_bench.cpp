@@ -0,0 +1,106 @@
+//////////////////////////////////////////////////////////////////////////////
+// @File Name:      rotation_bench.cpp                                      //
+// @Description:    Measures the cost of log rotation under sustained load  //
+//                                                                          //
+// Usage: rotation_bench [log directory] [records per thread] [threads]     //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include "../Logger.h"
+
+using namespace std;
+using namespace std::chrono;
+using namespace cpplogger;
+
+/**
+ * Writes records from several threads and prints the throughput and the latency percentiles of the logging
+ * calls seen by the logging threads.
+ *
+ * @param	name		The name of the run.
+ * @param	dir			The log directory.
+ * @param	options		The logger options.
+ * @param	records		The number of records per thread.
+ * @param	threads		The number of logging threads.
+ */
+static void Run(const char *name, const string& dir, const LoggerOptions& options, int records, int threads)
+{
+	string aplLogFile = dir + "/apl_bench.log";
+	string dbgLogFile = dir + "/debug_bench.log";
+	string evntLogFile = dir + "/event_bench.log";
+	for (unsigned int i = 0; i <= ROTATE_MAX_FILES_DEFAULT; i++)
+		remove((aplLogFile + (i ? "." + to_string(i) : "")).c_str());
+
+	Logger::Init(aplLogFile, dbgLogFile, evntLogFile, options);
+	Logger::EnableFileLogging(true);
+	Logger::EnableConsoleLogging(false);
+	Logger::SetLogSeverityLevel(INFO);
+
+	vector<vector<long long> > latencies(threads);
+	vector<thread> workers;
+	steady_clock::time_point start = steady_clock::now();
+	for (int t = 0; t < threads; t++) {
+		workers.push_back(thread([t, records, &latencies]() {
+			vector<long long>& samples = latencies[t];
+			samples.reserve(records);
+			for (int i = 0; i < records; i++) {
+				steady_clock::time_point begin = steady_clock::now();
+				Logger::Info(L"Benchmark record from thread %d, sequence %d, with some payload text", t, i);
+				samples.push_back(duration_cast<nanoseconds>(steady_clock::now() - begin).count());
+			}
+		}));
+	}
+	for (size_t t = 0; t < workers.size(); t++)
+		workers[t].join();
+	double callSec = duration_cast<duration<double> >(steady_clock::now() - start).count();
+
+	// Include the time the write threads need to drain the queues
+	Logger::DropAll();
+	double totalSec = duration_cast<duration<double> >(steady_clock::now() - start).count();
+
+	vector<long long> all;
+	for (int t = 0; t < threads; t++)
+		all.insert(all.end(), latencies[t].begin(), latencies[t].end());
+	sort(all.begin(), all.end());
+
+	unsigned int rotated = 0;
+	while (LoggerUtil::FileExists(aplLogFile + "." + to_string(rotated + 1)))
+		rotated++;
+
+	size_t count = all.size();
+	printf("%-22s %10.0f rec/s (drained %10.0f rec/s)  p50 %6lld ns  p99 %7lld ns  p99.9 %8lld ns  max %9lld ns"
+		"  rotated files %u\n", name, count / callSec, count / totalSec, all[count / 2], all[count * 99 / 100],
+		all[count * 999 / 1000], all[count - 1], rotated);
+}
+
+int main(int argc, char *argv[])
+{
+	string dir = argc > 1 ? argv[1] : "/tmp";
+	int records = argc > 2 ? atoi(argv[2]) : 200000;
+	int threads = argc > 3 ? atoi(argv[3]) : 2;
+
+	try {
+		LoggerOptions none;
+		Run("no rotation", dir, none, records, threads);
+
+		LoggerOptions size16m;
+		size16m.rotateSize = 16 * 1024 * 1024;
+		Run("rotate every 16 MiB", dir, size16m, records, threads);
+
+		LoggerOptions size1m;
+		size1m.rotateSize = 1024 * 1024;
+		Run("rotate every 1 MiB", dir, size1m, records, threads);
+
+		LoggerOptions size64k;
+		size64k.rotateSize = 64 * 1024;
+		Run("rotate every 64 KiB", dir, size64k, records, threads);
+	} catch (LoggerException& e) {
+		cerr << "rotation_bench: " << e.GetMsg() << endl;
+		return 1;
+	}
+	return 0;
+}
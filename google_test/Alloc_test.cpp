@@ -0,0 +1,285 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <dlfcn.h>
+#include <atomic>
+#include <new>
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "Logger.h"
+
+// Built as its own executable (cpplogger_alloc_test): replacing the allocation functions affects the whole
+// program, so the other tests are kept out of it.
+
+using namespace std;
+using namespace cpplogger;
+
+//! Set while the allocations are counted
+static std::atomic<bool> countAllocs(false);
+//! Number of allocations counted
+static std::atomic<int> allocs(0);
+
+//! The allocation functions of the C library, resolved on the first call
+static void *(*nextMalloc)(size_t) = NULL;
+static void *(*nextCalloc)(size_t, size_t) = NULL;
+static void *(*nextRealloc)(void *, size_t) = NULL;
+static int (*nextPosixMemalign)(void **, size_t, size_t) = NULL;
+static void (*nextFree)(void *) = NULL;
+
+//! dlsym() may allocate while the functions are resolved, those allocations are served from this buffer
+static char bootstrap[4096] __attribute__((aligned(16)));
+static size_t bootstrapUsed = 0;
+
+static bool is_bootstrap(void *ptr)
+{
+	return (char *) ptr >= bootstrap && (char *) ptr < bootstrap + sizeof(bootstrap);
+}
+
+static void *bootstrap_alloc(size_t size)
+{
+	size = (size + 15) & ~(size_t) 15;
+	if (bootstrapUsed + size > sizeof(bootstrap))
+		return NULL;
+	void *ptr = bootstrap + bootstrapUsed;
+	bootstrapUsed += size;
+	return ptr;
+}
+
+//! Resolve the allocation functions of the C library (the process is single-threaded on the first call)
+static bool resolve_allocator()
+{
+	static bool resolving = false;
+	if (nextFree != NULL)
+		return true;
+	if (resolving)
+		return false;
+
+	resolving = true;
+	nextMalloc = (void *(*)(size_t)) dlsym(RTLD_NEXT, "malloc");
+	nextCalloc = (void *(*)(size_t, size_t)) dlsym(RTLD_NEXT, "calloc");
+	nextRealloc = (void *(*)(void *, size_t)) dlsym(RTLD_NEXT, "realloc");
+	nextPosixMemalign = (int (*)(void **, size_t, size_t)) dlsym(RTLD_NEXT, "posix_memalign");
+	nextFree = (void (*)(void *)) dlsym(RTLD_NEXT, "free");
+	resolving = false;
+	if (nextMalloc == NULL || nextCalloc == NULL || nextRealloc == NULL || nextPosixMemalign == NULL ||
+		nextFree == NULL)
+		abort();
+	return true;
+}
+
+static void count_alloc()
+{
+	if (countAllocs.load(std::memory_order_relaxed))
+		allocs.fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * Counts the malloc() calls of all threads while countAllocs is set.
+ *
+ * @param	size	The size to allocate.
+ * @return	The allocated memory.
+ */
+extern "C" void *malloc(size_t size)
+{
+	if (!resolve_allocator())
+		return bootstrap_alloc(size);
+	count_alloc();
+	return nextMalloc(size);
+}
+
+/**
+ * Counts the calloc() calls of all threads while countAllocs is set.
+ *
+ * @param	count	The number of elements.
+ * @param	size	The size of an element.
+ * @return	The allocated memory (zeroed).
+ */
+extern "C" void *calloc(size_t count, size_t size)
+{
+	// The bootstrap buffer is zero until used
+	if (!resolve_allocator())
+		return size == 0 || count <= sizeof(bootstrap) / size ? bootstrap_alloc(count * size) : NULL;
+	count_alloc();
+	return nextCalloc(count, size);
+}
+
+/**
+ * Counts the realloc() calls of all threads while countAllocs is set.
+ *
+ * @param	ptr		The memory to resize (NULL to allocate).
+ * @param	size	The new size.
+ * @return	The reallocated memory.
+ */
+extern "C" void *realloc(void *ptr, size_t size)
+{
+	if (!resolve_allocator() || is_bootstrap(ptr)) {
+		void *moved = malloc(size);
+		if (moved != NULL && ptr != NULL)
+			memcpy(moved, ptr, std::min(size, (size_t) (bootstrap + sizeof(bootstrap) - (char *) ptr)));
+		return moved;
+	}
+	count_alloc();
+	return nextRealloc(ptr, size);
+}
+
+/**
+ * Counts the posix_memalign() calls of all threads while countAllocs is set.
+ *
+ * @param	ptr			Where the allocated memory is stored.
+ * @param	alignment	The alignment.
+ * @param	size		The size to allocate.
+ * @return	0 or an error number.
+ */
+extern "C" int posix_memalign(void **ptr, size_t alignment, size_t size)
+{
+	if (!resolve_allocator())
+		return ENOMEM;
+	count_alloc();
+	return nextPosixMemalign(ptr, alignment, size);
+}
+
+//! Frees memory, the bootstrap buffer is never freed
+extern "C" void free(void *ptr)
+{
+	if (ptr == NULL || is_bootstrap(ptr))
+		return;
+	if (resolve_allocator())
+		nextFree(ptr);
+}
+
+// operator new goes through malloc() (counted there), whichever standard library is linked
+
+void *operator new(size_t size)
+{
+	void *ptr = malloc(size > 0 ? size : 1);
+	if (ptr == NULL)
+		throw std::bad_alloc();
+	return ptr;
+}
+
+void *operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+	free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+	free(ptr);
+}
+
+int main(int argc, char *argv[])
+{
+    ::testing::InitGoogleMock(&argc, argv);
+    return RUN_ALL_TESTS();
+}
+
+/**
+ * Logs one record with each interface.
+ *
+ * @param	i	The record number.
+ */
+static void log_all(int i)
+{
+	Logger::Info(1, L"Alloc record (%d) %s", i, "wide");
+	Logger::Info(1, "Alloc record (%d) %s", i, "narrow");
+	Logger::Error(2, CPPLOGGER_FMT("Alloc record ({}) {}"), i, "fmt");
+	Logger::Warn(3, "Alloc record (%d)", i);
+	Logger::Event(L"Alloc record (%d)", i);
+	Logger::Debug(L"Alloc record (%d)", i);
+}
+
+/**
+ * Logs records once the queues are warm, counting the allocations of all threads.
+ *
+ * @return	The number of allocations.
+ */
+static int count_log_allocs()
+{
+	for (int i = 0; i < LOG_QUEUE_CAPACITY; i++)
+		log_all(i);
+	usleep(100000);
+
+	allocs = 0;
+	countAllocs = true;
+	for (int i = 0; i < 1000; i++)
+		log_all(i);
+	// Count the writers draining the queues too
+	usleep(100000);
+	countAllocs = false;
+	return allocs.load();
+}
+
+//TEST: Alloc -- the counting functions see every allocation path
+TEST(AllocTest, Test_Alloc_00_N)
+{
+	// Kept in a volatile, so that the compiler does not remove the allocations
+	static void *volatile kept;
+	allocs = 0;
+	countAllocs = true;
+	kept = malloc(16);
+	kept = realloc(kept, 4096);
+	free(kept);
+	kept = calloc(4, 16);
+	free(kept);
+	void *ptr = NULL;
+	EXPECT_EQ(0, posix_memalign(&ptr, 64, 64));
+	kept = ptr;
+	free(kept);
+	std::string *volatile str = new std::string(256, 'x');
+	delete str;
+	countAllocs = false;
+	EXPECT_LE(6, allocs.load());
+}
+
+/**
+ * Normal test.
+ * Once the queues are warm, logging records up to the reserved size makes no allocation in any thread.
+ */
+TEST(AllocTest, Test_Alloc_01_N)
+{
+	string aplLogFile = "/home/ec2-user/repos/cpplogger/logs/apl_test_alloc_01_n.log";
+	string dbgLogFile = "/home/ec2-user/repos/cpplogger/logs/debug_test_alloc_01_n.log";
+	string evntLogFile = "/home/ec2-user/repos/cpplogger/logs/event_test_alloc_01_n.log";
+
+	Logger::Init(aplLogFile, dbgLogFile, evntLogFile);
+	Logger::EnableFileLogging(true);
+	Logger::EnableConsoleLogging(false);
+	Logger::SetLogSeverityLevel(DEBUG);
+
+	EXPECT_EQ(0, count_log_allocs());
+
+	// Release and close all loggers
+	Logger::DropAll();
+}
+
+/**
+ * Normal test.
+ * With deferred formatting, queuing the arguments of a record makes no allocation either.
+ */
+TEST(AllocTest, Test_Alloc_02_N)
+{
+	string aplLogFile = "/home/ec2-user/repos/cpplogger/logs/apl_test_alloc_02_n.log";
+	string dbgLogFile = "/home/ec2-user/repos/cpplogger/logs/debug_test_alloc_02_n.log";
+	string evntLogFile = "/home/ec2-user/repos/cpplogger/logs/event_test_alloc_02_n.log";
+
+	Logger::Init(aplLogFile, dbgLogFile, evntLogFile);
+	Logger::EnableFileLogging(true);
+	Logger::EnableConsoleLogging(false);
+	Logger::SetLogSeverityLevel(DEBUG);
+	Logger::EnableDeferredFormatting(true);
+
+	int count = count_log_allocs();
+	Logger::EnableDeferredFormatting(false);
+	EXPECT_EQ(0, count);
+
+	// Release and close all loggers
+	Logger::DropAll();
+}
@@ -1,5 +1,7 @@
 #include <stdio.h>
 #include <algorithm>
+#include <sys/wait.h>
+#include <sstream>
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
@@ -868,4 +870,1976 @@ TEST_F(LoggerTest, Test_Init_12_A)
     } catch(...) {
         FAIL() << "Expected Logger::Init() failed to validate event log file (/var/log/cpplogger_file_noaccess/event.log) permissions";
     }
-}
\ No newline at end of file
+}
+//TEST: LockFreeQueue -- multiple producers, single consumer
+TEST_F(LoggerTest, Test_Queue_01_N)
+{
+	LockFreeWStringQueue queue(64);
+	const int producers = 4;
+	const int records = 10000;
+	std::vector<std::thread> threads;
+
+	for (int p = 0; p < producers; p++) {
+		threads.push_back(std::thread([&queue, p]() {
+			for (int i = 0; i < records; i++)
+				queue.push(LoggerUtil::StrFormat(L"%d:%d", p, i));
+		}));
+	}
+
+	// Records of one producer must come out in order
+	std::vector<int> next(producers, 0);
+	int popped = 0;
+	wstring tmp;
+	while (popped < producers * records) {
+		if (!queue.pop(tmp))
+			continue;
+		int p = 0, i = 0;
+		swscanf(tmp.c_str(), L"%d:%d", &p, &i);
+		EXPECT_EQ(next[p], i);
+		next[p] = i + 1;
+		popped++;
+	}
+
+	for (size_t t = 0; t < threads.size(); t++)
+		threads[t].join();
+
+	EXPECT_FALSE(queue.pop(tmp));
+}
+
+//TEST: LockFreeQueue -- full queue rejects try_push
+TEST_F(LoggerTest, Test_Queue_02_N)
+{
+	LockFreeWStringQueue queue(4);
+	EXPECT_TRUE(queue.try_push(L"1"));
+	EXPECT_TRUE(queue.try_push(L"2"));
+	EXPECT_TRUE(queue.try_push(L"3"));
+	EXPECT_TRUE(queue.try_push(L"4"));
+	EXPECT_FALSE(queue.try_push(L"5"));
+
+	wstring tmp;
+	EXPECT_TRUE(queue.pop(tmp));
+	EXPECT_EQ(wstring(L"1"), tmp);
+	EXPECT_TRUE(queue.try_push(L"5"));
+}
+
+//TEST: LockFreeQueue -- consumer blocked in wait() is woken by the first push
+TEST_F(LoggerTest, Test_Queue_03_N)
+{
+	LockFreeWStringQueue queue(16);
+	std::chrono::steady_clock::time_point pushed;
+	std::chrono::steady_clock::time_point woken;
+
+	std::thread consumer([&queue, &woken]() {
+		wstring tmp;
+		while (!queue.pop(tmp))
+			queue.wait();
+		woken = std::chrono::steady_clock::now();
+	});
+
+	LoggerUtil::Sleep(50);
+	pushed = std::chrono::steady_clock::now();
+	queue.push(L"record");
+	consumer.join();
+
+	EXPECT_LT(std::chrono::duration_cast<std::chrono::milliseconds>(woken - pushed).count(), 50);
+}
+
+//TEST: LockFreeQueue -- batch pop takes every pending record in order
+TEST_F(LoggerTest, Test_Queue_04_N)
+{
+	LockFreeWStringQueue queue(16);
+	std::vector<wstring> batch;
+
+	for (int i = 0; i < 10; i++)
+		queue.push(LoggerUtil::StrFormat(L"%d", i));
+
+	EXPECT_EQ(4u, queue.pop_batch(batch, 0, 4));
+	EXPECT_EQ(6u, queue.pop_batch(batch, 4, 16));
+	EXPECT_EQ(0u, queue.pop_batch(batch, 10, 16));
+	for (int i = 0; i < 10; i++)
+		EXPECT_EQ(LoggerUtil::StrFormat(L"%d", i), batch[i]);
+}
+
+// Queue element whose copy blocks while stalled, holding its producer between claiming a slot and publishing it
+struct StalledValue
+{
+	static std::atomic<bool> stall;
+	static std::atomic<bool> stalled;
+	int value;
+
+	StalledValue(int value = 0) : value(value) { }
+	StalledValue(const StalledValue& other) = default;
+	StalledValue(StalledValue&& other) = default;
+	StalledValue& operator=(StalledValue&& other) = default;
+	StalledValue& operator=(const StalledValue& other)
+	{
+		if (other.value < 0) {
+			stalled = true;
+			while (stall)
+				std::this_thread::yield();
+		}
+		value = other.value;
+		return *this;
+	}
+	void reserve(size_t) { }
+};
+std::atomic<bool> StalledValue::stall(false);
+std::atomic<bool> StalledValue::stalled(false);
+
+//TEST: LockFreeQueue -- a consumer asleep on a stalled head slot is woken when the slot is published
+TEST_F(LoggerTest, Test_Queue_06_N)
+{
+	LockFreeQueue<StalledValue> queue(16);
+	Doorbell doorbell;
+	queue.set_doorbell(&doorbell);
+
+	// The first producer claims the head slot and stalls before publishing it
+	StalledValue::stall = true;
+	StalledValue::stalled = false;
+	std::thread first([&queue]() { queue.push(StalledValue(-1)); });
+	while (!StalledValue::stalled)
+		std::this_thread::yield();
+
+	std::atomic<bool> done(false);
+	std::thread consumer([&queue, &doorbell, &done]() {
+		std::vector<StalledValue> batch;
+		size_t count = 0;
+		while (count < 2) {
+			unsigned long rings = doorbell.Rings();
+			count += queue.pop_batch(batch, count, 16);
+			if (count < 2)
+				doorbell.Wait(rings, 2000);
+		}
+		done = true;
+	});
+
+	// A later record is published behind the head slot, the consumer still finds the head unpublished
+	LoggerUtil::Sleep(50);
+	queue.push(StalledValue(1));
+	LoggerUtil::Sleep(50);
+	EXPECT_FALSE(done);
+
+	std::chrono::steady_clock::time_point published = std::chrono::steady_clock::now();
+	StalledValue::stall = false;
+	first.join();
+	consumer.join();
+	EXPECT_LT(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - published).count(),
+		500);
+}
+
+//TEST: LockFreeQueue -- producers dropping the oldest element pop concurrently with the consumer
+TEST_F(LoggerTest, Test_Queue_07_N)
+{
+	LockFreeWStringQueue queue(16);
+	const int producers = 4;
+	const int records = 10000;
+	std::vector<std::vector<wstring> > taken(producers + 1);
+	std::atomic<int> running(producers);
+	std::vector<std::thread> threads;
+
+	// Like OVERFLOW_DROP_OLDEST, a producer pops the oldest element while the queue is full
+	for (int p = 0; p < producers; p++) {
+		threads.push_back(std::thread([&queue, &taken, &running, p]() {
+			wstring oldest;
+			for (int i = 0; i < records; i++) {
+				wstring record = LoggerUtil::StrFormat(L"%d:%d", p, i);
+				while (!queue.try_push(record)) {
+					if (queue.pop(oldest))
+						taken[p].push_back(oldest);
+				}
+			}
+			running--;
+		}));
+	}
+
+	std::vector<wstring> batch;
+	for (;;) {
+		bool last = running == 0;
+		size_t count = queue.pop_batch(batch, 0, 8);
+		taken[producers].insert(taken[producers].end(), batch.begin(), batch.begin() + count);
+		if (last && count == 0)
+			break;
+	}
+	for (size_t t = 0; t < threads.size(); t++)
+		threads[t].join();
+
+	// Every record is taken exactly once, and in order by each thread
+	std::vector<int> seen(producers * records, 0);
+	for (size_t t = 0; t < taken.size(); t++) {
+		std::vector<int> last(producers, -1);
+		for (size_t r = 0; r < taken[t].size(); r++) {
+			int p = 0, i = 0;
+			swscanf(taken[t][r].c_str(), L"%d:%d", &p, &i);
+			EXPECT_LT(last[p], i);
+			last[p] = i;
+			seen[p * records + i]++;
+		}
+	}
+	EXPECT_EQ(seen.size(), (size_t) std::count(seen.begin(), seen.end(), 1));
+	EXPECT_FALSE(queue.pop(batch[0]));
+}
+
+//TEST: Batch -- every record is written when batching with a latency
+TEST_F(LoggerTest, Test_Batch_01_N)
+{
+	string aplLogFile = "/home/ec2-user/repos/cpplogger/logs/apl_test_batch_01_n.log";
+	string dbgLogFile = "/home/ec2-user/repos/cpplogger/logs/debug_test_batch_01_n.log";
+	string evntLogFile = "/home/ec2-user/repos/cpplogger/logs/event_test_batch_01_n.log";
+	remove(aplLogFile.c_str());
+
+	Logger::Init(aplLogFile, dbgLogFile, evntLogFile);
+	Logger::EnableFileLogging(true);
+	Logger::EnableConsoleLogging(false);
+	Logger::SetLogSeverityLevel(INFO);
+	Logger::SetBatchSize(64);
+	Logger::SetBatchLatency(5);
+
+	for (int i = 0; i < 5000; i++)
+		Logger::Info(L"Writing batched record (%d)", i);
+
+	// Release and close all loggers
+	Logger::DropAll();
+	Logger::SetBatchSize(BATCH_SIZE_DEFAULT);
+	Logger::SetBatchLatency(BATCH_LATENCY_MS_DEFAULT);
+
+	std::ifstream in(aplLogFile.c_str());
+	std::string line;
+	int lines = 0;
+	while (std::getline(in, line))
+		lines++;
+	EXPECT_EQ(5000, lines);
+}
+
+// Encodes the arguments and formats them back (deferred formatting round trip)
+static wstring format_deferred(const wchar_t *format, ...)
+{
+	va_list vl;
+	va_start(vl, format);
+	std::string args;
+	LoggerUtil::EncodeArgs(format, vl, args);
+	va_end(vl);
+
+	wchar_t buff[MAX_LEN_FMT_BUFFER];
+	if (LoggerUtil::FormatArgs(buff, MAX_LEN_FMT_BUFFER, format, args.data(), args.size()) < 0)
+		return L"<error>";
+	return wstring(buff);
+}
+
+//TEST: Deferred formatting -- encoded arguments are formatted like vswprintf
+TEST_F(LoggerTest, Test_Deferred_01_N)
+{
+	short sh = -3;
+	EXPECT_EQ(LoggerUtil::StrFormat(L"%d %5i %-3u|%x %#X %o %hd %hhu", -42, 7, 3u, 255u, 255u, 8u, sh, 300),
+		format_deferred(L"%d %5i %-3u|%x %#X %o %hd %hhu", -42, 7, 3u, 255u, 255u, 8u, sh, 300));
+	EXPECT_EQ(LoggerUtil::StrFormat(L"%ld %lld %zu %lu", -1L, 1LL << 40, (size_t) 12, 99UL),
+		format_deferred(L"%ld %lld %zu %lu", -1L, 1LL << 40, (size_t) 12, 99UL));
+	EXPECT_EQ(LoggerUtil::StrFormat(L"%.3f %e %g %Lf %*d %.*f", 3.14159, 1e10, 0.5, 2.5L, 6, 42, 2, 1.005),
+		format_deferred(L"%.3f %e %g %Lf %*d %.*f", 3.14159, 1e10, 0.5, 2.5L, 6, 42, 2, 1.005));
+	EXPECT_EQ(LoggerUtil::StrFormat(L"[%s] [%S] [%ls] [%.2s] [%c] [%%]", "narrow", L"wide", L"wide", "abc", 'x'),
+		format_deferred(L"[%s] [%S] [%ls] [%.2s] [%c] [%%]", "narrow", L"wide", L"wide", "abc", 'x'));
+	EXPECT_EQ(LoggerUtil::StrFormat(L"%p", (void *) 0x1234), format_deferred(L"%p", (void *) 0x1234));
+}
+
+//TEST: Deferred formatting -- records written by the write thread
+TEST_F(LoggerTest, Test_Deferred_02_N)
+{
+	string aplLogFile = "/home/ec2-user/repos/cpplogger/logs/apl_test_deferred_02_n.log";
+	string dbgLogFile = "/home/ec2-user/repos/cpplogger/logs/debug_test_deferred_02_n.log";
+	string evntLogFile = "/home/ec2-user/repos/cpplogger/logs/event_test_deferred_02_n.log";
+	remove(aplLogFile.c_str());
+
+	Logger::Init(aplLogFile, dbgLogFile, evntLogFile);
+	Logger::EnableFileLogging(true);
+	Logger::EnableConsoleLogging(false);
+	Logger::SetLogSeverityLevel(INFO);
+	Logger::EnableDeferredFormatting(true);
+
+	Logger::Info(LOGGER_CODE_INFO_APP_START, L"user %s took %d ms", "alice", 42);
+	Logger::Error(L"Writing error level logging (%.1f)", 2.5);
+
+	// Release and close all loggers
+	Logger::DropAll();
+	Logger::EnableDeferredFormatting(false);
+
+	std::ifstream in(aplLogFile.c_str());
+	std::string line;
+	ASSERT_TRUE(std::getline(in, line));
+	EXPECT_NE(std::string::npos, line.find(" [INFO]: I000002, user alice took 42 ms"));
+	ASSERT_TRUE(std::getline(in, line));
+	EXPECT_NE(std::string::npos, line.find(" [ERR ]: E800001, Writing error level logging (2.5)"));
+}
+
+// Encodes the arguments and formats them back into a buffer of len characters, filled with '#' first
+static wstring format_deferred_n(size_t len, const wchar_t *format, ...)
+{
+	va_list vl;
+	va_start(vl, format);
+	std::string args;
+	LoggerUtil::EncodeArgs(format, vl, args);
+	va_end(vl);
+
+	std::vector<wchar_t> buff(len, L'#');
+	if (LoggerUtil::FormatArgs(buff.data(), len, format, args.data(), args.size()) < 0)
+		return L"<error>";
+	return wstring(buff.data());
+}
+
+//TEST: Deferred formatting -- truncation, encoding errors and unknown conversions
+TEST_F(LoggerTest, Test_Deferred_03_A)
+{
+	// A truncated conversion fills the buffer
+	EXPECT_EQ(L"id=abcdefghijk", format_deferred_n(15, L"id=%s", "abcdefghijklmnop"));
+	EXPECT_EQ(L"id=1234567", format_deferred_n(11, L"id=%d!", 1234567890));
+	// A conversion that cannot be encoded ends the output before it
+	EXPECT_EQ(L"bad ", format_deferred_n(64, L"bad %s %d", "\xff\xfe", 1));
+	// Unknown conversions are copied as is
+	EXPECT_EQ(L"%y 5 %5k", format_deferred_n(64, L"%y %d %5k", 5));
+}
+
+// Formats the arguments with a compile-time format string
+template <typename F, typename... Args>
+static std::string format_typesafe(F, const Args&... args)
+{
+	CPPLOGGER_CHECK_FMT(F, Args);
+	FormatBuffer buffer;
+	LogFormatter::Format(buffer, F::Value(), args...);
+	return std::string(buffer.c_str());
+}
+
+//TEST: Type-safe interface -- arguments are formatted per type
+TEST_F(LoggerTest, Test_TypeSafe_01_N)
+{
+	EXPECT_EQ(std::string("user 42 took -7 ms"), format_typesafe(CPPLOGGER_FMT("user {} took {} ms"), 42u, -7));
+	EXPECT_EQ(std::string("{literal} 2.5 true x"), format_typesafe(CPPLOGGER_FMT("{{literal}} {} {} {}"), 2.5, true, 'x'));
+	EXPECT_EQ(std::string("a=abc b=def c=wide"),
+		format_typesafe(CPPLOGGER_FMT("a={} b={} c={}"), "abc", std::string("def"), L"wide"));
+	EXPECT_EQ(std::string("-9223372036854775808 18446744073709551615"),
+		format_typesafe(CPPLOGGER_FMT("{} {}"), (long long) (-9223372036854775807LL - 1), ~0ULL));
+	EXPECT_EQ(std::string("no placeholders"), format_typesafe(CPPLOGGER_FMT("no placeholders")));
+	EXPECT_EQ(-1, LogFormatter::CountPlaceholders("unmatched { brace"));
+}
+
+//TEST: Type-safe interface -- records written to the log files
+TEST_F(LoggerTest, Test_TypeSafe_02_N)
+{
+	string aplLogFile = "/home/ec2-user/repos/cpplogger/logs/apl_test_typesafe_02_n.log";
+	string dbgLogFile = "/home/ec2-user/repos/cpplogger/logs/debug_test_typesafe_02_n.log";
+	string evntLogFile = "/home/ec2-user/repos/cpplogger/logs/event_test_typesafe_02_n.log";
+	remove(aplLogFile.c_str());
+	remove(dbgLogFile.c_str());
+
+	Logger::Init(aplLogFile, dbgLogFile, evntLogFile);
+	Logger::EnableFileLogging(true);
+	Logger::EnableConsoleLogging(false);
+	Logger::SetLogSeverityLevel(INFO);
+
+	Logger::Info(LOGGER_CODE_INFO_APP_START, CPPLOGGER_FMT("user {} took {} ms"), "alice", 42);
+	{
+		CallLog log(CPPLOGGER_FMT("LoggerTest::TypeSafe(val={})"), 25);
+	}
+
+	// Release and close all loggers
+	Logger::DropAll();
+
+	std::ifstream apl(aplLogFile.c_str());
+	std::string line;
+	ASSERT_TRUE(std::getline(apl, line));
+	EXPECT_NE(std::string::npos, line.find(" [INFO]: I000002, user alice took 42 ms"));
+
+	std::ifstream dbg(dbgLogFile.c_str());
+	ASSERT_TRUE(std::getline(dbg, line));
+	EXPECT_NE(std::string::npos, line.find(" [DEBUG]: LoggerTest::TypeSafe(val=25) Enter"));
+	ASSERT_TRUE(std::getline(dbg, line));
+	EXPECT_NE(std::string::npos, line.find(" [DEBUG]: LoggerTest::TypeSafe(val=25) Leave"));
+}
+
+//TEST: Type-safe interface -- mutable string buffers are written as strings, not as pointers
+TEST_F(LoggerTest, Test_TypeSafe_03_N)
+{
+	string aplLogFile = "/home/ec2-user/repos/cpplogger/logs/apl_test_typesafe_03_n.log";
+	string dbgLogFile = "/home/ec2-user/repos/cpplogger/logs/debug_test_typesafe_03_n.log";
+	string evntLogFile = "/home/ec2-user/repos/cpplogger/logs/event_test_typesafe_03_n.log";
+	remove(aplLogFile.c_str());
+
+	Logger::Init(aplLogFile, dbgLogFile, evntLogFile);
+	Logger::EnableFileLogging(true);
+	Logger::EnableConsoleLogging(false);
+	Logger::SetLogSeverityLevel(INFO);
+
+	char buf[64];
+	snprintf(buf, sizeof(buf), "user%d", 7);
+	char *name = buf;
+	wchar_t wbuf[16] = L"host";
+	wchar_t *host = wbuf;
+	Logger::Info(CPPLOGGER_FMT("a={} b={} c={} d={}"), buf, name, wbuf, host);
+	EXPECT_EQ(std::string("a=user7 b=user7 c=host d=host"),
+		format_typesafe(CPPLOGGER_FMT("a={} b={} c={} d={}"), buf, name, wbuf, host));
+
+	// Release and close all loggers
+	Logger::DropAll();
+
+	std::ifstream apl(aplLogFile.c_str());
+	std::string line;
+	ASSERT_TRUE(std::getline(apl, line));
+	EXPECT_NE(std::string::npos, line.find(" [INFO]: I000001, a=user7 b=user7 c=host d=host"));
+}
+
+// Encodes the arguments of a UTF-8 format string and formats them back (deferred formatting round trip)
+static std::string format_deferred_utf8(const char *format, ...)
+{
+	va_list vl;
+	va_start(vl, format);
+	std::string args;
+	LoggerUtil::EncodeArgs(format, vl, args);
+	va_end(vl);
+
+	char buff[MAX_LEN_FMT_BUFFER];
+	if (LoggerUtil::FormatArgs(buff, MAX_LEN_FMT_BUFFER, format, args.data(), args.size()) < 0)
+		return "<error>";
+	return std::string(buff);
+}
+
+//TEST: UTF-8 -- wide strings are converted to UTF-8, invalid code points to U+FFFD
+TEST_F(LoggerTest, Test_Utf8_01_N)
+{
+	EXPECT_EQ(std::string("abc"), LoggerUtil::ToUtf8(L"abc"));
+	EXPECT_EQ(std::string("caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80"), LoggerUtil::ToUtf8(L"café € \U0001F600"));
+	EXPECT_EQ(std::string("\xEF\xBF\xBD"), LoggerUtil::ToUtf8(std::wstring(1, (wchar_t) 0xD800)));
+	EXPECT_EQ(std::string("user caf\xC3\xA9 took 42 ms"), format_deferred_utf8("user %s took %d ms", "caf\xC3\xA9", 42));
+	EXPECT_EQ(std::string("[\xE2\x82\xAC] [  7] [0x1f]"), format_deferred_utf8("[%ls] [%3d] [%#x]", L"\u20AC", 7, 31));
+}
+
+//TEST: UTF-8 -- non-ASCII records written by the wide and narrow interfaces
+TEST_F(LoggerTest, Test_Utf8_02_N)
+{
+	string aplLogFile = "/home/ec2-user/repos/cpplogger/logs/apl_test_utf8_02_n.log";
+	string dbgLogFile = "/home/ec2-user/repos/cpplogger/logs/debug_test_utf8_02_n.log";
+	string evntLogFile = "/home/ec2-user/repos/cpplogger/logs/event_test_utf8_02_n.log";
+	remove(aplLogFile.c_str());
+
+	Logger::Init(aplLogFile, dbgLogFile, evntLogFile);
+	Logger::EnableFileLogging(true);
+	Logger::EnableConsoleLogging(false);
+	Logger::SetLogSeverityLevel(INFO);
+
+	Logger::Info(L"Wide caf\u00E9 %ls", L"\u65E5\u672C");
+	Logger::Info(LOGGER_CODE_INFO_APP_START, "Narrow caf\xC3\xA9 %s", "\xE6\x97\xA5\xE6\x9C\xAC");
+	Logger::EnableDeferredFormatting(true);
+	Logger::Warn("Deferred caf\xC3\xA9 %s", "\xE6\x97\xA5\xE6\x9C\xAC");
+	Logger::Warn(L"Deferred wide caf\u00E9 %ls", L"\u65E5\u672C");
+
+	// Release and close all loggers
+	Logger::DropAll();
+	Logger::EnableDeferredFormatting(false);
+
+	std::ifstream in(aplLogFile.c_str());
+	std::string line;
+	ASSERT_TRUE(std::getline(in, line));
+	EXPECT_NE(std::string::npos, line.find(" [INFO]: I000001, Wide caf\xC3\xA9 \xE6\x97\xA5\xE6\x9C\xAC"));
+	ASSERT_TRUE(std::getline(in, line));
+	EXPECT_NE(std::string::npos, line.find(" [INFO]: I000002, Narrow caf\xC3\xA9 \xE6\x97\xA5\xE6\x9C\xAC"));
+	ASSERT_TRUE(std::getline(in, line));
+	EXPECT_NE(std::string::npos, line.find(" [WARN]: W700001, Deferred caf\xC3\xA9 \xE6\x97\xA5\xE6\x9C\xAC"));
+	ASSERT_TRUE(std::getline(in, line));
+	EXPECT_NE(std::string::npos, line.find(" [WARN]: W700001, Deferred wide caf\xC3\xA9 \xE6\x97\xA5\xE6\x9C\xAC"));
+}
+
+// Formats a time stamp with strftime (reference for the cached time stamps)
+static std::string format_time(long long timestamp, bool utc)
+{
+	time_t sec = time_t(timestamp / 1000000000LL);
+	tm time_info;
+	utc ? gmtime_r(&sec, &time_info) : localtime_r(&sec, &time_info);
+	char buff[MAX_LEN_DATE_BUFFER];
+	size_t len = strftime(buff, sizeof(buff), "%Y-%m-%d %H:%M:%S", &time_info);
+	snprintf(buff + len, sizeof(buff) - len, ".%03lld%s", (timestamp / 1000000) % 1000, utc ? "Z" : "");
+	return std::string(buff);
+}
+
+//TEST: Time stamp -- cached time stamps match strftime in every format
+TEST_F(LoggerTest, Test_Time_01_N)
+{
+	char buff[MAX_LEN_DATE_BUFFER];
+	long long now = LoggerUtil::GetTimestamp();
+	long long timestamps[] = { now, now + 1000000, now + 999000000, now + 1000000000, 1000000000LL * 86399 + 7000000 };
+
+	for (size_t i = 0; i < sizeof(timestamps) / sizeof(timestamps[0]); i++) {
+		LoggerUtil::GetTimeString(buff, timestamps[i], TIMESTAMP_LOCAL);
+		EXPECT_EQ(format_time(timestamps[i], false), std::string(buff));
+		LoggerUtil::GetTimeString(buff, timestamps[i], TIMESTAMP_UTC);
+		EXPECT_EQ(format_time(timestamps[i], true), std::string(buff));
+	}
+
+	EXPECT_EQ(19u, LoggerUtil::GetTimeString(buff, 1234567890123456789LL, TIMESTAMP_EPOCH_NS));
+	EXPECT_EQ(std::string("1234567890123456789"), std::string(buff));
+
+	long long coarse = LoggerUtil::GetTimestamp(true);
+	EXPECT_LT(std::abs(coarse - LoggerUtil::GetTimestamp()), 1000000000LL);
+}
+
+//TEST: TSC clock -- deferred records stamped with the time stamp counter get wall clock time stamps
+TEST_F(LoggerTest, Test_Tsc_01_N)
+{
+	if (!TscClock::IsInvariant())
+		return;
+
+	TscClock::Calibrate();
+	long long ns = TscClock::ToNanoseconds(TscClock::Read());
+	EXPECT_LT(std::abs(ns - LoggerUtil::GetTimestamp()), 1000000LL);
+
+	string aplLogFile = "/home/ec2-user/repos/cpplogger/logs/apl_test_tsc_01_n.log";
+	string dbgLogFile = "/home/ec2-user/repos/cpplogger/logs/debug_test_tsc_01_n.log";
+	string evntLogFile = "/home/ec2-user/repos/cpplogger/logs/event_test_tsc_01_n.log";
+	remove(aplLogFile.c_str());
+
+	Logger::Init(aplLogFile, dbgLogFile, evntLogFile);
+	Logger::EnableFileLogging(true);
+	Logger::EnableConsoleLogging(false);
+	Logger::SetLogSeverityLevel(INFO);
+	Logger::EnableDeferredFormatting(true);
+	Logger::EnableTscClock(true);
+	Logger::SetTimestampFormat(TIMESTAMP_EPOCH_NS);
+
+	long long before = LoggerUtil::GetTimestamp();
+	Logger::Info(L"TSC stamped record (%d)", 1);
+	long long after = LoggerUtil::GetTimestamp();
+
+	// Release and close all loggers
+	Logger::DropAll();
+	Logger::EnableTscClock(false);
+	Logger::EnableDeferredFormatting(false);
+	Logger::SetTimestampFormat(TIMESTAMP_LOCAL);
+
+	std::ifstream in(aplLogFile.c_str());
+	std::string line;
+	ASSERT_TRUE(std::getline(in, line));
+	EXPECT_NE(std::string::npos, line.find(" [INFO]: I000001, TSC stamped record (1)"));
+	long long stamped = atoll(line.c_str());
+	EXPECT_GT(stamped, before - 1000000LL);
+	EXPECT_LT(stamped, after + 1000000LL);
+}
+
+// Counts its calls (argument evaluation check of the logging macros)
+static int count_calls(int& calls)
+{
+	return ++calls;
+}
+
+//TEST: Logging macros -- arguments are evaluated only for enabled levels
+TEST_F(LoggerTest, Test_Macro_01_N)
+{
+	string aplLogFile = "/home/ec2-user/repos/cpplogger/logs/apl_test_macro_01_n.log";
+	string dbgLogFile = "/home/ec2-user/repos/cpplogger/logs/debug_test_macro_01_n.log";
+	string evntLogFile = "/home/ec2-user/repos/cpplogger/logs/event_test_macro_01_n.log";
+	remove(aplLogFile.c_str());
+	remove(dbgLogFile.c_str());
+
+	Logger::Init(aplLogFile, dbgLogFile, evntLogFile);
+	Logger::EnableFileLogging(true);
+	Logger::EnableConsoleLogging(false);
+	Logger::SetLogSeverityLevel(WARNING);
+	Logger::EnableDbgLogging(false);
+
+	int calls = 0;
+	CPPLOGGER_INFO(L"Skipped info (%d)", count_calls(calls));
+	CPPLOGGER_DEBUG("Skipped debug (%d)", count_calls(calls));
+	CPPLOGGER_DISCARD(Crit, L"Stripped critical (%d)", count_calls(calls));
+	EXPECT_EQ(0, calls);
+
+	CPPLOGGER_WARN(L"Written warning (%d)", count_calls(calls));
+	CPPLOGGER_ERROR(LOGGER_CODE_ERRR_APP_START, "Written error (%d)", count_calls(calls));
+	CPPLOGGER_CRIT(CPPLOGGER_FMT("Written critical ({})"), count_calls(calls));
+	EXPECT_EQ(3, calls);
+
+	// Release and close all loggers
+	Logger::DropAll();
+
+	std::ifstream in(aplLogFile.c_str());
+	std::string line;
+	ASSERT_TRUE(std::getline(in, line));
+	EXPECT_NE(std::string::npos, line.find(" [WARN]: W700001, Written warning (1)"));
+	ASSERT_TRUE(std::getline(in, line));
+	EXPECT_NE(std::string::npos, line.find(" [ERR ]: E800002, Written error (2)"));
+	ASSERT_TRUE(std::getline(in, line));
+	EXPECT_NE(std::string::npos, line.find(" [CRIT]: C900001, Written critical (3)"));
+	EXPECT_FALSE(std::getline(in, line));
+}
+
+//TEST: Logging macros -- debug and event records ignore the severity level and follow their log file switch
+TEST_F(LoggerTest, Test_Macro_02_N)
+{
+	string aplLogFile = "/home/ec2-user/repos/cpplogger/logs/apl_test_macro_02_n.log";
+	string dbgLogFile = "/home/ec2-user/repos/cpplogger/logs/debug_test_macro_02_n.log";
+	string evntLogFile = "/home/ec2-user/repos/cpplogger/logs/event_test_macro_02_n.log";
+	remove(dbgLogFile.c_str());
+	remove(evntLogFile.c_str());
+
+	Logger::Init(aplLogFile, dbgLogFile, evntLogFile);
+	Logger::EnableFileLogging(true);
+	Logger::EnableConsoleLogging(false);
+	Logger::SetLogSeverityLevel(CRITICAL);
+
+	int calls = 0;
+	CPPLOGGER_DEBUG(L"Written debug (%d)", count_calls(calls));
+	CPPLOGGER_EVENT(L"Written event (%d)", count_calls(calls));
+	EXPECT_EQ(2, calls);
+	EXPECT_TRUE(Logger::IsLogEnabled(DEBUG));
+	EXPECT_TRUE(Logger::IsLogEnabled(EVENT));
+	EXPECT_FALSE(Logger::IsLogEnabled(WARNING));
+
+	Logger::EnableDbgLogging(false);
+	Logger::EnableEvntLogging(false);
+	CPPLOGGER_DEBUG(L"Skipped debug (%d)", count_calls(calls));
+	CPPLOGGER_EVENT(L"Skipped event (%d)", count_calls(calls));
+	EXPECT_EQ(2, calls);
+
+	// Release and close all loggers
+	Logger::DropAll();
+
+	std::ifstream dbg(dbgLogFile.c_str());
+	std::string line;
+	ASSERT_TRUE(std::getline(dbg, line));
+	EXPECT_NE(std::string::npos, line.find("Written debug (1)"));
+	EXPECT_FALSE(std::getline(dbg, line));
+	std::ifstream evnt(evntLogFile.c_str());
+	ASSERT_TRUE(std::getline(evnt, line));
+	EXPECT_NE(std::string::npos, line.find("Written event (2)"));
+	EXPECT_FALSE(std::getline(evnt, line));
+}
+
+//TEST: Memory-mapped file -- writes span extents and the file is trimmed on close
+TEST_F(LoggerTest, Test_Mmap_01_N)
+{
+	string path = "/home/ec2-user/repos/cpplogger/logs/mmap_test_01_n.log";
+	remove(path.c_str());
+
+	std::string expected;
+	MappedFile file;
+	ASSERT_TRUE(file.Open(path, 4096));
+	for (int i = 0; i < 1000; i++) {
+		std::string line = "record " + std::to_string(i) + "\n";
+		ASSERT_TRUE(file.Write(line.data(), line.size()));
+		expected += line;
+	}
+	file.Close();
+
+	// Reopen and append after the trimmed end
+	ASSERT_TRUE(file.Open(path, 4096));
+	ASSERT_TRUE(file.Write("last\n", 5));
+	expected += "last\n";
+	file.Close();
+
+	std::ifstream in(path.c_str(), std::ios::binary);
+	std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+	EXPECT_EQ(expected, content);
+}
+
+//TEST: Memory-mapped file -- a file left open by a killed process ends with its last record and is appended to
+TEST_F(LoggerTest, Test_Mmap_03_A)
+{
+	string path = "/home/ec2-user/repos/cpplogger/logs/mmap_test_03_a.log";
+	remove(path.c_str());
+
+	// The child exits without closing (trimming) the file
+	pid_t pid = fork();
+	ASSERT_NE(-1, pid);
+	if (pid == 0) {
+		MappedFile file;
+		bool written = file.Open(path, 4096) && file.Write("first\n", 6);
+		_exit(written ? 0 : 1);
+	}
+	int status = 0;
+	ASSERT_EQ(pid, waitpid(pid, &status, 0));
+	ASSERT_TRUE(WIFEXITED(status));
+	ASSERT_EQ(0, WEXITSTATUS(status));
+
+	// The file size covers the extent, its NUL filled rest is overwritten
+	struct stat st;
+	ASSERT_EQ(0, stat(path.c_str(), &st));
+	EXPECT_EQ(4096, st.st_size);
+
+	MappedFile file;
+	ASSERT_TRUE(file.Open(path, 4096));
+	ASSERT_TRUE(file.Write("second\n", 7));
+	file.Close();
+
+	std::ifstream in(path.c_str(), std::ios::binary);
+	std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+	EXPECT_EQ("first\nsecond\n", content);
+}
+
+//TEST: Memory-mapped file -- a binary log left open by a killed process keeps its trailing NUL bytes
+TEST_F(LoggerTest, Test_Mmap_04_A)
+{
+	string path = "/home/ec2-user/repos/cpplogger/logs/mmap_test_04_a.log";
+	remove(path.c_str());
+
+	// A session whose last entry (an empty text line) ends with NUL bytes
+	const char header[] = { BINLOG_VERSION, TIMESTAMP_LOCAL, (char) sizeof(wchar_t), 0 };
+	std::string session = std::string(BINLOG_MAGIC) + std::string(header, sizeof(header));
+	std::string first = session;
+	const char *texts[] = { "first", "" };
+	for (size_t i = 0; i < 2; i++) {
+		uint32_t size = (uint32_t) strlen(texts[i]);
+		first += (char) BINLOG_ENTRY_TEXT;
+		first.append(reinterpret_cast<const char *>(&size), sizeof(size));
+		first += texts[i];
+	}
+	std::string second = session;
+	uint32_t size = 6;
+	second += (char) BINLOG_ENTRY_TEXT;
+	second.append(reinterpret_cast<const char *>(&size), sizeof(size));
+	second += "second";
+
+	pid_t pid = fork();
+	ASSERT_NE(-1, pid);
+	if (pid == 0) {
+		MappedFile file;
+		bool written = file.Open(path, 4096, false) && file.Write(first.data(), first.size());
+		_exit(written ? 0 : 1);
+	}
+	int status = 0;
+	ASSERT_EQ(pid, waitpid(pid, &status, 0));
+	ASSERT_TRUE(WIFEXITED(status));
+	ASSERT_EQ(0, WEXITSTATUS(status));
+
+	MappedFile file;
+	ASSERT_TRUE(file.Open(path, 4096, false));
+	EXPECT_EQ(4096u, file.Size());
+	ASSERT_TRUE(file.Write(second.data(), second.size()));
+	file.Close();
+
+	std::ifstream in(path.c_str(), std::ios::in | std::ios::binary);
+	BinaryLogReader reader;
+	std::vector<std::string> lines;
+	std::string line;
+	while (reader.ReadLine(in, line))
+		lines.push_back(line);
+	EXPECT_FALSE(reader.IsCorrupt());
+	ASSERT_EQ(3u, lines.size());
+	EXPECT_EQ("first", lines[0]);
+	EXPECT_EQ("", lines[1]);
+	EXPECT_EQ("second", lines[2]);
+}
+
+//TEST: Memory-mapped file -- log records written through the mapped sink
+TEST_F(LoggerTest, Test_Mmap_02_N)
+{
+	string aplLogFile = "/home/ec2-user/repos/cpplogger/logs/apl_test_mmap_02_n.log";
+	string dbgLogFile = "/home/ec2-user/repos/cpplogger/logs/debug_test_mmap_02_n.log";
+	string evntLogFile = "/home/ec2-user/repos/cpplogger/logs/event_test_mmap_02_n.log";
+	remove(aplLogFile.c_str());
+
+	Logger::EnableMappedFile(true);
+	Logger::Init(aplLogFile, dbgLogFile, evntLogFile);
+	Logger::EnableFileLogging(true);
+	Logger::EnableConsoleLogging(false);
+	Logger::SetLogSeverityLevel(INFO);
+
+	for (int i = 0; i < 5000; i++)
+		Logger::Info(L"Writing mapped record (%d)", i);
+
+	// Release and close all loggers
+	Logger::DropAll();
+	Logger::EnableMappedFile(false);
+
+	std::ifstream in(aplLogFile.c_str(), std::ios::binary);
+	std::string line;
+	int lines = 0;
+	while (std::getline(in, line)) {
+		EXPECT_NE(std::string::npos, line.find("Writing mapped record (" + std::to_string(lines) + ")"));
+		lines++;
+	}
+	EXPECT_EQ(5000, lines);
+}
+
+//TEST: io_uring file -- log records written asynchronously in file order
+TEST_F(LoggerTest, Test_Uring_01_N)
+{
+	string aplLogFile = "/home/ec2-user/repos/cpplogger/logs/apl_test_uring_01_n.log";
+	string dbgLogFile = "/home/ec2-user/repos/cpplogger/logs/debug_test_uring_01_n.log";
+	string evntLogFile = "/home/ec2-user/repos/cpplogger/logs/event_test_uring_01_n.log";
+	remove(aplLogFile.c_str());
+
+	Logger::EnableUringFile(true);
+	Logger::Init(aplLogFile, dbgLogFile, evntLogFile);
+	Logger::EnableFileLogging(true);
+	Logger::EnableConsoleLogging(false);
+	Logger::SetLogSeverityLevel(INFO);
+
+	for (int i = 0; i < 20000; i++)
+		Logger::Info(L"Writing io_uring record (%d)", i);
+
+	// Release and close all loggers
+	Logger::DropAll();
+	Logger::EnableUringFile(false);
+
+	// Falls back to the file stream without io_uring, the content is the same either way
+	std::ifstream in(aplLogFile.c_str(), std::ios::binary);
+	std::string line;
+	int lines = 0;
+	while (std::getline(in, line)) {
+		EXPECT_NE(std::string::npos, line.find("Writing io_uring record (" + std::to_string(lines) + ")"));
+		lines++;
+	}
+	EXPECT_EQ(20000, lines);
+}
+
+// Reads the lines of a file
+static std::vector<std::string> read_lines(const std::string& path)
+{
+	std::vector<std::string> lines;
+	std::ifstream in(path.c_str());
+	std::string line;
+	while (std::getline(in, line))
+		lines.push_back(line);
+	return lines;
+}
+
+//TEST: Rotation -- size based rotation keeps maxFiles rotated files below the size limit
+TEST_F(LoggerTest, Test_Rotate_01_N)
+{
+	string aplLogFile = "/home/ec2-user/repos/cpplogger/logs/apl_test_rotate_01_n.log";
+	string dbgLogFile = "/home/ec2-user/repos/cpplogger/logs/debug_test_rotate_01_n.log";
+	string evntLogFile = "/home/ec2-user/repos/cpplogger/logs/event_test_rotate_01_n.log";
+	for (int i = 0; i <= 5; i++)
+		remove((aplLogFile + (i ? "." + std::to_string(i) : "")).c_str());
+
+	LoggerOptions options;
+	options.rotateSize = 4096;
+	options.maxFiles = 3;
+	Logger::Init(aplLogFile, dbgLogFile, evntLogFile, options);
+	Logger::EnableFileLogging(true);
+	Logger::EnableConsoleLogging(false);
+	Logger::SetLogSeverityLevel(INFO);
+	Logger::SetBatchSize(16);
+
+	for (int i = 0; i < 2000; i++)
+		Logger::Info(L"Writing rotated record (%d)", i);
+
+	// Release and close all loggers
+	Logger::DropAll();
+	Logger::SetBatchSize(BATCH_SIZE_DEFAULT);
+
+	EXPECT_FALSE(LoggerUtil::FileExists(aplLogFile + ".4"));
+	int next = -1;
+	for (int i = 3; i >= 0; i--) {
+		std::string path = aplLogFile + (i ? "." + std::to_string(i) : "");
+		struct stat st;
+		ASSERT_EQ(0, stat(path.c_str(), &st));
+		EXPECT_LE(st.st_size, 4096);
+
+		// Records continue from the older file to the newer one
+		std::vector<std::string> lines = read_lines(path);
+		ASSERT_FALSE(lines.empty());
+		for (size_t j = 0; j < lines.size(); j++) {
+			int record = atoi(lines[j].c_str() + lines[j].rfind('(') + 1);
+			if (next >= 0) {
+				EXPECT_EQ(next, record);
+			}
+			next = record + 1;
+		}
+	}
+	EXPECT_EQ(2000, next);
+}
+
+//TEST: Rotation -- time based rotation
+TEST_F(LoggerTest, Test_Rotate_02_N)
+{
+	string aplLogFile = "/home/ec2-user/repos/cpplogger/logs/apl_test_rotate_02_n.log";
+	string dbgLogFile = "/home/ec2-user/repos/cpplogger/logs/debug_test_rotate_02_n.log";
+	string evntLogFile = "/home/ec2-user/repos/cpplogger/logs/event_test_rotate_02_n.log";
+	remove(aplLogFile.c_str());
+	remove((aplLogFile + ".1").c_str());
+
+	LoggerOptions options;
+	options.rotateIntervalSec = 1;
+	Logger::Init(aplLogFile, dbgLogFile, evntLogFile, options);
+	Logger::EnableFileLogging(true);
+	Logger::EnableConsoleLogging(false);
+	Logger::SetLogSeverityLevel(INFO);
+
+	Logger::Info(L"Before rotation");
+	LoggerUtil::Sleep(1100);
+	Logger::Info(L"After rotation");
+
+	// Release and close all loggers
+	Logger::DropAll();
+
+	std::vector<std::string> rotated = read_lines(aplLogFile + ".1");
+	std::vector<std::string> current = read_lines(aplLogFile);
+	ASSERT_EQ(1u, rotated.size());
+	ASSERT_EQ(1u, current.size());
+	EXPECT_NE(std::string::npos, rotated[0].find("Before rotation"));
+	EXPECT_NE(std::string::npos, current[0].find("After rotation"));
+}
+
+#ifdef CPPLOGGER_HAVE_ZLIB
+static std::vector<std::string> read_gzip_lines(const std::string& path)
+{
+	std::vector<std::string> lines;
+	gzFile file = gzopen(path.c_str(), "rb");
+	if (file == NULL)
+		return lines;
+	char buffer[4096];
+	while (gzgets(file, buffer, sizeof(buffer)) != NULL) {
+		std::string line(buffer);
+		if (!line.empty() && line[line.size() - 1] == '\n')
+			line.erase(line.size() - 1);
+		lines.push_back(line);
+	}
+	gzclose(file);
+	return lines;
+}
+
+//TEST: Compression -- rotated files are gzip compressed in the background
+TEST_F(LoggerTest, Test_Compress_01_N)
+{
+	string aplLogFile = "/home/ec2-user/repos/cpplogger/logs/apl_test_compress_01_n.log";
+	string dbgLogFile = "/home/ec2-user/repos/cpplogger/logs/debug_test_compress_01_n.log";
+	string evntLogFile = "/home/ec2-user/repos/cpplogger/logs/event_test_compress_01_n.log";
+	remove(aplLogFile.c_str());
+	for (int i = 1; i <= 5; i++) {
+		remove((aplLogFile + "." + std::to_string(i)).c_str());
+		remove((aplLogFile + "." + std::to_string(i) + ".gz").c_str());
+	}
+
+	LoggerOptions options;
+	options.rotateSize = 4096;
+	options.maxFiles = 3;
+	options.compression = COMPRESSION_GZIP;
+	Logger::Init(aplLogFile, dbgLogFile, evntLogFile, options);
+	Logger::EnableFileLogging(true);
+	Logger::EnableConsoleLogging(false);
+	Logger::SetLogSeverityLevel(INFO);
+	Logger::SetBatchSize(16);
+
+	for (int i = 0; i < 2000; i++)
+		Logger::Info(L"Writing compressed record (%d)", i);
+
+	// Drain the queues (the files DropAll() interrupts are compressed after the next Init())
+	Logger::DropAll();
+	Logger::SetBatchSize(BATCH_SIZE_DEFAULT);
+	Logger::Init(aplLogFile, dbgLogFile, evntLogFile, options);
+
+	// Wait for the compression thread to catch up
+	for (int i = 1; i <= 3; i++) {
+		std::string path = aplLogFile + "." + std::to_string(i);
+		for (int j = 0; j < 100 && (LoggerUtil::FileExists(path) || !LoggerUtil::FileExists(path + ".gz")); j++)
+			LoggerUtil::Sleep(100);
+	}
+
+	// Release and close all loggers
+	Logger::DropAll();
+
+	EXPECT_FALSE(LoggerUtil::FileExists(aplLogFile + ".4.gz"));
+	EXPECT_FALSE(LoggerUtil::FileExists(aplLogFile + ".compress.tmp"));
+	int next = -1;
+	for (int i = 3; i >= 0; i--) {
+		std::vector<std::string> lines;
+		if (i > 0) {
+			std::string path = aplLogFile + "." + std::to_string(i);
+			EXPECT_FALSE(LoggerUtil::FileExists(path));
+			lines = read_gzip_lines(path + ".gz");
+		} else {
+			lines = read_lines(aplLogFile);
+		}
+
+		// Records continue from the older file to the newer one
+		ASSERT_FALSE(lines.empty());
+		for (size_t j = 0; j < lines.size(); j++) {
+			int record = atoi(lines[j].c_str() + lines[j].rfind('(') + 1);
+			if (next >= 0) {
+				EXPECT_EQ(next, record);
+			}
+			next = record + 1;
+		}
+	}
+	EXPECT_EQ(2000, next);
+}
+#endif
+
+//TEST: Binary -- binary log files decode to the text format lines
+TEST_F(LoggerTest, Test_Binary_01_N)
+{
+	string aplLogFile = "/home/ec2-user/repos/cpplogger/logs/apl_test_binary_01_n.log";
+	string dbgLogFile = "/home/ec2-user/repos/cpplogger/logs/debug_test_binary_01_n.log";
+	string evntLogFile = "/home/ec2-user/repos/cpplogger/logs/event_test_binary_01_n.log";
+	remove(aplLogFile.c_str());
+
+	// Two sessions, each with its own dictionary
+	LoggerOptions options;
+	options.binaryFormat = true;
+	for (int session = 0; session < 2; session++) {
+		Logger::Init(aplLogFile, dbgLogFile, evntLogFile, options);
+		Logger::EnableFileLogging(true);
+		Logger::EnableConsoleLogging(false);
+		Logger::SetLogSeverityLevel(INFO);
+
+		Logger::Info(L"Formatted caf\u00E9 %d", session);
+		Logger::EnableDeferredFormatting(true);
+		for (int i = 0; i < 2; i++) {
+			Logger::Warn("Deferred caf\xC3\xA9 %s %d %.2f", "\xE6\x97\xA5\xE6\x9C\xAC", i, 1.5);
+			Logger::Error(LOGGER_CODE_ERRR_APP_START, L"Deferred wide %ls %05lu", L"\u65E5\u672C", 42UL);
+		}
+
+		// Release and close all loggers
+		Logger::DropAll();
+		Logger::EnableDeferredFormatting(false);
+	}
+
+	std::ifstream in(aplLogFile.c_str(), std::ios::in | std::ios::binary);
+	BinaryLogReader reader;
+	std::vector<std::string> lines;
+	std::string line;
+	while (reader.ReadLine(in, line))
+		lines.push_back(line);
+	EXPECT_FALSE(reader.IsCorrupt());
+
+	ASSERT_EQ(10u, lines.size());
+	for (int session = 0; session < 2; session++) {
+		const std::string *session_lines = &lines[session * 5];
+		EXPECT_NE(std::string::npos,
+			session_lines[0].find(" [INFO]: I000001, Formatted caf\xC3\xA9 " + std::to_string(session)));
+		for (int i = 0; i < 2; i++) {
+			EXPECT_NE(std::string::npos, session_lines[1 + i * 2].find(
+				" [WARN]: W700001, Deferred caf\xC3\xA9 \xE6\x97\xA5\xE6\x9C\xAC " + std::to_string(i) + " 1.50"));
+			EXPECT_NE(std::string::npos,
+				session_lines[2 + i * 2].find(" [ERR ]: E800002, Deferred wide \xE6\x97\xA5\xE6\x9C\xAC 00042"));
+		}
+	}
+	// 'yyyy-MM-dd HH:mm:ss.SSS' time stamps
+	EXPECT_EQ(' ', lines[1][10]);
+	EXPECT_EQ('.', lines[1][19]);
+}
+
+//TEST: Binary -- text log files are rejected by the decoder
+TEST_F(LoggerTest, Test_Binary_02_A)
+{
+	std::istringstream in("2024-01-01 00:00:00.000 [INFO]: I000001, Text line\n");
+	BinaryLogReader reader;
+	std::string line;
+	EXPECT_FALSE(reader.ReadLine(in, line));
+	EXPECT_TRUE(reader.IsCorrupt());
+}
+
+//TEST: Binary -- a corrupt entry length is reported as corrupt, not allocated
+TEST_F(LoggerTest, Test_Binary_03_A)
+{
+	const char header[] = { BINLOG_VERSION, TIMESTAMP_LOCAL, (char) sizeof(wchar_t), 0 };
+	uint32_t sizes[] = { 0xFFFFFFF0u, BINLOG_ENTRY_MAX / 2 };
+	for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+		std::string data = std::string(BINLOG_MAGIC) + std::string(header, sizeof(header));
+		data += (char) BINLOG_ENTRY_TEXT;
+		data.append(reinterpret_cast<const char *>(&sizes[i]), sizeof(sizes[i]));
+		data += "Truncated text";
+
+		std::istringstream in(data);
+		BinaryLogReader reader;
+		std::string line;
+		EXPECT_FALSE(reader.ReadLine(in, line));
+		EXPECT_TRUE(reader.IsCorrupt());
+	}
+}
+
+//TEST: Index -- time range lookups through the time index
+TEST_F(LoggerTest, Test_Index_01_N)
+{
+	string aplLogFile = "/home/ec2-user/repos/cpplogger/logs/apl_test_index_01_n.log";
+	string dbgLogFile = "/home/ec2-user/repos/cpplogger/logs/debug_test_index_01_n.log";
+	string evntLogFile = "/home/ec2-user/repos/cpplogger/logs/event_test_index_01_n.log";
+	remove(aplLogFile.c_str());
+	remove((aplLogFile + ".idx").c_str());
+
+	LoggerOptions options;
+	options.indexInterval = 1024;
+	Logger::Init(aplLogFile, dbgLogFile, evntLogFile, options);
+	Logger::EnableFileLogging(true);
+	Logger::EnableConsoleLogging(false);
+	Logger::SetLogSeverityLevel(INFO);
+	Logger::SetBatchSize(16);
+
+	for (int i = 0; i < 5000; i++) {
+		Logger::Info(L"Writing indexed record (%d)", i);
+		if (i % 500 == 0)
+			LoggerUtil::Sleep(20);
+	}
+
+	// Release and close all loggers
+	Logger::DropAll();
+	Logger::SetBatchSize(BATCH_SIZE_DEFAULT);
+
+	struct stat st;
+	ASSERT_EQ(0, stat((aplLogFile + ".idx").c_str(), &st));
+	EXPECT_EQ(0, st.st_size % sizeof(LogIndexEntry));
+	EXPECT_LT(1, st.st_size / (long) sizeof(LogIndexEntry));
+
+	std::vector<std::string> all = read_lines(aplLogFile);
+	ASSERT_EQ(5000u, all.size());
+	long long from = LogReader::ParseTimestamp(all[2000].data(), all[2000].size());
+	long long to = LogReader::ParseTimestamp(all[2999].data(), all[2999].size());
+	ASSERT_LT(0, from);
+	std::vector<std::string> expected;
+	for (size_t i = 0; i < all.size(); i++) {
+		long long timestamp = LogReader::ParseTimestamp(all[i].data(), all[i].size());
+		if (timestamp >= from && timestamp <= to)
+			expected.push_back(all[i]);
+	}
+
+	// Only part of the file is read
+	size_t begin, end;
+	LogReader::FindRange(aplLogFile, from, to, begin, end);
+	EXPECT_LT(0u, begin);
+	ASSERT_EQ(0, stat(aplLogFile.c_str(), &st));
+	EXPECT_GT((size_t) st.st_size, end);
+
+	std::vector<LogLine> lines;
+	ASSERT_TRUE(LogReader::ReadRange(aplLogFile, from, to, lines));
+	ASSERT_EQ(expected.size(), lines.size());
+	for (size_t i = 0; i < lines.size(); i++)
+		EXPECT_EQ(expected[i], lines[i].text);
+}
+
+//TEST: BlockingQueue -- bounded queue rejects try_push when full
+TEST_F(LoggerTest, Test_Queue_05_N)
+{
+	BlockingWStringQueue queue(2);
+	EXPECT_TRUE(queue.try_push(L"1"));
+	EXPECT_TRUE(queue.try_push(L"2"));
+	EXPECT_FALSE(queue.try_push(L"3"));
+	EXPECT_EQ(2u, queue.size());
+
+	wstring tmp;
+	EXPECT_TRUE(queue.pop(tmp));
+	EXPECT_TRUE(queue.try_push(L"3"));
+	EXPECT_TRUE(queue.resize(4));
+	EXPECT_TRUE(queue.try_push(L"4"));
+	EXPECT_EQ(4u, queue.capacity());
+}
+
+// Holds a log file mutex for a while, which stalls the write thread of the log file
+static std::thread stall_writer(std::mutex& mtx, unsigned int milliseconds)
+{
+	std::atomic<bool> locked(false);
+	std::thread staller([&mtx, &locked, milliseconds]() {
+		std::lock_guard<std::mutex> lock(mtx);
+		locked = true;
+		LoggerUtil::Sleep(milliseconds);
+	});
+	while (!locked)
+		std::this_thread::yield();
+	return staller;
+}
+
+//TEST: Overflow -- records are dropped when the queue is full, and the drops are summarized
+TEST_F(LoggerTest, Test_Overflow_01_N)
+{
+	string aplLogFile = "/home/ec2-user/repos/cpplogger/logs/apl_test_overflow_01_n.log";
+	string dbgLogFile = "/home/ec2-user/repos/cpplogger/logs/debug_test_overflow_01_n.log";
+	string evntLogFile = "/home/ec2-user/repos/cpplogger/logs/event_test_overflow_01_n.log";
+	remove(aplLogFile.c_str());
+
+	LoggerOptions options;
+	options.aplQueue.capacity = 16;
+	options.aplQueue.overflow = OVERFLOW_DROP_NEWEST;
+	Logger::Init(aplLogFile, dbgLogFile, evntLogFile, options);
+	Logger::EnableFileLogging(true);
+	Logger::EnableConsoleLogging(false);
+	Logger::SetLogSeverityLevel(INFO);
+
+	unsigned long droppedBefore = Logger::GetDroppedCount(INFO);
+	std::thread staller = stall_writer(worker.aplSink.mtx, 300);
+	for (int i = 0; i < 100; i++)
+		Logger::Info(L"Overflow record (%d)", i);
+	unsigned long dropped = Logger::GetDroppedCount(INFO) - droppedBefore;
+	staller.join();
+	while (worker.aplSink.queue.size() > 0)
+		LoggerUtil::Sleep(1);
+	Logger::Info(L"Recovered");
+
+	// Release and close all loggers
+	Logger::DropAll();
+
+	EXPECT_LT(0ul, dropped);
+	std::vector<std::string> lines = read_lines(aplLogFile);
+	ASSERT_EQ(100 - dropped + 2, lines.size());
+	std::string summary = " [WARN]: W700004, " + std::to_string(dropped) + " records dropped (INFO " +
+		std::to_string(dropped) + ")";
+	EXPECT_EQ(1, std::count_if(lines.begin(), lines.end(),
+		[&summary](const std::string& line) { return line.find(summary) != std::string::npos; }));
+
+	// The oldest records are kept
+	EXPECT_NE(std::string::npos, lines[0].find("Overflow record (0)"));
+	EXPECT_NE(std::string::npos, lines[lines.size() - 1].find("Recovered"));
+}
+
+//TEST: Overflow -- the oldest records are dropped to make room
+TEST_F(LoggerTest, Test_Overflow_02_N)
+{
+	string aplLogFile = "/home/ec2-user/repos/cpplogger/logs/apl_test_overflow_02_n.log";
+	string dbgLogFile = "/home/ec2-user/repos/cpplogger/logs/debug_test_overflow_02_n.log";
+	string evntLogFile = "/home/ec2-user/repos/cpplogger/logs/event_test_overflow_02_n.log";
+	remove(aplLogFile.c_str());
+
+	LoggerOptions options;
+	options.aplQueue.capacity = 16;
+	options.aplQueue.overflow = OVERFLOW_DROP_OLDEST;
+	Logger::Init(aplLogFile, dbgLogFile, evntLogFile, options);
+	Logger::EnableFileLogging(true);
+	Logger::EnableConsoleLogging(false);
+	Logger::SetLogSeverityLevel(INFO);
+
+	unsigned long droppedBefore = Logger::GetDroppedCount(WARNING);
+	std::thread staller = stall_writer(worker.aplSink.mtx, 300);
+	for (int i = 0; i < 100; i++)
+		Logger::Warn(L"Overflow record (%d)", i);
+	staller.join();
+
+	// Release and close all loggers
+	Logger::DropAll();
+
+	unsigned long dropped = Logger::GetDroppedCount(WARNING) - droppedBefore;
+	EXPECT_LT(0ul, dropped);
+	std::vector<std::string> lines = read_lines(aplLogFile);
+	ASSERT_EQ(100 - dropped + 1, lines.size());
+
+	// The newest records are kept, in order
+	int last = -1;
+	for (size_t i = 0; i < lines.size(); i++) {
+		if (lines[i].find("records dropped") != std::string::npos)
+			continue;
+		int record = atoi(lines[i].c_str() + lines[i].rfind('(') + 1);
+		EXPECT_LT(last, record);
+		last = record;
+	}
+	EXPECT_EQ(99, last);
+}
+
+//TEST: Overflow -- records below the severity threshold are dropped, the others wait
+TEST_F(LoggerTest, Test_Overflow_03_N)
+{
+	string aplLogFile = "/home/ec2-user/repos/cpplogger/logs/apl_test_overflow_03_n.log";
+	string dbgLogFile = "/home/ec2-user/repos/cpplogger/logs/debug_test_overflow_03_n.log";
+	string evntLogFile = "/home/ec2-user/repos/cpplogger/logs/event_test_overflow_03_n.log";
+	remove(aplLogFile.c_str());
+
+	LoggerOptions options;
+	options.aplQueue.capacity = 16;
+	options.aplQueue.overflow = OVERFLOW_DROP_BELOW;
+	options.aplQueue.dropBelow = ERROR;
+	Logger::Init(aplLogFile, dbgLogFile, evntLogFile, options);
+	Logger::EnableFileLogging(true);
+	Logger::EnableConsoleLogging(false);
+	Logger::SetLogSeverityLevel(INFO);
+
+	unsigned long infoBefore = Logger::GetDroppedCount(INFO);
+	unsigned long errorBefore = Logger::GetDroppedCount(ERROR);
+	std::thread staller = stall_writer(worker.aplSink.mtx, 200);
+	for (int i = 0; i < 50; i++)
+		Logger::Info(L"Overflow record (%d)", i);
+	for (int i = 0; i < 50; i++)
+		Logger::Error(L"Overflow error (%d)", i);
+	staller.join();
+
+	// Release and close all loggers
+	Logger::DropAll();
+
+	EXPECT_LT(0ul, Logger::GetDroppedCount(INFO) - infoBefore);
+	EXPECT_EQ(0ul, Logger::GetDroppedCount(ERROR) - errorBefore);
+	std::vector<std::string> lines = read_lines(aplLogFile);
+	EXPECT_EQ(50, std::count_if(lines.begin(), lines.end(),
+		[](const std::string& line) { return line.find("Overflow error") != std::string::npos; }));
+}
+
+//TEST: Overflow -- the queues are reallocated while logging threads push, once they are held back
+TEST_F(LoggerTest, Test_Overflow_04_N)
+{
+	MemorySink sink;
+	sink.queueOptions.overflow = OVERFLOW_DROP_NEWEST;
+	std::atomic<bool> stop(false);
+	std::vector<std::thread> producers;
+	for (int p = 0; p < 4; p++) {
+		producers.push_back(std::thread([&sink, &stop]() {
+			LogRecord record;
+			record.text = "Reallocated queue record";
+			while (!stop)
+				worker.Enqueue(sink, record);
+		}));
+	}
+
+	std::vector<LogRecord> batch;
+	for (int i = 0; i < 200; i++) {
+		ASSERT_TRUE(sink.Quiesce());
+		EXPECT_FALSE(worker.pushSlots.IsPushing(&sink));
+		// With no producer inside the queue, draining takes a bounded number of batches
+		for (size_t n = sink.queue.capacity() / 64 + 1; n > 0 && sink.PopBatch(batch, 0, 64) > 0; n--)
+			;
+		EXPECT_TRUE(sink.queue.resize(i % 2 == 0 ? 16 : 64));
+		EXPECT_EQ(0u, sink.queue.size());
+		sink.Resume();
+		std::this_thread::yield();
+	}
+
+	stop = true;
+	for (size_t p = 0; p < producers.size(); p++)
+		producers[p].join();
+	EXPECT_EQ(64u, sink.queue.capacity());
+}
+
+/**
+ * Normal test.
+ * The push slot of an exited thread is reused, and a slot marks the sink its thread is pushing to.
+ */
+TEST_F(LoggerTest, Test_Overflow_05_N)
+{
+	PushSlots slots;
+	MemorySink sink;
+	PushSlot *first = NULL;
+	std::thread exited([&slots, &first]() {
+		first = slots.Acquire();
+		PushSlots::Release(first);
+	});
+	exited.join();
+
+	PushSlot *slot = slots.Acquire();
+	EXPECT_EQ(first, slot);
+	EXPECT_NE(first, slots.Acquire());
+	EXPECT_FALSE(slots.IsPushing(&sink));
+	slot->sink.store(&sink);
+	EXPECT_TRUE(slots.IsPushing(&sink));
+	PushSlots::Release(slot);
+	EXPECT_FALSE(slots.IsPushing(&sink));
+}
+
+/**
+ * Normal test.
+ * Records of a code over its rate limit are suppressed and summarized, other codes are not limited.
+ */
+TEST_F(LoggerTest, Test_RateLimit_01_N)
+{
+	string aplLogFile = "/home/ec2-user/repos/cpplogger/logs/apl_test_ratelimit_01_n.log";
+	string dbgLogFile = "/home/ec2-user/repos/cpplogger/logs/debug_test_ratelimit_01_n.log";
+	string evntLogFile = "/home/ec2-user/repos/cpplogger/logs/event_test_ratelimit_01_n.log";
+	remove(aplLogFile.c_str());
+
+	Logger::Init(aplLogFile, dbgLogFile, evntLogFile);
+	Logger::EnableFileLogging(true);
+	Logger::EnableConsoleLogging(false);
+	Logger::SetLogSeverityLevel(INFO);
+
+	EXPECT_TRUE(Logger::SetRateLimit(ERROR, 2, 1, 5));
+	for (int i = 0; i < 100; i++) {
+		Logger::Error(2, L"Limited error (%d)", i);
+		Logger::Info(L"Unlimited info (%d)", i);
+	}
+
+	// Release and close all loggers, reporting the suppressed records
+	Logger::DropAll();
+	Logger::SetRateLimit(ERROR, 2, 0, 0);
+
+	std::vector<std::string> lines = read_lines(aplLogFile);
+	long written = std::count_if(lines.begin(), lines.end(),
+		[](const std::string& line) { return line.find("Limited error") != std::string::npos; });
+	EXPECT_LE(5, written);
+	EXPECT_GE(6, written);
+	EXPECT_EQ(100, std::count_if(lines.begin(), lines.end(),
+		[](const std::string& line) { return line.find("Unlimited info") != std::string::npos; }));
+	std::string summary = "E800002, suppressed " + std::to_string(100 - written) + " occurrences of E800002";
+	EXPECT_EQ(1, std::count_if(lines.begin(), lines.end(),
+		[&summary](const std::string& line) { return line.find(summary) != std::string::npos; }));
+}
+
+/**
+ * Normal test.
+ * The default rate limit per call site limits each format string separately.
+ */
+TEST_F(LoggerTest, Test_RateLimit_02_N)
+{
+	string aplLogFile = "/home/ec2-user/repos/cpplogger/logs/apl_test_ratelimit_02_n.log";
+	string dbgLogFile = "/home/ec2-user/repos/cpplogger/logs/debug_test_ratelimit_02_n.log";
+	string evntLogFile = "/home/ec2-user/repos/cpplogger/logs/event_test_ratelimit_02_n.log";
+	remove(aplLogFile.c_str());
+
+	Logger::Init(aplLogFile, dbgLogFile, evntLogFile);
+	Logger::EnableFileLogging(true);
+	Logger::EnableConsoleLogging(false);
+	Logger::SetLogSeverityLevel(INFO);
+
+	Logger::SetRateLimit(1, 3, true);
+	for (int i = 0; i < 50; i++) {
+		Logger::Warn(L"First site (%d)", i);
+		Logger::Warn(L"Second site (%d)", i);
+	}
+
+	// Release and close all loggers, reporting the suppressed records
+	Logger::DropAll();
+	Logger::SetRateLimit(0, 0);
+
+	std::vector<std::string> lines = read_lines(aplLogFile);
+	long first = std::count_if(lines.begin(), lines.end(),
+		[](const std::string& line) { return line.find("First site") != std::string::npos; });
+	long second = std::count_if(lines.begin(), lines.end(),
+		[](const std::string& line) { return line.find("Second site") != std::string::npos; });
+	EXPECT_LE(3, first);
+	EXPECT_GE(4, first);
+	EXPECT_LE(3, second);
+	EXPECT_GE(4, second);
+	EXPECT_EQ(2, std::count_if(lines.begin(), lines.end(),
+		[](const std::string& line) { return line.find("occurrences of W7") != std::string::npos; }));
+}
+
+/**
+ * Normal test.
+ * Identical consecutive records are collapsed into 'last message repeated N times'.
+ */
+TEST_F(LoggerTest, Test_Repeat_01_N)
+{
+	string aplLogFile = "/home/ec2-user/repos/cpplogger/logs/apl_test_repeat_01_n.log";
+	string dbgLogFile = "/home/ec2-user/repos/cpplogger/logs/debug_test_repeat_01_n.log";
+	string evntLogFile = "/home/ec2-user/repos/cpplogger/logs/event_test_repeat_01_n.log";
+	remove(aplLogFile.c_str());
+
+	LoggerOptions options;
+	options.repeatFlushMs = 60000;
+	Logger::Init(aplLogFile, dbgLogFile, evntLogFile, options);
+	Logger::EnableFileLogging(true);
+	Logger::EnableConsoleLogging(false);
+	Logger::SetLogSeverityLevel(INFO);
+
+	for (int i = 0; i < 50; i++)
+		Logger::Error(2, L"Retry failed (%d)", 7);
+	Logger::Error(2, L"Retry failed (%d)", 8);
+	for (int i = 0; i < 10; i++)
+		Logger::Warn(L"Still waiting");
+
+	// Release and close all loggers, reporting the pending repeats
+	Logger::DropAll();
+
+	std::vector<std::string> lines = read_lines(aplLogFile);
+	ASSERT_EQ(5u, lines.size());
+	EXPECT_NE(std::string::npos, lines[0].find("E800002, Retry failed (7)"));
+	EXPECT_NE(std::string::npos, lines[1].find("E800002, last message repeated 49 times"));
+	EXPECT_NE(std::string::npos, lines[2].find("E800002, Retry failed (8)"));
+	EXPECT_NE(std::string::npos, lines[3].find("Still waiting"));
+	EXPECT_NE(std::string::npos, lines[4].find("last message repeated 9 times"));
+}
+
+/**
+ * Normal test.
+ * Deferred records are compared by their format string and arguments, and the repeats are reported once due.
+ */
+TEST_F(LoggerTest, Test_Repeat_02_N)
+{
+	string aplLogFile = "/home/ec2-user/repos/cpplogger/logs/apl_test_repeat_02_n.log";
+	string dbgLogFile = "/home/ec2-user/repos/cpplogger/logs/debug_test_repeat_02_n.log";
+	string evntLogFile = "/home/ec2-user/repos/cpplogger/logs/event_test_repeat_02_n.log";
+	remove(aplLogFile.c_str());
+
+	LoggerOptions options;
+	options.repeatFlushMs = 100;
+	Logger::Init(aplLogFile, dbgLogFile, evntLogFile, options);
+	Logger::EnableFileLogging(true);
+	Logger::EnableConsoleLogging(false);
+	Logger::EnableDeferredFormatting(true);
+	Logger::SetLogSeverityLevel(INFO);
+
+	for (int i = 0; i < 20; i++)
+		Logger::Info(L"Connecting to %s", "db1");
+	Logger::Info(L"Connecting to %s", "db2");
+	Logger::Info(L"Connecting to %s", "db2");
+
+	// The pending repeat is reported by the write thread once due, before DropAll
+	std::this_thread::sleep_for(std::chrono::milliseconds(500));
+	std::vector<std::string> lines = read_lines(aplLogFile);
+
+	// Release and close all loggers
+	Logger::DropAll();
+	Logger::EnableDeferredFormatting(false);
+
+	ASSERT_EQ(4u, lines.size());
+	EXPECT_NE(std::string::npos, lines[0].find("Connecting to db1"));
+	EXPECT_NE(std::string::npos, lines[1].find("last message repeated 19 times"));
+	EXPECT_NE(std::string::npos, lines[2].find("Connecting to db2"));
+	EXPECT_NE(std::string::npos, lines[3].find("last message repeated 1 times"));
+}
+
+/**
+ * Normal test.
+ * The console write thread writes the records to stdout, without colors when stdout is not a terminal.
+ */
+TEST_F(LoggerTest, Test_Console_01_N)
+{
+	string aplLogFile = "/home/ec2-user/repos/cpplogger/logs/apl_test_console_01_n.log";
+	string dbgLogFile = "/home/ec2-user/repos/cpplogger/logs/debug_test_console_01_n.log";
+	string evntLogFile = "/home/ec2-user/repos/cpplogger/logs/event_test_console_01_n.log";
+	string consoleFile = "/home/ec2-user/repos/cpplogger/logs/console_test_console_01_n.log";
+	remove(consoleFile.c_str());
+
+	// Redirect stdout to a file
+	fflush(stdout);
+	int savedStdout = dup(STDOUT_FILENO);
+	int fd = open(consoleFile.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	ASSERT_LE(0, fd);
+	dup2(fd, STDOUT_FILENO);
+	close(fd);
+
+	Logger::Init(aplLogFile, dbgLogFile, evntLogFile);
+	Logger::EnableFileLogging(true);
+	Logger::EnableConsoleLogging(true);
+	Logger::SetLogSeverityLevel(INFO);
+	for (int i = 0; i < 100; i++)
+		Logger::Error(L"Console error (%d)", i);
+	Logger::Debug(L"Console debug");
+
+	// Release and close all loggers, the console write thread drains its queue
+	Logger::DropAll();
+	dup2(savedStdout, STDOUT_FILENO);
+	close(savedStdout);
+
+	std::vector<std::string> lines = read_lines(consoleFile);
+	EXPECT_EQ(100, std::count_if(lines.begin(), lines.end(),
+		[](const std::string& line) { return line.find("E800001, Console error") != std::string::npos; }));
+	EXPECT_EQ(1, std::count_if(lines.begin(), lines.end(),
+		[](const std::string& line) { return line.find("Console debug") != std::string::npos; }));
+	EXPECT_EQ(0, std::count_if(lines.begin(), lines.end(),
+		[](const std::string& line) { return line.find('\033') != std::string::npos; }));
+}
+
+//! Binds a datagram socket standing in for '/dev/log'
+static int bind_syslog(const std::string& path)
+{
+	remove(path.c_str());
+	int fd = socket(AF_UNIX, SOCK_DGRAM, 0);
+	struct sockaddr_un addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+	if (fd >= 0 && bind(fd, (struct sockaddr *) &addr, sizeof(addr)) != 0) {
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+//! Receives the datagrams waiting on the socket
+static std::vector<std::string> recv_syslog(int fd)
+{
+	std::vector<std::string> datagrams;
+	char buffer[MAX_LEN_FMT_BUFFER + 1024];
+	ssize_t n;
+	while ((n = recv(fd, buffer, sizeof(buffer), MSG_DONTWAIT)) >= 0)
+		datagrams.push_back(std::string(buffer, n));
+	return datagrams;
+}
+
+/**
+ * Normal test.
+ * The syslog interfaces send RFC 3164 datagrams to the syslog socket, through the writer threads between
+ * Init() and DropAll() and directly otherwise.
+ */
+TEST_F(LoggerTest, Test_SysLog_01_N)
+{
+	string aplLogFile = "/home/ec2-user/repos/cpplogger/logs/apl_test_syslog_01_n.log";
+	string dbgLogFile = "/home/ec2-user/repos/cpplogger/logs/debug_test_syslog_01_n.log";
+	string evntLogFile = "/home/ec2-user/repos/cpplogger/logs/event_test_syslog_01_n.log";
+	string socketPath = "/home/ec2-user/repos/cpplogger/logs/syslog_test_syslog_01_n.sock";
+	int fd = bind_syslog(socketPath);
+	ASSERT_LE(0, fd);
+
+	LoggerOptions options;
+	options.sysLogPath = socketPath;
+	options.sysLogIdent = "cpplogger-test";
+	Logger::Init(aplLogFile, dbgLogFile, evntLogFile, options);
+	Logger::SysLogError(L"Syslog error (%d)", 1);
+	Logger::SysLogWarn("Syslog warning (%s)", "narrow");
+
+	// Release and close all loggers, the writer threads drain the syslog queue
+	Logger::DropAll();
+	Logger::SysLogInfo("Syslog info after DropAll");
+
+	std::vector<std::string> datagrams = recv_syslog(fd);
+	close(fd);
+	remove(socketPath.c_str());
+
+	std::string pid = "cpplogger-test[" + std::to_string(getpid()) + "]: ";
+	ASSERT_EQ(3u, datagrams.size());
+	EXPECT_EQ(0u, datagrams[0].find("<11>"));
+	EXPECT_NE(std::string::npos, datagrams[0].find(pid + "Syslog error (1)"));
+	EXPECT_EQ(0u, datagrams[1].find("<12>"));
+	EXPECT_NE(std::string::npos, datagrams[1].find(pid + "Syslog warning (narrow)"));
+	EXPECT_EQ(0u, datagrams[2].find("<14>"));
+	EXPECT_NE(std::string::npos, datagrams[2].find(pid + "Syslog info after DropAll"));
+}
+
+/**
+ * Normal test.
+ * RFC 5424 datagrams with the facility of the options.
+ */
+TEST_F(LoggerTest, Test_SysLog_02_N)
+{
+	string aplLogFile = "/home/ec2-user/repos/cpplogger/logs/apl_test_syslog_02_n.log";
+	string dbgLogFile = "/home/ec2-user/repos/cpplogger/logs/debug_test_syslog_02_n.log";
+	string evntLogFile = "/home/ec2-user/repos/cpplogger/logs/event_test_syslog_02_n.log";
+	string socketPath = "/home/ec2-user/repos/cpplogger/logs/syslog_test_syslog_02_n.sock";
+	int fd = bind_syslog(socketPath);
+	ASSERT_LE(0, fd);
+
+	LoggerOptions options;
+	options.sysLogPath = socketPath;
+	options.sysLogFormat = SYSLOG_RFC5424;
+	options.sysLogFacility = LOG_LOCAL0;
+	options.sysLogIdent = "cpplogger-test";
+	Logger::Init(aplLogFile, dbgLogFile, evntLogFile, options);
+	Logger::SysLogCrit(L"Syslog critical");
+
+	// Release and close all loggers
+	Logger::DropAll();
+
+	std::vector<std::string> datagrams = recv_syslog(fd);
+	close(fd);
+	remove(socketPath.c_str());
+
+	// <PRI>1 TIMESTAMP HOSTNAME APP-NAME PROCID - - MSG
+	ASSERT_EQ(1u, datagrams.size());
+	EXPECT_EQ(0u, datagrams[0].find("<130>1 "));
+	EXPECT_EQ('T', datagrams[0][17]);
+	EXPECT_NE(std::string::npos, datagrams[0].find(" cpplogger-test " + std::to_string(getpid()) + " - - Syslog critical"));
+}
+
+/**
+ * Normal test.
+ * A memory sink added along with the log files receives the records of the severity levels routed to it, in
+ * order with two writer threads.
+ */
+TEST_F(LoggerTest, Test_Sink_01_N)
+{
+	string aplLogFile = "/home/ec2-user/repos/cpplogger/logs/apl_test_sink_01_n.log";
+	string dbgLogFile = "/home/ec2-user/repos/cpplogger/logs/debug_test_sink_01_n.log";
+	string evntLogFile = "/home/ec2-user/repos/cpplogger/logs/event_test_sink_01_n.log";
+	remove(aplLogFile.c_str());
+
+	std::shared_ptr<MemorySink> sink(new MemorySink(100));
+	ASSERT_TRUE(Logger::AddSink(sink, SEVERITY_MASK(ERROR) | SEVERITY_MASK(CRITICAL)));
+
+	LoggerOptions options;
+	options.writerThreads = 2;
+	Logger::Init(aplLogFile, dbgLogFile, evntLogFile, options);
+	Logger::EnableFileLogging(true);
+	Logger::EnableConsoleLogging(false);
+	Logger::SetLogSeverityLevel(INFO);
+	EXPECT_FALSE(Logger::RemoveSinks());
+	for (int i = 0; i < 150; i++)
+		Logger::Error(800002, L"Sink error (%d)", i);
+	Logger::Info(800001, L"Sink info");
+	Logger::Crit(800003, L"Sink critical");
+
+	// Release and close all loggers
+	Logger::DropAll();
+	EXPECT_TRUE(Logger::RemoveSinks());
+
+	// The last 100 lines, in order
+	std::vector<std::string> lines = sink->GetLines();
+	ASSERT_EQ(100u, lines.size());
+	for (int i = 0; i < 99; i++)
+		EXPECT_NE(std::string::npos, lines[i].find("Sink error (" + std::to_string(51 + i) + ")"));
+	EXPECT_NE(std::string::npos, lines[99].find("Sink critical"));
+
+	// The log file gets every record
+	std::ifstream file(aplLogFile);
+	size_t count = 0;
+	for (std::string line; std::getline(file, line);)
+		count++;
+	EXPECT_EQ(152u, count);
+}
+
+/**
+ * Normal test.
+ * A socket sink writes the log lines to an AF_UNIX stream socket.
+ */
+TEST_F(LoggerTest, Test_Sink_02_N)
+{
+	string aplLogFile = "/home/ec2-user/repos/cpplogger/logs/apl_test_sink_02_n.log";
+	string dbgLogFile = "/home/ec2-user/repos/cpplogger/logs/debug_test_sink_02_n.log";
+	string evntLogFile = "/home/ec2-user/repos/cpplogger/logs/event_test_sink_02_n.log";
+	string socketPath = "/home/ec2-user/repos/cpplogger/logs/sink_test_sink_02_n.sock";
+	remove(socketPath.c_str());
+
+	int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0);
+	ASSERT_LE(0, fd);
+	struct sockaddr_un addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+	ASSERT_EQ(0, bind(fd, (struct sockaddr *) &addr, sizeof(addr)));
+	ASSERT_EQ(0, listen(fd, 1));
+
+	ASSERT_TRUE(Logger::AddSink(std::shared_ptr<LogSink>(new SocketSink(socketPath)), SEVERITY_MASK(EVENT)));
+	LoggerOptions options;
+	Logger::Init(aplLogFile, dbgLogFile, evntLogFile, options);
+	Logger::EnableFileLogging(true);
+	Logger::EnableConsoleLogging(false);
+	Logger::Event(L"Sink event (%d)", 1);
+	Logger::Event(L"Sink event (%d)", 2);
+
+	// Release and close all loggers, the socket sink closes its connection
+	Logger::DropAll();
+	EXPECT_TRUE(Logger::RemoveSinks());
+
+	int conn = accept(fd, NULL, NULL);
+	ASSERT_LE(0, conn);
+	std::string received;
+	char buffer[4096];
+	ssize_t n;
+	while ((n = recv(conn, buffer, sizeof(buffer), 0)) > 0)
+		received.append(buffer, n);
+	close(conn);
+	close(fd);
+	remove(socketPath.c_str());
+
+	size_t first = received.find("Sink event (1)\n");
+	ASSERT_NE(std::string::npos, first);
+	EXPECT_NE(std::string::npos, received.find("Sink event (2)\n", first));
+}
+
+/**
+ * Finds the threads of the process with a name.
+ *
+ * @param	name	The thread name.
+ *
+ * @return	The thread IDs.
+ */
+static std::vector<pid_t> find_threads(const std::string& name)
+{
+	std::vector<pid_t> tids;
+	DIR *dir = opendir("/proc/self/task");
+	if (dir == NULL)
+		return tids;
+	for (struct dirent *entry; (entry = readdir(dir)) != NULL;) {
+		if (entry->d_name[0] == '.')
+			continue;
+		std::ifstream comm(std::string("/proc/self/task/") + entry->d_name + "/comm");
+		std::string line;
+		if (std::getline(comm, line) && line == name)
+			tids.push_back((pid_t) atoi(entry->d_name));
+	}
+	closedir(dir);
+	return tids;
+}
+
+/**
+ * Normal test.
+ * The writer threads are named, pinned to the CPUs of the options and run with their scheduling policy and
+ * nice value.
+ */
+TEST_F(LoggerTest, Test_Thread_01_N)
+{
+	string aplLogFile = "/home/ec2-user/repos/cpplogger/logs/apl_test_thread_01_n.log";
+	string dbgLogFile = "/home/ec2-user/repos/cpplogger/logs/debug_test_thread_01_n.log";
+	string evntLogFile = "/home/ec2-user/repos/cpplogger/logs/event_test_thread_01_n.log";
+
+	LoggerOptions options;
+	options.writerThreads = 2;
+	options.writerCpus.push_back(0);
+	options.writerPolicy = SCHED_BATCH;
+	options.writerNice = 5;
+	options.threadName = "cpplog-test";
+	Logger::Init(aplLogFile, dbgLogFile, evntLogFile, options);
+
+	// The threads set themselves up once started
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	for (int i = 0; i < 2; i++) {
+		std::vector<pid_t> tids = find_threads("cpplog-test-w" + std::to_string(i));
+		ASSERT_EQ(1u, tids.size());
+
+		cpu_set_t cpus;
+		ASSERT_EQ(0, sched_getaffinity(tids[0], sizeof(cpus), &cpus));
+		EXPECT_EQ(1, CPU_COUNT(&cpus));
+		EXPECT_TRUE(CPU_ISSET(0, &cpus));
+		EXPECT_EQ(SCHED_BATCH, sched_getscheduler(tids[0]));
+		EXPECT_EQ(5, getpriority(PRIO_PROCESS, (id_t) tids[0]));
+	}
+
+	// Release and close all loggers
+	Logger::DropAll();
+	EXPECT_TRUE(find_threads("cpplog-test-w0").empty());
+}
+
+/**
+ * Writes a file, creating its directory.
+ *
+ * @param	path	The file path.
+ * @param	data	The file content.
+ */
+static void write_file(const std::string& path, const std::string& data)
+{
+	std::string dir = path.substr(0, path.rfind('/'));
+	mkdir(dir.substr(0, dir.rfind('/')).c_str(), 0755);
+	mkdir(dir.c_str(), 0755);
+	std::ofstream file(path);
+	file << data;
+}
+
+/**
+ * Normal test.
+ * The NUMA nodes are read from sysfs, and the logging threads push to the queue of the node they run on.
+ */
+TEST_F(LoggerTest, Test_Numa_01_N)
+{
+	string aplLogFile = "/home/ec2-user/repos/cpplogger/logs/apl_test_numa_01_n.log";
+	string dbgLogFile = "/home/ec2-user/repos/cpplogger/logs/debug_test_numa_01_n.log";
+	string evntLogFile = "/home/ec2-user/repos/cpplogger/logs/event_test_numa_01_n.log";
+	string nodePath = "/home/ec2-user/repos/cpplogger/logs/numa_test_numa_01_n";
+	remove(aplLogFile.c_str());
+
+	std::vector<int> cpus;
+	EXPECT_TRUE(NumaTopology::ParseCpuList("0-3,8,10-11\n", cpus));
+	EXPECT_EQ(std::vector<int>({ 0, 1, 2, 3, 8, 10, 11 }), cpus);
+	EXPECT_FALSE(NumaTopology::ParseCpuList("3-1", cpus));
+
+	// Two nodes, CPU 0 (where this test runs) on the second one
+	write_file(nodePath + "/node0/cpulist", "1-3\n");
+	write_file(nodePath + "/node1/cpulist", "0\n");
+	bool loaded = worker.numaNodes.Load(nodePath);
+	for (int node = 0; node < 2; node++) {
+		remove((nodePath + "/node" + std::to_string(node) + "/cpulist").c_str());
+		rmdir((nodePath + "/node" + std::to_string(node)).c_str());
+	}
+	rmdir(nodePath.c_str());
+	ASSERT_TRUE(loaded);
+	EXPECT_EQ(2u, worker.numaNodes.Count());
+	EXPECT_EQ(1u, worker.numaNodes.NodeOf(0));
+	EXPECT_EQ(0u, worker.numaNodes.NodeOf(2));
+
+	LoggerOptions options;
+	options.numaQueues = true;
+	Logger::Init(aplLogFile, dbgLogFile, evntLogFile, options);
+	Logger::EnableFileLogging(true);
+	Logger::EnableConsoleLogging(false);
+	Logger::SetLogSeverityLevel(INFO);
+	EXPECT_EQ(1u, worker.aplSink.nodeQueueCount.load());
+	EXPECT_TRUE(worker.aplSink.hasNodeQueues.load());
+
+	cpu_set_t cpu0;
+	CPU_ZERO(&cpu0);
+	CPU_SET(0, &cpu0);
+	std::thread producer([&cpu0]() {
+		pthread_setaffinity_np(pthread_self(), sizeof(cpu0), &cpu0);
+		EXPECT_EQ(&worker.aplSink.LocalQueue(), worker.aplSink.nodeQueues[0]);
+		for (int i = 0; i < 100; i++)
+			Logger::Info(L"Numa record (%d)", i);
+	});
+	producer.join();
+
+	// Release and close all loggers
+	Logger::DropAll();
+
+	std::vector<std::string> lines = read_lines(aplLogFile);
+	ASSERT_EQ(100u, lines.size());
+	for (int i = 0; i < 100; i++)
+		EXPECT_NE(std::string::npos, lines[i].find("Numa record (" + std::to_string(i) + ")"));
+
+	// The next Init() without numaQueues uses the queue of the sink
+	options.numaQueues = false;
+	Logger::Init(aplLogFile, dbgLogFile, evntLogFile, options);
+	EXPECT_FALSE(worker.aplSink.hasNodeQueues.load());
+	EXPECT_EQ(&worker.aplSink.queue, &worker.aplSink.LocalQueue());
+	Logger::DropAll();
+}
+
+/**
+ * Normal test.
+ * The records popped from the queues of the nodes are merged by time stamp.
+ */
+TEST_F(LoggerTest, Test_Numa_02_N)
+{
+	MemorySink sink;
+	sink.AllocateNodeQueue(1, NULL);
+	ASSERT_EQ(1u, sink.nodeQueueCount.load());
+
+	LogRecord record;
+	long long node0[] = { 10, 30, 50 };
+	long long node1[] = { 20, 40, 60, 70 };
+	for (size_t i = 0; i < 3; i++) {
+		record.timestamp = node0[i];
+		sink.queue.push(record);
+	}
+	for (size_t i = 0; i < 4; i++) {
+		record.timestamp = node1[i];
+		sink.nodeQueues[0]->push(record);
+	}
+	EXPECT_EQ(7u, sink.Size());
+
+	std::vector<LogRecord> batch;
+	ASSERT_EQ(7u, sink.PopBatch(batch, 0, 16));
+	for (size_t i = 0; i < 7; i++)
+		EXPECT_EQ((long long) (i + 1) * 10, batch[i].timestamp);
+	EXPECT_EQ(0u, sink.Size());
+}
+
+/**
+ * Normal test.
+ * The records of a queue keep their order when their time stamps are equal to those of another queue.
+ */
+TEST_F(LoggerTest, Test_Numa_03_N)
+{
+	MemorySink sink;
+	sink.AllocateNodeQueue(1, NULL);
+
+	LogRecord record;
+	for (int i = 0; i < 8; i++) {
+		record.timestamp = 10 + i / 4 * 10;
+		record.text = "node0 " + std::to_string(i);
+		sink.queue.push(record);
+		record.text = "node1 " + std::to_string(i);
+		sink.nodeQueues[0]->push(record);
+	}
+
+	std::vector<LogRecord> batch;
+	ASSERT_EQ(16u, sink.PopBatch(batch, 0, 16));
+	for (size_t i = 0; i < 16; i++) {
+		std::string node = i % 8 < 4 ? "node0 " : "node1 ";
+		EXPECT_EQ(node + std::to_string(i / 8 * 4 + i % 4), batch[i].text);
+	}
+}
+
+/**
+ * Normal test.
+ * A batch waiting for its latency is filled from the queue of another node without waiting it out.
+ */
+TEST_F(LoggerTest, Test_Numa_04_N)
+{
+	MemorySink sink;
+	sink.AllocateNodeQueue(1, &worker.doorbell);
+	size_t batchSize = worker.batchSize;
+	unsigned int batchLatencyMs = worker.batchLatencyMs;
+	worker.batchSize = 4;
+	worker.batchLatencyMs = 2000;
+	// The batch only waits for its latency while the writer threads run
+	worker.StopWriters();
+	worker.StartWriters(1);
+
+	LogRecord record;
+	record.text = "Batched record 0";
+	sink.queue.push(record);
+	std::thread producer([&sink]() {
+		LogRecord record;
+		LoggerUtil::Sleep(50);
+		for (int i = 1; i < 4; i++) {
+			record.text = "Batched record " + std::to_string(i);
+			sink.nodeQueues[0]->push(record);
+		}
+	});
+
+	std::vector<LogRecord> batch;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	EXPECT_TRUE(worker.ServiceSink(sink, batch));
+	long long elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::steady_clock::now() - start).count();
+	producer.join();
+	worker.StopWriters();
+	worker.batchSize = batchSize;
+	worker.batchLatencyMs = batchLatencyMs;
+
+	EXPECT_EQ(4u, sink.GetLines().size());
+	EXPECT_LT(elapsedMs, 1000);
+}
@@ -55,6 +55,9 @@ int main(void)
 		// EVENT level
 		Logger::Event(L"Event: {application has started}");
 
+		// Type-safe interface, the placeholder/argument count is checked at compile time
+		Logger::Info(LOGGER_CODE_INFO_DEFAULT, CPPLOGGER_FMT("Type-safe logging ({}, {})"), 1, "two");
+
 		//syslog() examples
 		// INFO level
 		Logger::SysLogInfo(L"syslog() information level logging");
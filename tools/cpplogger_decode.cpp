@@ -0,0 +1,60 @@
+//////////////////////////////////////////////////////////////////////////////
+// @File Name:      cpplogger_decode.cpp                                    //
+// @Description:    Renders binary log files back to the text format        //
+//                                                                          //
+// Usage: cpplogger-decode [binary log file ...]                            //
+//        (reads the standard input when no file is given)                  //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <fstream>
+#include "../Logger.h"
+
+using namespace std;
+using namespace cpplogger;
+
+/**
+ * Writes the log lines of a binary log to the standard output.
+ *
+ * @param	in		The binary log stream.
+ * @param	name	The name of the input, for the error message.
+ *
+ * @return	true is returned if the whole input is decoded. Otherwise, false is returned.
+ */
+static bool Decode(istream& in, const char *name)
+{
+	BinaryLogReader reader;
+	string line;
+	while (reader.ReadLine(in, line)) {
+		cout.write(line.data(), line.size());
+		cout.put('\n');
+	}
+
+	if (reader.IsCorrupt()) {
+		cerr << "cpplogger-decode: " << name << ": not a binary log file or truncated" << endl;
+		return false;
+	}
+	return true;
+}
+
+int main(int argc, char *argv[])
+{
+	ios::sync_with_stdio(false);
+
+	if (argc < 2)
+		return Decode(cin, "(standard input)") ? 0 : 1;
+
+	int status = 0;
+	for (int i = 1; i < argc; i++) {
+		ifstream in(argv[i], ios::in | ios::binary);
+		if (!in) {
+			cerr << "cpplogger-decode: " << argv[i] << ": cannot open file" << endl;
+			status = 1;
+			continue;
+		}
+		if (!Decode(in, argv[i]))
+			status = 1;
+	}
+	return status;
+}
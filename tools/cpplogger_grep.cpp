@@ -0,0 +1,417 @@
+//////////////////////////////////////////////////////////////////////////////
+// @File Name:      cpplogger_grep.cpp                                      //
+// @Description:    Searches log files by message code, severity, time      //
+//                  and substring                                           //
+//                                                                          //
+// Usage: cpplogger-grep [options] <log file> [log file ...]                //
+//        -e PATTERN           lines containing the literal PATTERN         //
+//        --code CODE          lines with the message code (e.g. E800002)   //
+//        --level LEVEL[,...]  lines with the severity (INFO, WARN, ERR,    //
+//                             CRIT, DEBUG, EVENT)                          //
+//        --from TIME          lines at or after TIME                       //
+//        --to TIME            lines at or before TIME                      //
+//                             ('yyyy-MM-dd HH:mm:ss[.SSS]' or nanoseconds) //
+//        -j THREADS           number of search threads per file            //
+//        --count              print the number of matching lines only      //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <string>
+#include <climits>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+#include "../Logger.h"
+
+using namespace std;
+using namespace cpplogger;
+
+//! Files smaller than this are searched by a single thread
+#define MIN_CHUNK_SIZE		(1024 * 1024)
+
+//! Search filters
+struct Filter
+{
+	//! Literal substring (empty for any)
+	string pattern;
+	//! Message code (empty for any)
+	string code;
+	//! Severity tags, without the padding (empty for any)
+	vector<string> levels;
+	//! Time range (nanoseconds since epoch)
+	long long from;
+	long long to;
+	//! The needle the lines are located by (empty to visit every line)
+	string needle;
+};
+
+//! A matching line
+struct Match
+{
+	const char *begin;
+	const char *end;
+};
+
+//! Finds the first occurrence of a substring (NULL if none)
+typedef const char *(*FindFunc)(const char *src, size_t len, const char *needle, size_t needleLen);
+
+/**
+ * Finds the first occurrence of a substring.
+ *
+ * @param	src			The text.
+ * @param	len			The length of the text.
+ * @param	needle		The substring.
+ * @param	needleLen	The length of the substring.
+ *
+ * @return	Pointer to the first occurrence, or NULL if there is none.
+ */
+static const char *FindScalar(const char *src, size_t len, const char *needle, size_t needleLen)
+{
+	return (const char *) memmem(src, len, needle, needleLen);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+/**
+ * Finds the first occurrence of a substring, 32 positions at a time: the positions where both the first and the
+ * last character of the substring match are compared in full.
+ */
+__attribute__((target("avx2")))
+static const char *FindAvx2(const char *src, size_t len, const char *needle, size_t needleLen)
+{
+	if (needleLen == 0 || len < needleLen)
+		return needleLen == 0 ? src : NULL;
+
+	const __m256i first = _mm256_set1_epi8(needle[0]);
+	const __m256i last = _mm256_set1_epi8(needle[needleLen - 1]);
+	size_t i = 0;
+	for (; i + needleLen - 1 + 32 <= len; i += 32) {
+		__m256i blockFirst = _mm256_loadu_si256((const __m256i *) (src + i));
+		__m256i blockLast = _mm256_loadu_si256((const __m256i *) (src + i + needleLen - 1));
+		uint32_t mask = (uint32_t) _mm256_movemask_epi8(
+			_mm256_and_si256(_mm256_cmpeq_epi8(first, blockFirst), _mm256_cmpeq_epi8(last, blockLast)));
+		while (mask != 0) {
+			unsigned int bit = __builtin_ctz(mask);
+			if (memcmp(src + i + bit, needle, needleLen) == 0)
+				return src + i + bit;
+			mask &= mask - 1;
+		}
+	}
+	return FindScalar(src + i, len - i, needle, needleLen);
+}
+
+/**
+ * Finds the first occurrence of a substring, 16 positions at a time (see FindAvx2()).
+ */
+__attribute__((target("sse4.2")))
+static const char *FindSse(const char *src, size_t len, const char *needle, size_t needleLen)
+{
+	if (needleLen == 0 || len < needleLen)
+		return needleLen == 0 ? src : NULL;
+
+	const __m128i first = _mm_set1_epi8(needle[0]);
+	const __m128i last = _mm_set1_epi8(needle[needleLen - 1]);
+	size_t i = 0;
+	for (; i + needleLen - 1 + 16 <= len; i += 16) {
+		__m128i blockFirst = _mm_loadu_si128((const __m128i *) (src + i));
+		__m128i blockLast = _mm_loadu_si128((const __m128i *) (src + i + needleLen - 1));
+		uint32_t mask = (uint32_t) _mm_movemask_epi8(
+			_mm_and_si128(_mm_cmpeq_epi8(first, blockFirst), _mm_cmpeq_epi8(last, blockLast)));
+		while (mask != 0) {
+			unsigned int bit = __builtin_ctz(mask);
+			if (memcmp(src + i + bit, needle, needleLen) == 0)
+				return src + i + bit;
+			mask &= mask - 1;
+		}
+	}
+	return FindScalar(src + i, len - i, needle, needleLen);
+}
+#endif
+
+//! Selects the widest vector search the CPU supports
+static FindFunc SelectFind()
+{
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+		return FindAvx2;
+	if (__builtin_cpu_supports("sse4.2"))
+		return FindSse;
+#endif
+	return FindScalar;
+}
+
+static const FindFunc Find = SelectFind();
+
+/**
+ * Checks a line against the filters. The line layout is the one of Logger::WriteLog():
+ * 'time [TAG]: CODE, message', without the code for the debug and event tags.
+ *
+ * @param	filter	The filters.
+ * @param	line	The line.
+ * @param	len		The length of the line.
+ *
+ * @return	true is returned if the line matches. Otherwise, false is returned.
+ */
+static bool MatchLine(const Filter& filter, const char *line, size_t len)
+{
+	if (filter.levels.empty() && filter.code.empty() && filter.from <= 0 && filter.to == LLONG_MAX)
+		return true;
+
+	if (filter.from > 0 || filter.to != LLONG_MAX) {
+		long long timestamp = LogReader::ParseTimestamp(line, len);
+		if (timestamp < filter.from || timestamp > filter.to)
+			return false;
+	}
+
+	// The time stamp does not contain " [", the tag follows it
+	const char *end = line + len;
+	const char *tag = (const char *) memmem(line, len, " [", 2);
+	if (tag == NULL)
+		return false;
+	tag += 2;
+	const char *tagEnd = (const char *) memchr(tag, ']', end - tag);
+	if (tagEnd == NULL || end - tagEnd < 3 || tagEnd[1] != ':' || tagEnd[2] != ' ')
+		return false;
+
+	if (!filter.levels.empty()) {
+		size_t tagLen = tagEnd - tag;
+		while (tagLen > 0 && tag[tagLen - 1] == ' ')
+			tagLen--;
+		bool found = false;
+		for (size_t i = 0; i < filter.levels.size() && !found; i++)
+			found = filter.levels[i].size() == tagLen && memcmp(filter.levels[i].data(), tag, tagLen) == 0;
+		if (!found)
+			return false;
+	}
+
+	if (!filter.code.empty()) {
+		const char *code = tagEnd + 3;
+		size_t codeLen = filter.code.size();
+		if ((size_t) (end - code) <= codeLen || memcmp(code, filter.code.data(), codeLen) != 0 || code[codeLen] != ',')
+			return false;
+	}
+	return true;
+}
+
+/**
+ * Searches a part of a file, which starts at a line boundary and ends at one.
+ *
+ * @param	filter	The filters.
+ * @param	begin	The start of the part.
+ * @param	end		The end of the part.
+ * @param	matches	The matching lines are appended to matches.
+ */
+static void SearchChunk(const Filter& filter, const char *begin, const char *end, vector<Match>& matches)
+{
+	const char *pos = begin;
+	while (pos < end) {
+		const char *hit = pos;
+		if (!filter.needle.empty()) {
+			hit = Find(pos, end - pos, filter.needle.data(), filter.needle.size());
+			if (hit == NULL)
+				break;
+		}
+
+		const char *lineBegin = hit;
+		while (lineBegin > pos && lineBegin[-1] != '\n')
+			lineBegin--;
+		const char *lineEnd = (const char *) memchr(hit, '\n', end - hit);
+		if (lineEnd == NULL)
+			lineEnd = end;
+
+		// The NUL filled rest of the last extent of a memory-mapped file that is still written (or whose writer
+		// was killed), the file size covers whole extents until the file is closed
+		if (*lineBegin == '\0')
+			break;
+
+		if (MatchLine(filter, lineBegin, lineEnd - lineBegin)) {
+			Match match = { lineBegin, lineEnd };
+			matches.push_back(match);
+		}
+		pos = lineEnd + 1;
+	}
+}
+
+/**
+ * Searches a log file, split across threads on line boundaries. The time range is narrowed down through the time
+ * index of the file first.
+ *
+ * @param	filter	The filters.
+ * @param	path	The log file path.
+ * @param	threads	The number of threads.
+ * @param	prefix	Print the file path before the lines.
+ * @param	count	Print the number of matching lines only.
+ *
+ * @return	true is returned if the file is searched. Otherwise, false is returned.
+ */
+static bool SearchFile(const Filter& filter, const string& path, unsigned int threads, bool prefix, bool count)
+{
+	int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	struct stat st;
+	if (fd < 0 || fstat(fd, &st) != 0) {
+		if (fd >= 0)
+			close(fd);
+		return false;
+	}
+
+	size_t size = (size_t) st.st_size;
+	const char *data = NULL;
+	if (size > 0) {
+		void *addr = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (addr == MAP_FAILED) {
+			close(fd);
+			return false;
+		}
+		data = (const char *) addr;
+		madvise(addr, size, MADV_SEQUENTIAL);
+	}
+	close(fd);
+
+	size_t begin = 0, end = size;
+	if (filter.from > 0 || filter.to != LLONG_MAX) {
+		LogReader::FindRange(path, filter.from, filter.to, begin, end);
+		end = min(end, size);
+	}
+
+	// Split on line boundaries
+	size_t chunks = min((size_t) threads, max((size_t) 1, (end - begin) / MIN_CHUNK_SIZE));
+	vector<const char *> bounds(1, data + begin);
+	for (size_t i = 1; i < chunks; i++) {
+		const char *bound = data + begin + (end - begin) * i / chunks;
+		const char *newline = (const char *) memchr(bound, '\n', data + end - bound);
+		bound = newline != NULL ? newline + 1 : data + end;
+		bounds.push_back(max(bound, bounds.back()));
+	}
+	bounds.push_back(data + end);
+
+	vector<vector<Match> > matches(chunks);
+	vector<thread> workers;
+	for (size_t i = 1; i < chunks; i++)
+		workers.push_back(thread(SearchChunk, cref(filter), bounds[i], bounds[i + 1], ref(matches[i])));
+	SearchChunk(filter, bounds[0], bounds[1], matches[0]);
+	for (size_t i = 0; i < workers.size(); i++)
+		workers[i].join();
+
+	size_t total = 0;
+	for (size_t i = 0; i < chunks; i++) {
+		total += matches[i].size();
+		for (size_t j = 0; j < matches[i].size() && !count; j++) {
+			if (prefix)
+				cout << path << ':';
+			cout.write(matches[i][j].begin, matches[i][j].end - matches[i][j].begin);
+			cout.put('\n');
+		}
+	}
+	if (count) {
+		if (prefix)
+			cout << path << ':';
+		cout << total << '\n';
+	}
+
+	if (size > 0)
+		munmap((void *) data, size);
+	return true;
+}
+
+/**
+ * Parses a time argument. A time without milliseconds covers the whole second.
+ *
+ * @param	arg		The argument.
+ * @param	isEnd	The argument is the end of the time range.
+ *
+ * @return	The time stamp in nanoseconds since epoch, or -1 if the argument is not a time stamp.
+ */
+static long long ParseTime(string arg, bool isEnd)
+{
+	bool utc = !arg.empty() && arg[arg.size() - 1] == 'Z';
+	if (utc)
+		arg.erase(arg.size() - 1);
+	if (arg.size() == 19)
+		arg += isEnd ? ".999" : ".000";
+	if (utc)
+		arg += 'Z';
+
+	long long timestamp = LogReader::ParseTimestamp(arg.data(), arg.size());
+	if (timestamp >= 0 && isEnd && arg.size() >= 23)
+		timestamp += 999999;
+	return timestamp;
+}
+
+static int Usage()
+{
+	cerr << "usage: cpplogger-grep [-e PATTERN] [--code CODE] [--level LEVEL[,LEVEL...]] [--from TIME] [--to TIME]"
+		" [-j THREADS] [--count] <log file> [log file ...]" << endl;
+	return 2;
+}
+
+int main(int argc, char *argv[])
+{
+	Filter filter;
+	filter.from = 0;
+	filter.to = LLONG_MAX;
+	unsigned int threads = max(1u, thread::hardware_concurrency());
+	bool count = false;
+	vector<string> files;
+
+	for (int i = 1; i < argc; i++) {
+		string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (arg == "-e" && hasValue) {
+			filter.pattern = argv[++i];
+		} else if (arg == "--code" && hasValue) {
+			filter.code = argv[++i];
+		} else if (arg == "--level" && hasValue) {
+			string levels = argv[++i];
+			for (size_t pos = 0; pos <= levels.size();) {
+				size_t comma = levels.find(',', pos);
+				if (comma == string::npos)
+					comma = levels.size();
+				filter.levels.push_back(levels.substr(pos, comma - pos));
+				pos = comma + 1;
+			}
+		} else if ((arg == "--from" || arg == "--to") && hasValue) {
+			long long timestamp = ParseTime(argv[++i], arg == "--to");
+			if (timestamp < 0) {
+				cerr << "cpplogger-grep: invalid time, use 'yyyy-MM-dd HH:mm:ss[.SSS]' or nanoseconds" << endl;
+				return 2;
+			}
+			(arg == "--from" ? filter.from : filter.to) = timestamp;
+		} else if (arg == "-j" && hasValue) {
+			threads = max(1, atoi(argv[++i]));
+		} else if (arg == "--count") {
+			count = true;
+		} else if (!arg.empty() && arg[0] == '-') {
+			return Usage();
+		} else {
+			files.push_back(arg);
+		}
+	}
+	if (files.empty() || filter.pattern.find('\n') != string::npos)
+		return Usage();
+
+	// Locate the lines by the most selective literal, the other filters are checked on the line
+	if (!filter.pattern.empty())
+		filter.needle = filter.pattern;
+	else if (!filter.code.empty())
+		filter.needle = "]: " + filter.code + ",";
+	else if (filter.levels.size() == 1)
+		filter.needle = " [" + filter.levels[0];
+
+	ios::sync_with_stdio(false);
+	int status = 0;
+	for (size_t i = 0; i < files.size(); i++) {
+		if (!SearchFile(filter, files[i], threads, files.size() > 1, count)) {
+			cerr << "cpplogger-grep: " << files[i] << ": cannot open file" << endl;
+			status = 2;
+		}
+	}
+	return status;
+}
@@ -0,0 +1,81 @@
+//////////////////////////////////////////////////////////////////////////////
+// @File Name:      cpplogger_range.cpp                                     //
+// @Description:    Prints the lines of a time range from log files         //
+//                                                                          //
+// Usage: cpplogger-range <from> <to> <log file> [log file ...]             //
+//        from/to: 'yyyy-MM-dd HH:mm:ss[.SSS]' (local time, 'Z' for UTC)    //
+//                 or nanoseconds since epoch                               //
+//                                                                          //
+//////////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include "../Logger.h"
+
+using namespace std;
+using namespace cpplogger;
+
+/**
+ * Parses a time range argument. A time without milliseconds covers the whole second.
+ *
+ * @param	arg		The argument.
+ * @param	isEnd	The argument is the end of the time range.
+ *
+ * @return	The time stamp in nanoseconds since epoch, or -1 if the argument is not a time stamp.
+ */
+static long long ParseTime(string arg, bool isEnd)
+{
+	bool utc = !arg.empty() && arg[arg.size() - 1] == 'Z';
+	if (utc)
+		arg.erase(arg.size() - 1);
+	if (arg.size() == 19)
+		arg += isEnd ? ".999" : ".000";
+	if (utc)
+		arg += 'Z';
+
+	long long timestamp = LogReader::ParseTimestamp(arg.data(), arg.size());
+	// Include the nanoseconds of the last millisecond
+	if (timestamp >= 0 && isEnd && arg.size() >= 23)
+		timestamp += 999999;
+	return timestamp;
+}
+
+//! Orders log lines by time stamp
+static bool OlderThan(const LogLine& lhs, const LogLine& rhs)
+{
+	return lhs.timestamp < rhs.timestamp;
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc < 4) {
+		cerr << "usage: cpplogger-range <from> <to> <log file> [log file ...]" << endl;
+		return 2;
+	}
+
+	long long from = ParseTime(argv[1], false);
+	long long to = ParseTime(argv[2], true);
+	if (from < 0 || to < 0) {
+		cerr << "cpplogger-range: invalid time, use 'yyyy-MM-dd HH:mm:ss[.SSS]' or nanoseconds since epoch" << endl;
+		return 2;
+	}
+
+	// Lines of the application, debug and event logs are merged in time order
+	int status = 0;
+	vector<LogLine> lines;
+	for (int i = 3; i < argc; i++) {
+		if (!LogReader::ReadRange(argv[i], from, to, lines)) {
+			cerr << "cpplogger-range: " << argv[i] << ": cannot open file" << endl;
+			status = 1;
+		}
+	}
+	stable_sort(lines.begin(), lines.end(), OlderThan);
+
+	ios::sync_with_stdio(false);
+	for (size_t i = 0; i < lines.size(); i++) {
+		cout.write(lines[i].text.data(), lines[i].text.size());
+		cout.put('\n');
+	}
+	return status;
+}